@@ -0,0 +1,45 @@
+#ifndef AHNENTAFELPEDIGREE_H
+#define AHNENTAFELPEDIGREE_H
+
+#include "DexDBWrapper.h"
+#include <map>
+#include <vector>
+
+using namespace std;
+
+// Ancestors of a member addressed by Ahnentafel number: the root is 1,
+// the father of n is 2n and the mother 2n + 1, so generation g (the root
+// being generation 1) fills numbers 2^(g-1) to 2^g - 1.
+//
+// fetch() goes up one generation per DEX query: the parent edges of the
+// whole generation come from a single Explode over an Objects set. Only
+// the edge lookup is batched. DEX reads attributes and edge ends one
+// object at a time (GetAttribute and GetEdgeData take a single oid, there
+// is no call over an Objects set), so every edge of the generation costs
+// a GetEdgeData and every ancestor a readMember. Those are lookups in the
+// embedded image, not queries; an ancestor reached through several lines
+// (pedigree collapse) is still read once. A parent of unknown sex takes
+// the first free of the two numbers, parents past the second are left
+// out.
+class AhnentafelPedigree
+{
+public:
+    AhnentafelPedigree(DexDBWrapper &db);
+
+    static const int MaxGenerations;
+
+    int fetch(MemberClass root, int generations, vector<MemberClass> &pedigree);
+    const vector<dex::gdb::oid_t> & getOids();
+    int getRoundTrips();
+
+private:
+    typedef map<dex::gdb::oid_t, vector<int> > Slots;
+
+    DexDBWrapper &db;
+    vector<dex::gdb::oid_t> oids;
+    int roundTrips;
+
+    void place(int slot, dex::gdb::oid_t parent, vector<MemberClass> &pedigree, map<dex::gdb::oid_t, MemberClass> &read, Slots &next);
+};
+
+#endif // AHNENTAFELPEDIGREE_H
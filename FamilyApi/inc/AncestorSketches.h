@@ -0,0 +1,68 @@
+#ifndef ANCESTORSKETCHES_H
+#define ANCESTORSKETCHES_H
+
+#include "DexDBWrapper.h"
+#include <vector>
+
+using namespace std;
+
+// Distinct ancestor counts for every member without enumerating paths.
+//
+// Each member keeps a HyperLogLog sketch of its ancestor set: 2^precision
+// one byte registers, relative error about 1.04 / sqrt(2^precision). The
+// sketches are filled in one pass in generation order, a child's sketch
+// being the register-wise maximum of its parents' sketches plus the
+// parents themselves. setExact(true) keeps sorted ancestor lists instead,
+// exact but O(members x ancestors) memory, meant for checking the error
+// on smaller trees.
+//
+// Alongside, ancestor paths are counted (every way up through the
+// parents, the size the pedigree would have without collapse), so
+// collapseRatio() = 1 - distinct / paths: 0 for a pedigree without
+// repeated ancestors.
+//
+// A new parent edge is merged into the child and down its descendants,
+// stopping where nothing changes. Deletes cannot be taken out of a
+// sketch, they rebuild on the next query.
+class AncestorSketches : public DexDBWrapperListener
+{
+public:
+    AncestorSketches(DexDBWrapper &db);
+    ~AncestorSketches();
+
+    void setPrecision(int precision);
+    void setExact(bool exact);
+    int build();
+
+    int countAncestors(MemberClass member, double &count);
+    int collapseRatio(MemberClass member, double &ratio);
+
+    void memberAdded(dex::gdb::oid_t member, MemberClass &data);
+    void memberDeleted(dex::gdb::oid_t member);
+    void relationAdded(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head);
+    void relationDeleted(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head);
+    void reset();
+
+private:
+    DexDBWrapper &db;
+    int precision;
+    int registers;
+    bool exact;
+    bool built;
+    bool pathsDirty;
+
+    vector<unsigned char> sketches;
+    vector< vector<int> > ancestors;
+    vector<double> paths;
+
+    int nodeOf(MemberClass &member);
+    int generationOrder(vector<int> &nodes);
+    void countPaths();
+    void grow();
+    bool insert(int node, int ancestor);
+    bool merge(int node, int parent);
+    double estimate(int node);
+    static unsigned long long hash(dex::gdb::oid_t oid);
+};
+
+#endif // ANCESTORSKETCHES_H
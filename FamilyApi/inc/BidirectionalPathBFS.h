@@ -0,0 +1,61 @@
+#ifndef BIDIRECTIONALPATHBFS_H
+#define BIDIRECTIONALPATHBFS_H
+
+#include "dex/gdb/Graph.h"
+#include "dex/gdb/Session.h"
+#include "dex/gdb/Objects.h"
+#include <vector>
+
+using namespace std;
+
+// Unweighted shortest path between two nodes, searched from both ends.
+// It takes the controls of dex::algorithms::SinglePairShortestPathBFS
+// (AddEdgeType, AddAllEdgeTypes, AddNodeType, SetMaximumHops, Run,
+// Exists, GetCost) so it can stand in for it.
+//
+// Every step expands a whole level of the side whose frontier is smaller
+// with one Graph::Neighbors call per edge type on the frontier's Objects
+// set; the search ends at the first level that touches the other side.
+// On wide family graphs the two searches meet after about half the hops
+// each, far fewer nodes than one search from the source. The levels are
+// kept so the path can be traced back from the meeting node.
+class BidirectionalPathBFS
+{
+public:
+    BidirectionalPathBFS(dex::gdb::Session &session, dex::gdb::oid_t source, dex::gdb::oid_t destination);
+    ~BidirectionalPathBFS();
+
+    void AddEdgeType(dex::gdb::type_t type, dex::gdb::EdgesDirection direction);
+    void AddAllEdgeTypes(dex::gdb::EdgesDirection direction);
+    void AddNodeType(dex::gdb::type_t type);
+    void SetMaximumHops(int hops);
+
+    void Run();
+    bool Exists();
+    double GetCost();
+    const vector<dex::gdb::oid_t> & GetPathAsNodes();
+    dex::gdb::int64_t GetVisited();
+
+private:
+    dex::gdb::Session &session;
+    dex::gdb::Graph *graph;
+    dex::gdb::oid_t source;
+    dex::gdb::oid_t destination;
+    int maxHops;
+
+    vector<dex::gdb::type_t> edgeTypes;
+    vector<dex::gdb::EdgesDirection> directions;
+    vector<dex::gdb::type_t> nodeTypes;
+
+    bool found;
+    vector<dex::gdb::oid_t> path;
+    dex::gdb::int64_t visited;
+
+    dex::gdb::Objects * expand(dex::gdb::Objects *frontier, bool forward, dex::gdb::Objects *seen, dex::gdb::Objects *allowed);
+    dex::gdb::oid_t stepBack(dex::gdb::oid_t node, bool forward, dex::gdb::Objects *level);
+    void trace(dex::gdb::oid_t meeting, vector<dex::gdb::Objects *> &sourceLevels, vector<dex::gdb::Objects *> &destinationLevels);
+    static dex::gdb::EdgesDirection reverse(dex::gdb::EdgesDirection direction);
+    static void release(vector<dex::gdb::Objects *> &levels);
+};
+
+#endif // BIDIRECTIONALPATHBFS_H
@@ -0,0 +1,90 @@
+#ifndef BUFFEREDROWWRITER_H
+#define BUFFEREDROWWRITER_H
+
+#include "dex/io/RowWriter.h"
+#include <cstdio>
+#include <string>
+
+using namespace std;
+
+enum RowFormat{
+    csvFormat=0,
+    binaryFormat
+};
+
+enum FieldTag{
+    nullField=0,
+    stringField,
+    integerField,
+    timestampField
+};
+
+// RowWriter which encodes UTF-8 straight into one large page aligned buffer
+// and hands it to the OS in whole blocks. Besides the StringList interface
+// used by dex::io::TypeExporter it has typed add* calls, so numbers and
+// dates are formatted by hand instead of going through wide streams and the
+// C locale.
+//
+// binaryFormat rows are: varint field count, then per field a FieldTag byte
+// followed by a varint byte length and UTF-8 bytes (stringField) or a
+// zigzag varint (integerField, timestampField in milliseconds).
+//
+// Rows may only be written between a successful open() and Close(); any
+// other write throws dex::gdb::IOException.
+class BufferedRowWriter : public dex::io::RowWriter
+{
+public:
+    BufferedRowWriter();
+    virtual ~BufferedRowWriter();
+
+    static const size_t DefaultBufferSize = 4 << 20;
+    static const size_t BufferAlignment = 4096;
+
+    void setFormat(RowFormat format);
+    void setSeparator(char separator);
+    void setBufferSize(size_t size);
+
+    int open(string path);
+
+    void beginRow(int fields);
+    void addNull();
+    void addString(const wstring &text);
+    void addUtf8(const char *text, size_t length);
+    void addInteger(dex::gdb::int64_t value);
+    void addDate(dex::gdb::int64_t timestamp);
+    void endRow();
+
+    void Write(dex::gdb::StringList &row)
+    throw(dex::gdb::IOException, dex::gdb::Error);
+    void Close()
+    throw(dex::gdb::IOException, dex::gdb::Error);
+
+    dex::gdb::int64_t getWritten();
+
+private:
+    FILE * file;
+    RowFormat format;
+    char separator;
+    size_t bufferSize;
+    char * memory;
+    char * buffer;
+    size_t used;
+    int field;
+    dex::gdb::int64_t written;
+    string encoded;
+
+    BufferedRowWriter(const BufferedRowWriter &writer);
+    BufferedRowWriter & operator =(const BufferedRowWriter &writer);
+
+    void requireOpen();
+    void flush();
+    void reserve(size_t bytes);
+    void put(char c);
+    void put(const char *text, size_t length);
+    void putVarint(unsigned long long value);
+    void putDecimal(dex::gdb::int64_t value, int width);
+    void beginField(FieldTag tag);
+    void putQuoted(const char *text, size_t length);
+};
+
+#endif // BUFFEREDROWWRITER_H
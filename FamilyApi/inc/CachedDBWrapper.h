@@ -0,0 +1,137 @@
+#ifndef CACHEDDBWRAPPER_H
+#define CACHEDDBWRAPPER_H
+
+#include "DexDBWrapper.h"
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct CacheStats{
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long stale;
+    unsigned long long evictions;
+    size_t entries;
+    size_t bytes;
+};
+
+// A DBWrapper in front of DexDBWrapper that remembers the answers of the
+// read queries profile pages keep repeating (findByName, findChildren,
+// the sibling queries, findRealation and the closure queries).
+//
+// Every entry records the epochs of what it was computed from: the
+// member, its parents for the sibling queries, the name for findByName,
+// and for the answers that can change anywhere in a family (paths,
+// ancestry, family size, step relatives) the family of each member as
+// named by FamilyComponents::familyOf. Writes bump only the epochs they
+// touch: a relation bumps the members at both ends and their families, a
+// deleted member its neighbours and its family. An entry whose families
+// still have the same roots and whose epochs all still match is served,
+// the others are dropped when next looked up. Failed queries (-1) are
+// never kept.
+//
+// The epochs live in a fixed array of Stripes counters indexed by a hash
+// of the key, so they take the same memory however many members and names
+// are seen; keys sharing a stripe only make each other's entries stale
+// early. The entries are kept in one least recently used list. The
+// wrapper is single threaded like DexDBWrapper.
+class CachedDBWrapper : public DBWrapper, public DexDBWrapperListener
+{
+public:
+    CachedDBWrapper(DexDBWrapper &db, size_t capacity);
+    ~CachedDBWrapper();
+
+    static const int Stripes;
+
+    int Connect(DBConnectionInf infClass);
+    int Initiate();
+
+    int addMember(MemberClass member);
+    int delMember(MemberClass member);
+
+    int addRelation(string relation);
+    int delRelation(string relation);
+    int addRelationTo(string relation, MemberClass member_1, MemberClass member_2);
+    int delRelationTo(string relation, MemberClass member_1, MemberClass member_2);
+
+    int findMember(MemberClass member);
+    int findByName(MemberClass member);
+    int findChildren(MemberClass member);
+    int findRealation(MemberClass member_1, MemberClass member_2);
+    int findSiblings(MemberClass member);
+    int findHalfSiblings(MemberClass member);
+    int findStepRelatives(MemberClass member);
+
+    int isAncestor(MemberClass ancestor, MemberClass member);
+    int isSameFamily(MemberClass member_1, MemberClass member_2);
+    int findFamilySize(MemberClass member);
+
+    void getStats(CacheStats &stats);
+    void clear();
+
+    void memberAdded(dex::gdb::oid_t member, MemberClass &data);
+    void memberDeleted(dex::gdb::oid_t member);
+    void relationAdded(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head);
+    void relationDeleted(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head);
+    void reset();
+
+private:
+    enum Query{
+        ByName,
+        Children,
+        Realation,
+        Siblings,
+        HalfSiblings,
+        StepRelatives,
+        Ancestor,
+        SameFamily,
+        FamilySize
+    };
+    // member is set for a family epoch, key is then the family's root
+    struct Epoch{
+        dex::gdb::oid_t member;
+        dex::gdb::int64_t key;
+        unsigned int epoch;
+    };
+    struct Entry{
+        string key;
+        int result;
+        vector<Epoch> depends;
+    };
+
+    // epoch keys besides member and root oids: the roster (any new member,
+    // a stored partnerId may start to resolve), then the names
+    static const dex::gdb::int64_t Roster;
+
+    DexDBWrapper &db;
+    size_t capacity;
+    list<Entry> entries;
+    map<string, list<Entry>::iterator> index;
+    size_t bytes;
+    vector<unsigned int> epochs;
+    vector<dex::gdb::int64_t> deleting;
+    CacheStats stats;
+
+    int cached(Query query, MemberClass &member_1, MemberClass *member_2);
+    int run(Query query, MemberClass &member_1, MemberClass *member_2);
+    bool dependencies(Query query, MemberClass &member_1, MemberClass *member_2, vector<Epoch> &depends);
+    bool addMemberDependency(MemberClass &member, bool parents, vector<Epoch> &depends);
+    bool addFamilyDependency(dex::gdb::oid_t member, vector<Epoch> &depends);
+    bool addPartnerDependencies(MemberClass &member, vector<Epoch> &depends);
+    bool isFresh(const Epoch &epoch);
+    Epoch epochOf(dex::gdb::int64_t key);
+    unsigned int & stripe(dex::gdb::int64_t key);
+    void bump(dex::gdb::int64_t key);
+    void bumpFamily(dex::gdb::oid_t member);
+    void store(Entry &entry);
+    void drop(list<Entry>::iterator entry);
+    static string keyOf(Query query, MemberClass &member_1, MemberClass *member_2);
+    static dex::gdb::int64_t nameKey(const string &name);
+    static unsigned long long hash(const string &text);
+    static size_t sizeOf(const Entry &entry);
+};
+
+#endif // CACHEDDBWRAPPER_H
@@ -0,0 +1,70 @@
+#ifndef CONTOURLAYOUT_H
+#define CONTOURLAYOUT_H
+
+#include <vector>
+
+using namespace std;
+
+// The same tidy drawing as TreeLayout, but kept up to date under edits.
+//
+// Every node keeps the left and right contour of its subtree (the outer
+// edges of the boxes on each level, relative to the node) and the offset
+// of each child from it. Placing a node only needs its children's
+// contours: siblings are pushed apart level by level and the push is
+// spread over the smaller siblings in between, as Walker's algorithm does.
+// An edit marks the changed node and its ancestors, update() places those
+// again, deepest first, and everything below a clean subtree root moves
+// with it by its offset. The cost of an edit follows the depth of the
+// tree and the height of the subtrees along the path, not the tree size.
+//
+// Contours take memory in proportion to the height of each subtree, this
+// is meant for charts of tens of generations, not for long chains.
+class ContourLayout
+{
+public:
+    ContourLayout();
+
+    void setGap(double gap);
+
+    void build(const vector<int> &parent, const vector<double> &width);
+    int addNode(int parent, int index, double width);
+    void removeSubtree(int node);
+    void setWidth(int node, double width);
+    void update();
+
+    int size();
+    bool isAlive(int node);
+    int getParent(int node);
+    const vector<int> & getChildren(int node);
+    int getDepth(int node);
+    double getOffset(int node);
+    double getX(int node);
+    const vector<int> & getMoved();
+
+private:
+    double gap;
+
+    vector<int> parent;
+    vector< vector<int> > children;
+    vector<int> depth;
+    vector<double> width;
+    vector<double> offset;
+    vector<bool> alive;
+    vector<char> dirty;
+    vector< vector<double> > left;
+    vector< vector<double> > right;
+
+    vector<int> pending;
+    vector<int> moved;
+
+    vector<double> position;
+    vector<double> shift;
+    vector<double> change;
+    vector<double> forest;
+    vector<int> owner;
+
+    void place(int node);
+    void markDirty(int node);
+};
+
+#endif // CONTOURLAYOUT_H
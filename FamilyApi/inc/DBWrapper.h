@@ -9,6 +9,8 @@
 class DBWrapper{
 
 public:
+    virtual ~DBWrapper(){}
+
     virtual int Connect(DBConnectionInf infClass)=0;
     virtual int Initiate()=0;
 
@@ -24,6 +26,13 @@ public:
     virtual int findByName(MemberClass member)=0;
     virtual int findChildren(MemberClass member)=0;
     virtual int findRealation(MemberClass member_1, MemberClass member_2)=0;
+    virtual int findSiblings(MemberClass member)=0;
+    virtual int findHalfSiblings(MemberClass member)=0;
+    virtual int findStepRelatives(MemberClass member)=0;
+
+    virtual int isAncestor(MemberClass ancestor, MemberClass member)=0;
+    virtual int isSameFamily(MemberClass member_1, MemberClass member_2)=0;
+    virtual int findFamilySize(MemberClass member)=0;
 
 };
 
@@ -2,11 +2,27 @@
 #define DEXDBWRAPPER_H
 
 #include "DBWrapper.h"
+#include "DexSchema.h"
+#include "DexDBWrapperListener.h"
+#include "ParentDag.h"
+#include "MemberFilter.h"
+#include "MemberOidMap.h"
+#include "ReachabilityIndex.h"
+#include "TopologicalOrder.h"
+#include "FamilyComponents.h"
+#include "KinshipCoefficients.h"
+#include "MemberCursor.h"
+#include "MemberVisitor.h"
+#include "dex/gdb/Dex.h"
+#include "dex/gdb/Database.h"
+#include "dex/gdb/Session.h"
+#include "dex/gdb/Graph.h"
 
 class DexDBWrapper : public DBWrapper
 {
 public:
     DexDBWrapper();
+    ~DexDBWrapper();
 
 public:
     int Connect(DBConnectionInf infClass);
@@ -24,6 +40,111 @@ public:
     int findByName(MemberClass member);
     int findChildren(MemberClass member);
     int findRealation(MemberClass member_1, MemberClass member_2);
+    int findSiblings(MemberClass member);
+    int findSiblings(MemberClass member, vector<MemberClass> &siblings);
+    int findHalfSiblings(MemberClass member);
+    int findHalfSiblings(MemberClass member, vector<MemberClass> &siblings);
+    int findStepRelatives(MemberClass member);
+    int findStepRelatives(MemberClass member, vector<MemberClass> &relatives);
+
+    int openChildren(MemberClass member, MemberCursor &cursor);
+    int openByName(MemberClass member, MemberCursor &cursor);
+    int openSiblings(MemberClass member, MemberCursor &cursor);
+    int openHalfSiblings(MemberClass member, MemberCursor &cursor);
+    int openStepRelatives(MemberClass member, MemberCursor &cursor);
+
+    int visitMembers(MemberVisitor &visitor);
+    int visitChildren(MemberClass member, MemberVisitor &visitor);
+    int visitByName(MemberClass member, MemberVisitor &visitor);
+    int visitDescendants(MemberClass member, MemberVisitor &visitor);
+    int visitAncestors(MemberClass member, MemberVisitor &visitor);
+
+    template <class Functor> int forEachMember(Functor &functor){
+        FunctorVisitor<Functor> visitor(functor);
+        return visitMembers(visitor);
+    }
+    template <class Functor> int forEachChild(MemberClass member, Functor &functor){
+        FunctorVisitor<Functor> visitor(functor);
+        return visitChildren(member, visitor);
+    }
+    template <class Functor> int forEachByName(MemberClass member, Functor &functor){
+        FunctorVisitor<Functor> visitor(functor);
+        return visitByName(member, visitor);
+    }
+    template <class Functor> int forEachDescendant(MemberClass member, Functor &functor){
+        FunctorVisitor<Functor> visitor(functor);
+        return visitDescendants(member, visitor);
+    }
+    template <class Functor> int forEachAncestor(MemberClass member, Functor &functor){
+        FunctorVisitor<Functor> visitor(functor);
+        return visitAncestors(member, visitor);
+    }
+
+    int isAncestor(MemberClass ancestor, MemberClass member);
+    int isSameFamily(MemberClass member_1, MemberClass member_2);
+    int findFamilySize(MemberClass member);
+    int findKinship(MemberClass member_1, MemberClass member_2, double &coefficient);
+    int findInbreeding(MemberClass member, double &coefficient);
+
+    dex::gdb::Session * getSession();
+    dex::gdb::Graph * getGraph();
+    DexSchema & getSchema();
+    ParentDag & getParentDag();
+    MemberFilter & getMemberIds();
+    ReachabilityIndex & getAncestry();
+    TopologicalOrder & getOrder();
+    FamilyComponents & getFamilyComponents();
+    KinshipCoefficients & getKinship();
+    // the oid of a member id, InvalidOID if there is no such member; the
+    // id map, then the id filter, then the index (may throw like DEX)
+    dex::gdb::oid_t oidOf(unsigned int id);
+    // the partnerId a member was stored with, 0 if none (may throw like DEX)
+    unsigned int partnerIdOf(dex::gdb::oid_t member);
+    // members with the name (and the surname, if set), owned by the caller
+    dex::gdb::Objects * selectByName(MemberClass &member);
+
+    void registerListener(DexDBWrapperListener &listener);
+    void unregisterListener(DexDBWrapperListener &listener);
+    void resetIndexes();
+
+private:
+    dex::gdb::Dex * dex;
+    dex::gdb::Database * db;
+    dex::gdb::Session * sess;
+    dex::gdb::Graph * graph;
+    DexSchema schema;
+    ParentDag dag;
+    MemberFilter memberIds;
+    MemberOidMap memberOids;
+    ReachabilityIndex ancestry;
+    TopologicalOrder order;
+    FamilyComponents families;
+    KinshipCoefficients kinship;
+    vector<DexDBWrapperListener *> listeners;
+
+    enum Kin{
+        Siblings,
+        HalfSiblings,
+        StepRelatives
+    };
+
+    void disconnect();
+    dex::gdb::oid_t memberOid(MemberClass &member);
+    int findKin(MemberClass &member, Kin kin, vector<MemberClass> *members);
+    int openKin(MemberClass &member, Kin kin, MemberCursor &cursor);
+    dex::gdb::Objects * kinOf(dex::gdb::oid_t oid, Kin kin);
+    int visitSet(dex::gdb::Objects *members, MemberVisitor &visitor);
+    int visitLine(MemberClass &member, bool down, MemberVisitor &visitor);
+    dex::gdb::Objects * fullSiblingsOf(dex::gdb::Objects *parents);
+    dex::gdb::Objects * halfSiblingsOf(dex::gdb::Objects *parents);
+    dex::gdb::Objects * stepRelativesOf(dex::gdb::oid_t oid, dex::gdb::Objects *parents);
+    dex::gdb::Objects * partnersOf(dex::gdb::Objects *members);
+
+    void memberAdded(dex::gdb::oid_t oid, MemberClass &member);
+    void memberDeleting(dex::gdb::oid_t oid);
+    void memberDeleted(dex::gdb::oid_t oid);
+    void relationAdded(dex::gdb::type_t type, dex::gdb::oid_t tail, dex::gdb::oid_t head);
+    void relationDeleted(dex::gdb::type_t type, dex::gdb::oid_t tail, dex::gdb::oid_t head);
 };
 
 #endif // DEXDBWRAPPER_H
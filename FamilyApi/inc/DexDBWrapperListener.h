@@ -0,0 +1,26 @@
+#ifndef DEXDBWRAPPERLISTENER_H
+#define DEXDBWRAPPERLISTENER_H
+
+#include "MemberClass.h"
+#include "dex/gdb/common.h"
+
+// In-memory indexes kept next to the DEX image register themselves here to
+// follow the writes DexDBWrapper makes. Every notification is sent after
+// the graph (and the wrapper's ParentDag) has already been changed, except
+// memberDeleting(), sent while the member and its edges are still there.
+// reset() means the graph was changed behind the wrapper's back, e.g. by a
+// bulk import, and whatever was derived from it has to be rebuilt.
+class DexDBWrapperListener
+{
+public:
+    virtual ~DexDBWrapperListener(){}
+
+    virtual void memberAdded(dex::gdb::oid_t member, MemberClass &data){}
+    virtual void memberDeleting(dex::gdb::oid_t member){}
+    virtual void memberDeleted(dex::gdb::oid_t member){}
+    virtual void relationAdded(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head){}
+    virtual void relationDeleted(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head){}
+    virtual void reset(){}
+};
+
+#endif // DEXDBWRAPPERLISTENER_H
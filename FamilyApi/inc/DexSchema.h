@@ -0,0 +1,67 @@
+#ifndef DEXSCHEMA_H
+#define DEXSCHEMA_H
+
+#include "MemberClass.h"
+#include "dex/gdb/Graph.h"
+#include "dex/gdb/Value.h"
+#include <string>
+
+using namespace std;
+
+// Node type, attributes and edge types the family tree is stored with,
+// plus the mapping between MemberClass and a DEX member node.
+class DexSchema
+{
+public:
+    DexSchema();
+
+    static const wstring MemberTypeName;
+    static const wstring ParentRelationName;
+    static const wstring PartnerRelationName;
+
+    int load(dex::gdb::Graph *graph);
+    int create(dex::gdb::Graph *graph);
+
+    dex::gdb::type_t getMemberType();
+    dex::gdb::type_t getParentType();
+    dex::gdb::type_t getPartnerType();
+
+    dex::gdb::attr_t getIdAttr();
+    dex::gdb::attr_t getNameAttr();
+    dex::gdb::attr_t getSurnameAttr();
+    dex::gdb::attr_t getSexAttr();
+    dex::gdb::attr_t getBirthAttr();
+    dex::gdb::attr_t getHeavenAttr();
+    dex::gdb::attr_t getPartnerIdAttr();
+
+    dex::gdb::type_t findRelation(dex::gdb::Graph *graph, const wstring &relation);
+    dex::gdb::type_t createRelation(dex::gdb::Graph *graph, const wstring &relation);
+
+    dex::gdb::oid_t findMember(dex::gdb::Graph *graph, unsigned int id);
+    void writeMember(dex::gdb::Graph *graph, dex::gdb::oid_t oid, MemberClass &member);
+    void readMember(dex::gdb::Graph *graph, dex::gdb::oid_t oid, MemberClass &member);
+
+    static void toTimestamp(DateClass &date, dex::gdb::Value &value);
+    static void toDate(const dex::gdb::Value &value, DateClass &date);
+    static int yearOf(dex::gdb::int64_t timestamp);
+    static dex::gdb::int64_t timestampOf(int year, int month, int day);
+    static void dateOf(dex::gdb::int64_t timestamp, int &year, int &month, int &day);
+
+private:
+    dex::gdb::type_t memberType;
+    dex::gdb::type_t parentType;
+    dex::gdb::type_t partnerType;
+
+    dex::gdb::attr_t idAttr;
+    dex::gdb::attr_t nameAttr;
+    dex::gdb::attr_t surnameAttr;
+    dex::gdb::attr_t sexAttr;
+    dex::gdb::attr_t birthAttr;
+    dex::gdb::attr_t heavenAttr;
+    dex::gdb::attr_t partnerIdAttr;
+
+    static dex::gdb::int64_t daysFromCivil(int year, int month, int day);
+    static void civilFromDays(dex::gdb::int64_t days, int &year, int &month, int &day);
+};
+
+#endif // DEXSCHEMA_H
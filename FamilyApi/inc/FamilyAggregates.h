@@ -0,0 +1,81 @@
+#ifndef FAMILYAGGREGATES_H
+#define FAMILYAGGREGATES_H
+
+#include "DexDBWrapper.h"
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Dashboard counters kept up to date from the wrapper's notifications:
+// members per surname, per birth decade and per generation, and the
+// average lifespan per generation. Reading one is a lookup.
+//
+// A member's generation is its depth below the oldest known ancestors,
+// the longest parent chain above it. A new parent edge can only push the
+// child and its descendants down, the move is carried as far as it goes.
+// A removed parent edge can lift them again, they are recomputed from
+// their remaining parents the same way. A deleted member's children are
+// noted while its edges are still there and lifted like that afterwards.
+class FamilyAggregates : public DexDBWrapperListener
+{
+public:
+    FamilyAggregates(DexDBWrapper &db);
+    ~FamilyAggregates();
+
+    int build();
+
+    int countSurname(string surname);
+    int countDecade(int decade);
+    int countGeneration(int generation);
+    int generations();
+    int averageLifespan(int generation, double &years);
+
+    const map<string, int> & getSurnames();
+    const map<int, int> & getDecades();
+
+    void memberAdded(dex::gdb::oid_t member, MemberClass &data);
+    void memberDeleting(dex::gdb::oid_t member);
+    void memberDeleted(dex::gdb::oid_t member);
+    void relationAdded(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head);
+    void relationDeleted(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head);
+    void reset();
+
+private:
+    struct Record{
+        bool counted;
+        string surname;
+        int decade;
+        int lifespan;
+        int generation;
+    };
+
+    static const int Unknown;
+
+    DexDBWrapper &db;
+    bool built;
+    bool dirty;
+    vector<Record> records;
+    map<string, int> surnames;
+    map<int, int> decades;
+    vector<int> generationCounts;
+    vector<double> lifespanSums;
+    vector<int> lifespanCounts;
+    int deleting;
+    vector<int> orphans;
+
+    bool ready();
+    void count(int node, MemberClass &data);
+    void uncount(int node);
+    void addToGeneration(int node, int sign);
+    void place(int node, int generation);
+    void settle(vector<int> &queue);
+    int depthOf(int node);
+    void recount();
+    void grow();
+    static void decrement(map<string, int> &counts, const string &key);
+    static void decrement(map<int, int> &counts, int key);
+};
+
+#endif // FAMILYAGGREGATES_H
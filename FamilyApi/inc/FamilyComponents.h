@@ -0,0 +1,54 @@
+#ifndef FAMILYCOMPONENTS_H
+#define FAMILYCOMPONENTS_H
+
+#include "DexDBWrapperListener.h"
+#include "ParentDag.h"
+#include <vector>
+
+using namespace std;
+
+// Families are the weakly connected components of the member graph over
+// every relation type, i.e. what dex::algorithms::WeakConnectivityDFS
+// reports for the member node type. They are kept in a union-find
+// (union by size, path halving) that follows addMember/addRelationTo, so
+// a same-family check or a family size costs O(alpha(n)). Union-find
+// cannot split, a deleted member or relation rebuilds it on the next query.
+// familyOf names a family by the oid of its root, which stays the same
+// until the family is merged into a larger one or rebuilt.
+class FamilyComponents : public DexDBWrapperListener
+{
+public:
+    FamilyComponents(ParentDag &dag);
+
+    void attach(dex::gdb::Graph *graph);
+    int build();
+
+    int sameFamily(dex::gdb::oid_t member_1, dex::gdb::oid_t member_2);
+    int familySize(dex::gdb::oid_t member);
+    dex::gdb::oid_t familyOf(dex::gdb::oid_t member);
+    int countFamilies();
+    int getFamilies(vector< vector<dex::gdb::oid_t> > &clans);
+
+    void memberAdded(dex::gdb::oid_t member, MemberClass &data);
+    void memberDeleted(dex::gdb::oid_t member);
+    void relationAdded(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head);
+    void relationDeleted(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head);
+    void reset();
+
+private:
+    ParentDag &dag;
+    dex::gdb::Graph * graph;
+    bool built;
+    bool dirty;
+    int families;
+
+    vector<int> leader;
+    vector<int> members;
+
+    int ready();
+    int find(int node);
+    void unite(int node_1, int node_2);
+    void grow();
+};
+
+#endif // FAMILYCOMPONENTS_H
@@ -0,0 +1,31 @@
+#ifndef FAMILYEXPORTER_H
+#define FAMILYEXPORTER_H
+
+#include "DexDBWrapper.h"
+#include "BufferedRowWriter.h"
+
+// Writes members and relations in the layout FamilyImporter reads back:
+// id,name,surname,sex,birth,heaven,partnerId and relation,id_1,id_2.
+// Attribute values go to the writer typed, so nothing is formatted through
+// a locale or a temporary StringList.
+class FamilyExporter
+{
+public:
+    FamilyExporter(DexDBWrapper &db);
+
+    void setHeader(bool header);
+
+    dex::gdb::int64_t exportMembers(BufferedRowWriter &writer);
+    dex::gdb::int64_t exportRelations(BufferedRowWriter &writer);
+
+private:
+    DexDBWrapper &db;
+    bool header;
+    dex::gdb::Value value;
+
+    void addLong(BufferedRowWriter &writer, dex::gdb::oid_t oid, dex::gdb::attr_t attr);
+    void addString(BufferedRowWriter &writer, dex::gdb::oid_t oid, dex::gdb::attr_t attr);
+    void addDate(BufferedRowWriter &writer, dex::gdb::oid_t oid, dex::gdb::attr_t attr);
+};
+
+#endif // FAMILYEXPORTER_H
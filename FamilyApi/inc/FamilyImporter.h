@@ -0,0 +1,60 @@
+#ifndef FAMILYIMPORTER_H
+#define FAMILYIMPORTER_H
+
+#include "DexDBWrapper.h"
+#include "ImportCheckpoint.h"
+#include "SeekableCSVReader.h"
+#include <map>
+#include <vector>
+
+// Bulk import of a members file (id,name,surname,sex,birth,heaven,partnerId)
+// followed by a relations file (relation,id_1,id_2) in batches of rows.
+// Every batch is one session transaction; after it commits the checkpoint is
+// advanced, so a restarted run resumes after the last committed batch.
+// The batch right after a resume may already be committed (crash between
+// Commit and the checkpoint write), so it is replayed idempotently. A batch
+// that fails is committed as far as it got (DEX has no rollback) and the
+// checkpoint points back at its start, so it is replayed the same way.
+// A member row whose id is already mapped by this import, or already in
+// the tree, is rejected; only in the replayed batch is a stored id taken as
+// the row's own earlier attempt.
+// A parent row that would make a member their own ancestor is rejected
+// through the wrapper's TopologicalOrder, like addRelationTo.
+// The imported and rejected counts are kept in the checkpoint and cover
+// every run of the import. run() returns 0 without importing anything
+// when the checkpoint says the import is already done.
+class FamilyImporter
+{
+public:
+    FamilyImporter(DexDBWrapper &db, ImportCheckpoint &checkpoint);
+
+    static const int DefaultBatchSize = 10000;
+
+    void setBatchSize(int rows);
+    int run(SeekableCSVReader &members, SeekableCSVReader &relations);
+
+    dex::gdb::int64_t getImported();
+    dex::gdb::int64_t getRejected();
+
+private:
+    DexDBWrapper &db;
+    ImportCheckpoint &checkpoint;
+    int batchSize;
+    dex::gdb::int64_t imported;
+    dex::gdb::int64_t rejected;
+
+    vector<wstring> fields;
+    map<wstring, dex::gdb::type_t> relations;
+
+    int importPhase(ImportPhase phase, SeekableCSVReader &reader);
+    void abortBatch(ImportPhase phase, bool open, dex::gdb::int64_t offset, dex::gdb::int32_t row, dex::gdb::int64_t imported, dex::gdb::int64_t rejected);
+    int storeMember(bool replay);
+    int storeRelation(bool replay);
+    dex::gdb::oid_t findMember(unsigned int id);
+
+    static bool parseId(const wstring &text, unsigned int &id);
+    static Sex parseSex(const wstring &text);
+    static bool parseDate(const wstring &text, DateClass &date);
+};
+
+#endif // FAMILYIMPORTER_H
@@ -0,0 +1,111 @@
+#ifndef FAMILYLAYOUT_H
+#define FAMILYLAYOUT_H
+
+#include "DexDBWrapper.h"
+#include "TreeLayout.h"
+#include "ContourLayout.h"
+#include <map>
+#include <vector>
+
+using namespace std;
+
+enum ChartDirection {descendantChart=0, ancestorChart};
+
+// One box of a chart. x is the centre of the box in box widths, the
+// leftmost box is at 0. generation counts from the root member: down for
+// descendants, negative (up) for ancestors. parentBox is the box the
+// member hangs from, -1 for the root; a partner box has the box of the
+// member it belongs to.
+struct LayoutBox{
+    dex::gdb::oid_t member;
+    bool partner;
+    int parentBox;
+    int generation;
+    double x;
+};
+
+// Coordinates for pedigree (ancestor) and descendant charts, computed from
+// the wrapper's ParentDag with TreeLayout.
+//
+// A chart is a tree: a member reached a second time through another line
+// (pedigree collapse) is only drawn where it was reached first, in the
+// nearest generation. In descendant charts partners stand right of the
+// member and the children are centred under the couple; partners are
+// resolved like DexDBWrapper does, partner edges either way plus the
+// partnerId a member was stored with. Siblings are
+// ordered by creation (oid), DEX keeps no order of its own.
+//
+// The last chart follows the wrapper's writes: a new or deleted parent
+// edge below a charted member, or a partner change, goes to a
+// ContourLayout that only re-places the path up to the root. getMoved()
+// then lists the members whose box moved against the box they hang from
+// (their subtree moves along). Edits that change where a member is
+// drawn first (pedigree collapse) or delete members lay the chart out
+// again from scratch when the boxes are next asked for.
+class FamilyLayout : public DexDBWrapperListener
+{
+public:
+    FamilyLayout(DexDBWrapper &db);
+    ~FamilyLayout();
+
+    void setMaxGenerations(int generations);
+    void setGap(double gap);
+    void setThreads(int threads);
+
+    int layout(MemberClass root, ChartDirection direction);
+    const vector<LayoutBox> & getBoxes();
+    const vector<dex::gdb::oid_t> & getMoved();
+
+    void memberAdded(dex::gdb::oid_t member, MemberClass &data);
+    void memberDeleted(dex::gdb::oid_t member);
+    void relationAdded(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head);
+    void relationDeleted(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head);
+    void reset();
+
+private:
+    DexDBWrapper &db;
+    int maxGenerations;
+    TreeLayout tree;
+    ContourLayout contours;
+
+    MemberClass root;
+    ChartDirection direction;
+    bool charted;
+    bool stale;
+    bool contoursBuilt;
+    bool boxesDirty;
+
+    bool partnersBuilt;
+    vector< vector<int> > partners;
+    // members naming a partnerId nobody has yet
+    map<unsigned int, vector<int> > waiting;
+
+    vector<int> chart;
+    vector<int> chartParent;
+    vector<double> chartWidth;
+    vector<int> chartNode;
+    vector<LayoutBox> boxes;
+    vector<dex::gdb::oid_t> moved;
+
+    int buildPartners();
+    const vector<int> & partnersOf(int node);
+    void name(int node, unsigned int partnerId);
+    bool names(dex::gdb::oid_t member, dex::gdb::oid_t partner);
+    void link(int node_1, int node_2);
+    void couple(int node_1, int node_2);
+    void unlink(int node_1, int node_2);
+    void collect(int root);
+    void fillBoxes(const vector<int> &nodes, const vector<int> &parents, const vector<double> &centres, const vector<int> &generations);
+    void contourBoxes();
+
+    int chartOf(int node);
+    const vector<int> & linksOf(int node);
+    const vector<int> & backLinksOf(int node);
+    void addToChart(int parent, int node);
+    void grow(dex::gdb::oid_t from, dex::gdb::oid_t to);
+    void shrink(dex::gdb::oid_t from, dex::gdb::oid_t to);
+    void resize(int node);
+    void updated(int first);
+};
+
+#endif // FAMILYLAYOUT_H
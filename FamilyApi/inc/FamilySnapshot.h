@@ -0,0 +1,167 @@
+// Publishes FamilySnapshots of a DexDBWrapper (copy on write, like RCU).
+//
+// The publisher keeps a working version up to date from the wrapper's
+// notifications. A write copies only the chunk or bucket it touches, and
+// only when a published version still holds it; everything else stays
+// shared. After every write the working version is stamped with the write
+// epoch and published by copying its pointer tables into a new version,
+// which replaces the latest one in a single pointer swap.
+//
+// read() may run on any thread and takes no lock: a reader counts itself
+// in under the current phase, loads the latest version and takes its
+// reference. The writer flips the phase after a swap and waits for the
+// readers of the old phase to leave before it drops the slot's reference
+// to the old version, so no reader can take a reference to a freed one.
+//
+// acquire() runs on the wrapper's thread, like every other DEX call: it
+// builds and publishes the first version, or the next one after a reset
+// (bulk import, delRelation). Until then readers keep the last version.
+#ifndef FAMILYSNAPSHOT_H
+#define FAMILYSNAPSHOT_H
+
+#include "DexDBWrapper.h"
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// A member as a snapshot keeps it, numbered like the ParentDag. A deleted
+// member stays behind with an invalid oid so the numbers do not move.
+struct SnapshotMember{
+    dex::gdb::oid_t oid;
+    unsigned int id;
+    string name;
+    string surname;
+    vector<int> parents;
+    vector<int> children;
+};
+
+// Piece of a version that versions share until one of them has to change
+// it. refs counts the versions holding it (the publisher's working copy
+// included) and is only changed with __sync builtins.
+template <class T> struct SnapshotChunk{
+    T items;
+    int refs;
+};
+
+typedef SnapshotChunk< vector<SnapshotMember> > MemberChunk;
+typedef SnapshotChunk< vector< pair<unsigned int, int> > > IdBucket;
+typedef SnapshotChunk< vector< pair<string, int> > > NameBucket;
+
+// One state of the indexes: members in chunks of RecordsPerChunk, member
+// ids and names hashed into buckets of (key, member number).
+struct SnapshotVersion{
+    unsigned long long epoch;
+    int refs;
+    int members;
+    vector<MemberChunk *> chunks;
+    vector<IdBucket *> ids;
+    vector<NameBucket *> names;
+};
+
+// An immutable view of the members, their names and the parent relation
+// as they were when it was acquired. Reading it takes no lock and never
+// touches DEX, so a long report can run on its own thread while the
+// wrapper goes on writing. Copies share the version; the last one to go
+// frees whatever no newer version uses.
+class FamilySnapshot
+{
+public:
+    FamilySnapshot();
+    FamilySnapshot(const FamilySnapshot &other);
+    ~FamilySnapshot();
+    FamilySnapshot & operator=(const FamilySnapshot &other);
+
+    bool isValid() const;
+    unsigned long long getEpoch() const;
+    int size() const;
+
+    dex::gdb::oid_t findMember(MemberClass member) const;
+    int findByName(MemberClass member, vector<unsigned int> *ids) const;
+    int findChildren(MemberClass member, vector<unsigned int> *ids) const;
+    int findParents(MemberClass member, vector<unsigned int> *ids) const;
+    int isAncestor(MemberClass ancestor, MemberClass member) const;
+    void release();
+
+private:
+    SnapshotVersion *version;
+
+    void hold(SnapshotVersion *version);
+    void adopt(SnapshotVersion *version);
+    int nodeOf(unsigned int id) const;
+    const SnapshotMember & memberAt(int node) const;
+    int listIds(const vector<int> &nodes, vector<unsigned int> *ids) const;
+    static size_t idBucket(unsigned int id, size_t buckets);
+    static size_t nameBucket(const string &name, size_t buckets);
+
+    friend class SnapshotPublisher;
+};
+
+// Publishes FamilySnapshots of a DexDBWrapper (copy on write, like RCU).
+//
+// The publisher keeps a working version up to date from the wrapper's
+// notifications. A write copies only the chunk or bucket it touches, and
+// only when a published version still holds it; everything else stays
+// shared. acquire() stamps the working version with the write epoch and
+// publishes a new version by copying the pointer tables, unless nothing
+// was written since the last one.
+//
+// acquire() runs on the wrapper's thread, like every other DEX call; the
+// snapshots it returns may then be read and released on any thread.
+// A reset (bulk import, delRelation) leaves the snapshots already handed
+// out alone and builds the working version again on the next acquire().
+class SnapshotPublisher : public DexDBWrapperListener
+{
+public:
+    SnapshotPublisher(DexDBWrapper &db);
+    ~SnapshotPublisher();
+
+    static const int RecordsPerChunk;
+    static const int MembersPerBucket;
+
+    int acquire(FamilySnapshot &snapshot);
+    int read(FamilySnapshot &snapshot);
+    unsigned long long getEpoch();
+    // versions, chunks and buckets of every publisher not freed yet
+    static int getLive();
+
+    void memberAdded(dex::gdb::oid_t member, MemberClass &data);
+    void memberDeleted(dex::gdb::oid_t member);
+    void relationAdded(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head);
+    void relationDeleted(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head);
+    void reset();
+
+private:
+    DexDBWrapper &db;
+    bool built;
+    SnapshotVersion working;
+    SnapshotVersion *latest;
+    int phase;
+    int readers[2];
+    unsigned long long epoch;
+    map<dex::gdb::oid_t, int> nodes;
+    static int live;
+
+    int build();
+    void index(int buckets);
+    void place(int node, SnapshotMember &member);
+    SnapshotMember & writable(int node);
+    vector< pair<unsigned int, int> > & writableIds(unsigned int id);
+    vector< pair<string, int> > & writableNames(const string &name);
+    void linkParent(int parent, int child, bool add);
+    void drop();
+    void changed();
+    void swap(SnapshotVersion *version);
+
+    static SnapshotVersion * publish(SnapshotVersion &working);
+    static void retain(SnapshotVersion &version);
+    static void release(SnapshotVersion &version);
+    template <class T> static T * own(T *chunk);
+    template <class T> static void unref(T *chunk);
+    template <class T> static void eraseOne(vector<T> &items, const T &item);
+
+    friend class FamilySnapshot;
+};
+
+#endif // FAMILYSNAPSHOT_H
@@ -0,0 +1,50 @@
+#ifndef HEAVYHITTERS_H
+#define HEAVYHITTERS_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct HeavyHitter{
+    string key;
+    long long count;
+    long long error;
+};
+
+// Most frequent keys of a stream in fixed memory (SpaceSaving, Metwally
+// et al.). At most capacity keys are counted; a new key takes the place
+// of the smallest counter and inherits its count as possible error. A
+// reported count is never below the true one and at most error above
+// it, and error never exceeds total / capacity, so every key seen more
+// often than that is in the table.
+//
+// The smallest counter is found through a min-heap over the counters,
+// an add is O(log capacity).
+class HeavyHitters
+{
+public:
+    HeavyHitters(int capacity);
+
+    void clear();
+    void add(const string &key);
+
+    int getCapacity();
+    long long getTotal();
+    int estimate(const string &key, long long &count, long long &error);
+    int top(int k, vector<HeavyHitter> &hitters);
+
+private:
+    int capacity;
+    long long total;
+    vector<HeavyHitter> counters;
+    vector<int> heap;
+    vector<int> slot;
+    map<string, int> index;
+
+    void siftDown(int at);
+    void swapAt(int a, int b);
+};
+
+#endif // HEAVYHITTERS_H
@@ -0,0 +1,70 @@
+#ifndef IMPORTCHECKPOINT_H
+#define IMPORTCHECKPOINT_H
+
+#include "dex/gdb/common.h"
+#include <map>
+#include <string>
+
+using namespace std;
+
+enum ImportPhase{
+    importMembers=0,
+    importRelations,
+    importDone
+};
+
+// Durable progress of a FamilyImporter run.
+//
+// The checkpoint itself is a few lines written alternately to <path>.0 and
+// <path>.1, so a crash while writing one slot always leaves the previous one
+// readable. The member id to oid map only grows during an import and is
+// kept in an append-only journal <path>.ids; each checkpoint records how
+// many journal bytes belong to it, anything past that is ignored on load.
+// discard() forgets the ids mapped since the last save the same way.
+class ImportCheckpoint
+{
+public:
+    ImportCheckpoint(string path);
+
+    int load();
+    int save();
+    int clear();
+
+    ImportPhase getPhase();
+    dex::gdb::int64_t getOffset();
+    dex::gdb::int32_t getRow();
+    dex::gdb::int64_t getBatch();
+    dex::gdb::int64_t getImported();
+    dex::gdb::int64_t getRejected();
+
+    void advance(ImportPhase phase, dex::gdb::int64_t offset, dex::gdb::int32_t row);
+    void setCounts(dex::gdb::int64_t imported, dex::gdb::int64_t rejected);
+
+    void mapId(unsigned int id, dex::gdb::oid_t oid);
+    dex::gdb::oid_t findId(unsigned int id);
+    int discard();
+
+private:
+    string path;
+
+    ImportPhase phase;
+    dex::gdb::int64_t offset;
+    dex::gdb::int32_t row;
+    dex::gdb::int64_t batch;
+    dex::gdb::int64_t journalLength;
+    dex::gdb::int64_t imported;
+    dex::gdb::int64_t rejected;
+
+    map<unsigned int, dex::gdb::oid_t> ids;
+    string pending;
+
+    string slotPath(dex::gdb::int64_t batch);
+    string journalPath();
+    string format();
+    int readSlot(string path, dex::gdb::int64_t &batch);
+    int readJournal();
+    static unsigned int checksum(const string &text);
+    static int syncFile(FILE *file);
+};
+
+#endif // IMPORTCHECKPOINT_H
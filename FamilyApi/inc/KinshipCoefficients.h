@@ -0,0 +1,78 @@
+#ifndef KINSHIPCOEFFICIENTS_H
+#define KINSHIPCOEFFICIENTS_H
+
+#include "DexDBWrapperListener.h"
+#include "ParentDag.h"
+#include "TopologicalOrder.h"
+#include <map>
+#include <vector>
+
+using namespace std;
+
+// Wright's coefficients over the parent DAG. The kinship of a and b is the
+// chance that alleles drawn at random from each are identical by descent,
+// the inbreeding of a member is the kinship of its two parents.
+//
+// With a drawn later than b in the topological order (so a is no ancestor
+// of b) kinship(a, b) = (kinship(father, b) + kinship(mother, b)) / 2 and
+// kinship(a, a) = (1 + inbreeding(a)) / 2. The recursion runs on an
+// explicit stack and every pair it passes is memoized, so collapsed
+// pedigrees share their sub-results and later queries reuse them. A
+// missing parent counts as unrelated founder stock; only the first two
+// parents of a member are used.
+//
+// kinshipMatrix() fills a whole matrix for a selection of members without
+// going pair by pair. The selection and its ancestors are put in
+// generation order, their inbreeding comes from one Meuwissen & Luo pass,
+// and the matrix is 2A = T D T' (Colleau): each column is one pass up and
+// one pass down the pedigree. Worker threads take Block columns at a time,
+// so the passes stream over Block wide rows. That is O(selected x
+// ancestors); the matrix itself is selected^2 doubles. Any change to the
+// parent relation empties the memo.
+class KinshipCoefficients : public DexDBWrapperListener
+{
+public:
+    KinshipCoefficients(ParentDag &dag, TopologicalOrder &order);
+
+    void setThreads(int threads);
+
+    int kinship(dex::gdb::oid_t member_1, dex::gdb::oid_t member_2, double &coefficient);
+    int inbreeding(dex::gdb::oid_t member, double &coefficient);
+    int kinshipMatrix(const vector<dex::gdb::oid_t> &members, vector<double> &matrix);
+
+    void memberDeleted(dex::gdb::oid_t member);
+    void relationAdded(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head);
+    void relationDeleted(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head);
+    void reset();
+
+private:
+    typedef pair<int, int> Pair;
+    typedef map<Pair, double> Memo;
+
+    static const int Block;
+    static const size_t MemoLimit;
+
+    ParentDag &dag;
+    TopologicalOrder &order;
+    int threads;
+    Memo memo;
+
+    // kinshipMatrix() state, rows are the selection and its ancestors in
+    // generation order
+    vector<int> sire;
+    vector<int> dam;
+    vector<double> variance;
+    vector<int> selectedRow;
+    vector<double> *matrix;
+    int nextColumn;
+
+    int ready();
+    Pair key(int node_1, int node_2);
+    double evaluate(int node_1, int node_2, Memo &memo);
+    int collectAncestors(const vector<dex::gdb::oid_t> &members);
+    void computeVariances();
+    void fillColumns(int first, vector<double> &work);
+    static void * worker(void *coefficients);
+};
+
+#endif // KINSHIPCOEFFICIENTS_H
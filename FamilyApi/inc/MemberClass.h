@@ -35,6 +35,28 @@ private:
     MemberClass * relationTo;
 
     unsigned int partnerId;
+
+public:
+    unsigned int getId();
+    void setId(unsigned int id);
+
+    string getName();
+    void setName(string name);
+
+    string getSurname();
+    void setSurname(string surname);
+
+    Sex getSex();
+    void setSex(Sex sex);
+
+    DateClass getBirthDate();
+    void setBirthDate(DateClass birthDate);
+
+    DateClass getHeavenDate();
+    void setHeavenDate(DateClass heavenDate);
+
+    unsigned int getPartnerId();
+    void setPartnerId(unsigned int partnerId);
 };
 
 #endif // MEMBERCLASS_H
@@ -0,0 +1,59 @@
+#ifndef MEMBERCURSOR_H
+#define MEMBERCURSOR_H
+
+#include "DexSchema.h"
+#include "dex/gdb/Objects.h"
+#include "dex/gdb/ObjectsIterator.h"
+#include <vector>
+
+using namespace std;
+
+// Pages through the members a DexDBWrapper query found without copying
+// the whole result. The cursor owns the query's Objects set and walks it
+// with an ObjectsIterator, taking BlockSize oids at a time into a buffer
+// that the pages are served from; members are read only for the oids a
+// page returns.
+//
+// seek() starts over at an offset with IteratorFromIndex, seekAfter()
+// resumes after the last oid of the previous page (getLast()) with
+// IteratorFromElement. Either way a deep page costs as much as the page,
+// not the offset. seekAfter() returns 0 when that member has left the
+// result in between, the caller then falls back to an offset.
+// The set belongs to the wrapper's session, close the cursor before the
+// wrapper disconnects.
+class MemberCursor
+{
+public:
+    MemberCursor();
+    ~MemberCursor();
+
+    static const int BlockSize;
+
+    void open(dex::gdb::Graph *graph, DexSchema *schema, dex::gdb::Objects *members);
+    void close();
+    bool isOpen();
+
+    dex::gdb::int64_t count();
+    int seek(dex::gdb::int64_t index);
+    int seekAfter(dex::gdb::oid_t last);
+    int next(int max, vector<dex::gdb::oid_t> &page);
+    int next(int max, vector<MemberClass> &page);
+    dex::gdb::oid_t getLast();
+
+private:
+    dex::gdb::Graph *graph;
+    DexSchema *schema;
+    dex::gdb::Objects *members;
+    dex::gdb::ObjectsIterator *it;
+    vector<dex::gdb::oid_t> block;
+    size_t blockAt;
+    dex::gdb::oid_t last;
+
+    void restart(dex::gdb::ObjectsIterator *from);
+    bool fill();
+
+    MemberCursor(const MemberCursor &);
+    MemberCursor & operator =(const MemberCursor &);
+};
+
+#endif // MEMBERCURSOR_H
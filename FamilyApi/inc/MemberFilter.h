@@ -0,0 +1,56 @@
+#ifndef MEMBERFILTER_H
+#define MEMBERFILTER_H
+
+#include "DexSchema.h"
+#include <vector>
+
+using namespace std;
+
+// Cuckoo filter over the member ids, so looking up an id nobody has yet
+// (most of what an import's dedupe asks) is answered without a DEX index
+// probe. mayContain() never says no for a stored id and says yes for a
+// missing one at most about once in 8000 lookups (16 bit fingerprints,
+// buckets of four).
+//
+// Unlike a Bloom filter a cuckoo filter can take ids out again, so it
+// follows deletions. Like ParentDag it is filled lazily on first use and
+// then kept up to date by DexDBWrapper. When an insert finds no room the
+// filter is dropped and filled again at twice the size.
+class MemberFilter
+{
+public:
+    MemberFilter();
+
+    static const int SlotsPerBucket;
+    static const int MaxKicks;
+
+    void attach(dex::gdb::Graph *graph, DexSchema *schema);
+    int build();
+    bool isBuilt();
+    void clear();
+
+    int mayContain(unsigned int id);
+    void insert(unsigned int id);
+    void remove(unsigned int id);
+    int size();
+
+private:
+    dex::gdb::Graph * graph;
+    DexSchema * schema;
+    bool built;
+
+    vector<unsigned short> slots;
+    size_t mask;
+    int count;
+    int minimum;
+    unsigned int random;
+
+    void resize(int ids);
+    bool place(size_t bucket, unsigned short fingerprint);
+    bool find(size_t bucket, unsigned short fingerprint);
+    size_t alternate(size_t bucket, unsigned short fingerprint);
+    static unsigned long long hash(unsigned int id);
+    static unsigned short fingerprintOf(unsigned long long bits);
+};
+
+#endif // MEMBERFILTER_H
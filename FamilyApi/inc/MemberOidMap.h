@@ -0,0 +1,48 @@
+#ifndef MEMBEROIDMAP_H
+#define MEMBEROIDMAP_H
+
+#include "dex/gdb/common.h"
+#include <vector>
+
+using namespace std;
+
+// Member id -> DEX oid, so DexDBWrapper does not go through
+// Graph::FindObject on the id attribute every time a call names a member.
+//
+// One flat array of (id, oid) slots with Robin Hood linear probing: an
+// insert takes the slot of any entry that sits closer to its home slot,
+// which keeps the probe lengths short and even, and lets a lookup stop as
+// soon as it meets an entry closer to home than the one searched for. An
+// erase shifts the following entries back instead of leaving a tombstone.
+// Nothing is allocated per entry; the array doubles when three quarters
+// full. InvalidOID marks a free slot.
+class MemberOidMap
+{
+public:
+    MemberOidMap();
+
+    static const int InitialSlots;
+
+    dex::gdb::oid_t find(unsigned int id);
+    void put(unsigned int id, dex::gdb::oid_t oid);
+    void erase(unsigned int id);
+    void clear();
+    int size();
+
+private:
+    struct Slot{
+        unsigned int id;
+        dex::gdb::oid_t oid;
+    };
+
+    vector<Slot> slots;
+    size_t mask;
+    int shift;
+    int count;
+
+    void resize(size_t size);
+    size_t home(unsigned int id);
+    size_t distance(size_t slot);
+};
+
+#endif // MEMBEROIDMAP_H
@@ -0,0 +1,90 @@
+#ifndef MEMBERQUERY_H
+#define MEMBERQUERY_H
+
+#include "DexDBWrapper.h"
+#include "MemberCursor.h"
+#include "dex/gdb/Value.h"
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Compound member search ("surname = X and born 1800-1850 and male") with
+// a small cost based planner.
+//
+// Every condition is on an indexed attribute. Its row count is estimated
+// from the attribute statistics: total / distinct values for an equality,
+// the share of the min..max span for a year range. The statistics are
+// kept per attribute and read again once a tenth of the members changed.
+// The most selective condition runs first as an indexed Select. Each of
+// the others, most selective first, is then either selected too and
+// intersected (about IntersectCost per row it selects) or checked on the
+// members left (CheckCost per member, one GetAttribute), whichever the
+// row counts at that point make cheaper. Those counts are the real ones
+// once the query runs, explain() shows both.
+class MemberQuery : public DexDBWrapperListener
+{
+public:
+    MemberQuery(DexDBWrapper &db);
+    ~MemberQuery();
+
+    static const double IntersectCost;
+    static const double CheckCost;
+
+    void clear();
+    int whereName(string name);
+    int whereSurname(string surname);
+    int whereSex(Sex sex);
+    int whereBornBetween(int firstYear, int lastYear);
+    int whereDiedBetween(int firstYear, int lastYear);
+
+    int count();
+    int open(MemberCursor &cursor);
+    string explain();
+
+    void memberAdded(dex::gdb::oid_t member, MemberClass &data);
+    void memberDeleted(dex::gdb::oid_t member);
+    void reset();
+
+private:
+    struct Condition{
+        dex::gdb::attr_t attr;
+        bool range;
+        dex::gdb::Value lower;
+        dex::gdb::Value higher;
+        string text;
+        double estimate;
+    };
+    struct Statistics{
+        double total;
+        double distinct;
+        double min;
+        double max;
+    };
+    struct Step{
+        int condition;
+        bool check;
+        double rows;
+        double actual;
+    };
+
+    DexDBWrapper &db;
+    vector<Condition> conditions;
+    vector<Step> plan;
+    bool executed;
+    map<dex::gdb::attr_t, Statistics> statistics;
+    int changes;
+
+    int add(Condition &condition, dex::gdb::attr_t attr, bool range, string text);
+    int yearRange(dex::gdb::attr_t attr, int firstYear, int lastYear, string text);
+    void estimate(Condition &condition);
+    Statistics & statisticsOf(dex::gdb::attr_t attr);
+    void makePlan();
+    dex::gdb::Objects * execute();
+    dex::gdb::Objects * select(Condition &condition);
+    bool matches(dex::gdb::oid_t oid, Condition &condition, dex::gdb::Value &value);
+    static bool cheaperToCheck(double rows, double selected);
+};
+
+#endif // MEMBERQUERY_H
@@ -0,0 +1,55 @@
+#ifndef MEMBERSAMPLER_H
+#define MEMBERSAMPLER_H
+
+#include "DexDBWrapper.h"
+#include <vector>
+
+using namespace std;
+
+// About how many, with bounds: low <= total <= high at 95% confidence.
+// exact is set when everything was counted rather than sampled.
+struct SampleEstimate{
+    double estimate;
+    double low;
+    double high;
+    bool exact;
+};
+
+// Previews for the overview widgets: an estimated result size and a few
+// random members, in time that follows the sample size rather than the
+// result size.
+//
+// For a name the DEX result set is a bitmap whose Count() is exact and
+// cheap, so only the examples are sampled (Objects::Sample). For the
+// descendants or ancestors of a member a sample of all members is drawn
+// and each one is tested against the reachability index; the share found
+// gives the estimate with a Wilson score interval, and the members found
+// are uniform examples of the closure. A closure the sample barely touches
+// (fewer hits than examples wanted, or at most walkLimit members by the
+// interval) is walked in the ParentDag instead, as long as the walk stays
+// within walkLimit members; then the count is exact and the examples are
+// drawn from the whole closure.
+class MemberSampler
+{
+public:
+    MemberSampler(DexDBWrapper &db);
+
+    static const int DefaultWalkLimit = 4096;
+
+    void setWalkLimit(int members);
+
+    int sampleByName(MemberClass member, int examples, SampleEstimate &total, vector<MemberClass> &found);
+    int sampleDescendants(MemberClass member, int samples, int examples, SampleEstimate &total, vector<MemberClass> &found);
+    int sampleAncestors(MemberClass member, int samples, int examples, SampleEstimate &total, vector<MemberClass> &found);
+
+private:
+    DexDBWrapper &db;
+    int walkLimit;
+
+    int sampleLine(MemberClass &member, bool down, int samples, int examples, SampleEstimate &total, vector<MemberClass> &found);
+    dex::gdb::Objects * walk(dex::gdb::oid_t oid, bool down);
+    void read(dex::gdb::Objects *members, int examples, vector<MemberClass> &found);
+    static void bounds(double hits, double drawn, double population, SampleEstimate &total);
+};
+
+#endif // MEMBERSAMPLER_H
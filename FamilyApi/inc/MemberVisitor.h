@@ -0,0 +1,73 @@
+#ifndef MEMBERVISITOR_H
+#define MEMBERVISITOR_H
+
+#include "DexSchema.h"
+#include "dex/gdb/Value.h"
+#include <string>
+
+using namespace std;
+
+// A member seen during a DexDBWrapper::forEach* walk. Attributes are read
+// from DEX only when asked for, into buffers the view keeps from member
+// to member, so a walk neither builds MemberClass instances nor copies
+// strings. The references it hands out are borrowed: they hold until the
+// same getter is called again or the visitor returns.
+class MemberView
+{
+public:
+    MemberView(dex::gdb::Graph *graph, DexSchema *schema);
+
+    void moveTo(dex::gdb::oid_t oid);
+
+    dex::gdb::oid_t getOid();
+    unsigned int getId();
+    const wstring & getName();
+    const wstring & getSurname();
+    Sex getSex();
+    int getBirthYear();
+    int getHeavenYear();
+    unsigned int getPartnerId();
+    void read(MemberClass &member);
+
+private:
+    dex::gdb::Graph *graph;
+    DexSchema *schema;
+    dex::gdb::oid_t oid;
+    dex::gdb::Value value;
+    dex::gdb::Value name;
+    dex::gdb::Value surname;
+
+    static const wstring Empty;
+
+    int yearOf(dex::gdb::attr_t attr);
+};
+
+// Called once per member of a walk, returning false stops it.
+class MemberVisitor
+{
+public:
+    virtual ~MemberVisitor(){}
+
+    virtual bool visit(MemberView &member)=0;
+};
+
+// Lets any functor with bool operator()(MemberView &) be the visitor
+// without a subclass of its own. visit() is still a virtual call.
+template <class Functor>
+class FunctorVisitor : public MemberVisitor
+{
+public:
+    FunctorVisitor(Functor &functor)
+    : functor(functor)
+    {
+    }
+
+    bool visit(MemberView &member){
+        return functor(member);
+    }
+
+private:
+    Functor &functor;
+};
+
+#endif // MEMBERVISITOR_H
@@ -0,0 +1,42 @@
+#ifndef NAMESKETCHES_H
+#define NAMESKETCHES_H
+
+#include "DexDBWrapper.h"
+#include "HeavyHitters.h"
+
+using namespace std;
+
+// Approximate most common surnames and first names of the tree in fixed
+// memory, counted by two HeavyHitters tables as members are added. The
+// tables cannot take a key out again, so a deletion (like a reset) makes
+// the next top* call build() them from the members again.
+class NameSketches : public DexDBWrapperListener
+{
+public:
+    NameSketches(DexDBWrapper &db, int capacity);
+    ~NameSketches();
+
+    int build();
+
+    HeavyHitters & getSurnames();
+    HeavyHitters & getNames();
+    int topSurnames(int k, vector<HeavyHitter> &hitters);
+    int topNames(int k, vector<HeavyHitter> &hitters);
+
+    void memberAdded(dex::gdb::oid_t member, MemberClass &data);
+    void memberDeleted(dex::gdb::oid_t member);
+    void reset();
+
+private:
+    DexDBWrapper &db;
+    bool built;
+    HeavyHitters surnames;
+    HeavyHitters names;
+
+    void count(const string &name, const string &surname);
+    bool operator()(MemberView &member);
+
+    friend class FunctorVisitor<NameSketches>;
+};
+
+#endif // NAMESKETCHES_H
@@ -0,0 +1,52 @@
+#ifndef PARENTDAG_H
+#define PARENTDAG_H
+
+#include "DexSchema.h"
+#include <map>
+#include <vector>
+
+using namespace std;
+
+// In-memory copy of the parent relation (parent -> child edges) with dense
+// node numbers, so the ancestry indexes do not have to go back to DEX for
+// every step. It is filled lazily on first use and then kept up to date by
+// DexDBWrapper. Node numbers of deleted members are not reused.
+class ParentDag
+{
+public:
+    ParentDag();
+
+    void attach(dex::gdb::Graph *graph, DexSchema *schema);
+    int build();
+    bool isBuilt();
+    void clear();
+
+    dex::gdb::type_t getParentType();
+
+    int size();
+    int indexOf(dex::gdb::oid_t oid);
+    dex::gdb::oid_t oidOf(int node);
+    bool isAlive(int node);
+    const vector<int> & getParents(int node);
+    const vector<int> & getChildren(int node);
+
+    int addNode(dex::gdb::oid_t oid);
+    void removeNode(int node);
+    void addEdge(int parent, int child);
+    void removeEdge(int parent, int child);
+
+private:
+    dex::gdb::Graph * graph;
+    DexSchema * schema;
+    bool built;
+
+    map<dex::gdb::oid_t, int> index;
+    vector<dex::gdb::oid_t> oids;
+    vector<bool> alive;
+    vector< vector<int> > parents;
+    vector< vector<int> > children;
+
+    static void eraseOne(vector<int> &nodes, int node);
+};
+
+#endif // PARENTDAG_H
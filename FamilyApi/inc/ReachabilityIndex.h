@@ -0,0 +1,64 @@
+#ifndef REACHABILITYINDEX_H
+#define REACHABILITYINDEX_H
+
+#include "DexDBWrapperListener.h"
+#include "ParentDag.h"
+#include <vector>
+
+using namespace std;
+
+// Answers "is a an ancestor of b" without a traversal.
+//
+// Every member gets a postorder number from a DFS spanning forest of the
+// parent DAG. A member's label is the sorted list of number intervals that
+// cover itself and all its descendants: the spanning tree subtree is one
+// interval, descendants reached only through a second parent add the
+// (few) extra intervals. The query is a binary search for b's number in
+// a's list.
+//
+// Adding a parent edge merges the child's list into the parent and its
+// ancestors, stopping where the list is already covered. Removing a
+// non-tree edge recomputes the labels of the parent's ancestors only;
+// removing a tree edge or a member rebuilds the labels on the next query.
+class ReachabilityIndex : public DexDBWrapperListener
+{
+public:
+    ReachabilityIndex(ParentDag &dag);
+
+    int isAncestor(dex::gdb::oid_t ancestor, dex::gdb::oid_t member);
+    int build();
+
+    void memberAdded(dex::gdb::oid_t member, MemberClass &data);
+    void memberDeleted(dex::gdb::oid_t member);
+    void relationAdded(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head);
+    void relationDeleted(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head);
+    void reset();
+
+private:
+    struct Interval{
+        int low;
+        int high;
+    };
+    typedef vector<Interval> Intervals;
+
+    ParentDag &dag;
+    bool built;
+    bool dirty;
+    int nextNumber;
+    int insertsSinceBuild;
+
+    vector<int> number;
+    vector<int> low;
+    vector<int> treeParent;
+    vector<Intervals> labels;
+    vector<unsigned int> seen;
+    unsigned int walk;
+
+    void label(int node);
+    void recomputeAncestors(int node);
+    static bool contains(const Intervals &intervals, int value);
+    static bool covers(const Intervals &outer, const Intervals &inner);
+    static void merge(Intervals &target, const Intervals &source);
+};
+
+#endif // REACHABILITYINDEX_H
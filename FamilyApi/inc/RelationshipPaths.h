@@ -0,0 +1,82 @@
+#ifndef RELATIONSHIPPATHS_H
+#define RELATIONSHIPPATHS_H
+
+#include "DexDBWrapper.h"
+#include <ctime>
+#include <map>
+#include <vector>
+
+using namespace std;
+
+// One way two members are related: up from the first member to a common
+// ancestor and down to the second. members runs from member_1 to member_2
+// through the ancestor, up and down count the parent edges of each half.
+// When both halves hang from a couple (full siblings, full cousins...)
+// the relationship is reported once, apexes then holds both parents.
+// A member that is an ancestor of the other is its own apex.
+struct RelationshipPath{
+    vector<dex::gdb::oid_t> members;
+    vector<dex::gdb::oid_t> apexes;
+    int up;
+    int down;
+};
+
+// Receives the paths as they are found, returning false stops the search.
+class RelationshipPathSink
+{
+public:
+    virtual ~RelationshipPathSink(){}
+
+    virtual bool pathFound(const RelationshipPath &path)=0;
+};
+
+// Enumerates every way two members are related over the parent DAG.
+//
+// The search runs from both ends: the ancestors of each member are found
+// with their distance, up to the length limit, and the common ones are the
+// candidate apexes, nearest first. From an apex only nodes that lead to
+// the member within the remaining length are followed down. A path whose
+// halves share a member below the apex is the same relationship as the
+// one through that member and is skipped, so is the second parent of a
+// couple. The search stops at the length limit, after maxResults paths,
+// after the time budget (processor time) or when the sink says so.
+class RelationshipPaths
+{
+public:
+    RelationshipPaths(DexDBWrapper &db);
+
+    void setMaxLength(int edges);
+    void setMaxResults(int results);
+    void setTimeBudget(double seconds);
+
+    int enumerate(MemberClass member_1, MemberClass member_2, RelationshipPathSink &sink);
+    bool isComplete();
+
+private:
+    DexDBWrapper &db;
+    int maxLength;
+    int maxResults;
+    double timeBudget;
+
+    ParentDag *dag;
+    RelationshipPathSink *sink;
+    map<int, int> distance_1;
+    map<int, int> distance_2;
+    vector<int> chain_1;
+    vector<int> chain_2;
+    vector<char> onChain;
+    int apex;
+    int target;
+    int found;
+    int steps;
+    bool stopped;
+    clock_t started;
+
+    void search(int node_1, int node_2);
+    void ancestors(int node, map<int, int> &distance);
+    void descend(int node, int end, const map<int, int> &distance, int budget, vector<int> &chain, bool first);
+    void emit();
+    bool outOfTime();
+};
+
+#endif // RELATIONSHIPPATHS_H
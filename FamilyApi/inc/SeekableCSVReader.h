@@ -0,0 +1,52 @@
+#ifndef SEEKABLECSVREADER_H
+#define SEEKABLECSVREADER_H
+
+#include "dex/io/RowReader.h"
+#include <cstdio>
+#include <string>
+
+using namespace std;
+
+// UTF-8 CSV RowReader which knows the byte offset of the next row, so an
+// interrupted import can continue from a checkpoint without re-reading the
+// file from the beginning (dex::io::CSVReader can only skip whole lines).
+class SeekableCSVReader : public dex::io::RowReader
+{
+public:
+    SeekableCSVReader();
+    virtual ~SeekableCSVReader();
+
+    void setSeparator(char separator);
+    void setQuote(char quote);
+
+    int open(string path);
+    int seek(dex::gdb::int64_t offset, dex::gdb::int32_t row);
+    dex::gdb::int64_t getOffset();
+
+    dex::gdb::bool_t Reset()
+    throw(dex::gdb::IOException);
+    dex::gdb::bool_t Read(dex::gdb::StringList &row)
+    throw(dex::gdb::IOException);
+    dex::gdb::int32_t GetRow()
+    throw(dex::gdb::IOException);
+    void Close()
+    throw(dex::gdb::IOException);
+
+private:
+    static const size_t BufferSize = 1 << 20;
+
+    FILE * file;
+    char separator;
+    char quote;
+    dex::gdb::int64_t offset;
+    dex::gdb::int32_t row;
+    string field;
+    wstring decoded;
+
+    SeekableCSVReader(const SeekableCSVReader &reader);
+    SeekableCSVReader & operator =(const SeekableCSVReader &reader);
+
+    void addField(dex::gdb::StringList &row);
+};
+
+#endif // SEEKABLECSVREADER_H
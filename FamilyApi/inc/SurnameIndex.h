@@ -0,0 +1,54 @@
+#ifndef SURNAMEINDEX_H
+#define SURNAMEINDEX_H
+
+#include "DexDBWrapper.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct SurnameCount{
+    string surname;
+    int members;
+};
+
+// Alphabetical browse over the distinct surnames with how many members
+// carry each, for the surname index pages.
+//
+// DEX hands out the distinct values of the indexed surname attribute in
+// order (Graph::GetValues) but its iterator cannot seek, so they are read
+// once into a sorted list that seek() searches for a prefix. Pages then
+// move forward and backward from there. The count of a value comes from
+// the attribute index (GetAttributeIntervalCount) when its page is read;
+// no member object is touched.
+//
+// New members add their surname to the list. A surname whose last member
+// was deleted stays in it and is skipped with its count of 0, until the
+// list is read again after a reset.
+class SurnameIndex : public DexDBWrapperListener
+{
+public:
+    SurnameIndex(DexDBWrapper &db);
+    ~SurnameIndex();
+
+    int build();
+    int size();
+
+    int seek(string prefix);
+    int next(int max, vector<SurnameCount> &page);
+    int previous(int max, vector<SurnameCount> &page);
+
+    void memberAdded(dex::gdb::oid_t member, MemberClass &data);
+    void reset();
+
+private:
+    DexDBWrapper &db;
+    bool built;
+    vector<wstring> surnames;
+    int begin;
+    int end;
+
+    int count(const wstring &surname);
+};
+
+#endif // SURNAMEINDEX_H
@@ -0,0 +1,46 @@
+#ifndef TOPOLOGICALORDER_H
+#define TOPOLOGICALORDER_H
+
+#include "DexDBWrapperListener.h"
+#include "ParentDag.h"
+#include <vector>
+
+using namespace std;
+
+// Keeps a topological order of the parent DAG (every parent before its
+// children) so that a new parent edge can be checked for cycles without
+// a search of the whole graph (Pearce & Kelly, "A dynamic topological sort
+// algorithm for directed acyclic graphs").
+//
+// An edge parent -> child that already agrees with the order is accepted
+// in O(1). Otherwise only the members numbered between child and parent
+// are visited: the descendants of child and the ancestors of parent in
+// that range are searched, a cycle exists if the first search reaches
+// parent, and if not the two sets swap their positions.
+class TopologicalOrder : public DexDBWrapperListener
+{
+public:
+    TopologicalOrder(ParentDag &dag);
+
+    int build();
+    int insertEdge(dex::gdb::oid_t tail, dex::gdb::oid_t head);
+    int positionOf(int node);
+
+    void memberAdded(dex::gdb::oid_t member, MemberClass &data);
+    void reset();
+
+private:
+    ParentDag &dag;
+    bool built;
+
+    vector<int> position;
+    vector<int> nodeAt;
+    vector<char> visited;
+
+    bool searchForward(int child, int upper, vector<int> &found);
+    void searchBackward(int parent, int lower, vector<int> &found);
+    void reorder(vector<int> &forward, vector<int> &backward);
+    void grow();
+};
+
+#endif // TOPOLOGICALORDER_H
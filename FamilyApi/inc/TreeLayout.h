@@ -0,0 +1,65 @@
+#ifndef TREELAYOUT_H
+#define TREELAYOUT_H
+
+#include <vector>
+
+using namespace std;
+
+// Tidy tree drawing in linear time (Walker's algorithm as corrected by
+// Buchheim, Juenger and Leipert). Nodes have a width, siblings keep their
+// order, parents are centred over their children and whole subtrees are
+// pushed apart only as far as their contours require.
+//
+// The tree is given in breadth first order: node 0 is the root, parent[v]
+// < v, and the children of a node are consecutive. That order lets both
+// walks run without recursion: going backwards every node is reached after
+// all of its descendants. Subtrees below a wide enough level do not touch
+// each other and are placed by worker threads.
+class TreeLayout
+{
+public:
+    TreeLayout();
+
+    void setGap(double gap);
+    void setThreads(int threads);
+
+    void layout(const vector<int> &parent, const vector<double> &width);
+
+    int size();
+    double getX(int node);
+    int getDepth(int node);
+
+private:
+    double gap;
+    int threads;
+
+    vector<int> parent;
+    vector<double> width;
+    vector<int> depth;
+    vector<int> firstChild;
+    vector<int> childCount;
+
+    vector<double> prelim;
+    vector<double> mod;
+    vector<double> shift;
+    vector<double> change;
+    vector<int> thread;
+    vector<int> ancestor;
+    vector<double> x;
+
+    int nextTask;
+    int lastTask;
+
+    void place(int node);
+    int apportion(int node, int defaultAncestor);
+    void moveSubtree(int left, int right, double distance);
+    void executeShifts(int node);
+    int nextLeft(int node);
+    int nextRight(int node);
+    double distance(int left, int right);
+
+    void placeSubtree(int root, vector<int> &nodes);
+    static void * worker(void *layout);
+};
+
+#endif // TREELAYOUT_H
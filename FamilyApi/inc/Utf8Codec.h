@@ -0,0 +1,21 @@
+#ifndef UTF8CODEC_H
+#define UTF8CODEC_H
+
+#include <string>
+
+using namespace std;
+
+// DEX keeps every string as std::wstring while MemberClass, the CSV files
+// and the exporters work on UTF-8 bytes. These helpers convert between the
+// two without going through the C locale.
+class Utf8Codec
+{
+public:
+    static wstring decode(const string &text);
+    static void decode(const char *text, size_t length, wstring &out);
+
+    static string encode(const wstring &text);
+    static void encode(const wstring &text, string &out);
+};
+
+#endif // UTF8CODEC_H
@@ -0,0 +1,76 @@
+#ifndef WEIGHTEDRELATIONSEARCH_H
+#define WEIGHTEDRELATIONSEARCH_H
+
+#include "DexDBWrapper.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Cheapest relationship between members when relation kinds have small
+// integer costs (blood 1, marriage 2, adoption 3...), the job DEX's
+// SinglePairShortestPathDijkstra does with a cost attribute on each edge.
+//
+// The relations with a cost are copied into per-member arc lists, numbered
+// like the ParentDag and kept up to date from the wrapper's notifications.
+// Searches run on that copy with Dial's bucket queue: costs are at most
+// MaxCost, so every open distance lies within MaxCost + 1 of the smallest
+// one and a ring of that many buckets replaces the heap. Distances are
+// reset by stamping them with a query number and the buckets keep their
+// capacity, so a query allocates nothing once the arrays have grown.
+//
+// Costs match DEX's Dijkstra. When several paths share the cheapest cost
+// either search may return a different one.
+class WeightedRelationSearch : public DexDBWrapperListener
+{
+public:
+    WeightedRelationSearch(DexDBWrapper &db);
+    ~WeightedRelationSearch();
+
+    static const int MaxCost;
+
+    int setCost(string relation, dex::gdb::EdgesDirection direction, int cost);
+    void clearCosts();
+    int build();
+
+    int findPath(MemberClass member_1, MemberClass member_2, int &cost, vector<dex::gdb::oid_t> &path);
+    int findWithin(MemberClass member, int limit, vector< pair<dex::gdb::oid_t, int> > &reached);
+
+    void memberAdded(dex::gdb::oid_t member, MemberClass &data);
+    void memberDeleted(dex::gdb::oid_t member);
+    void relationAdded(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head);
+    void relationDeleted(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head);
+    void reset();
+
+private:
+    struct EdgeCost{
+        dex::gdb::type_t type;
+        dex::gdb::EdgesDirection direction;
+        int cost;
+    };
+    struct Arc{
+        int node;
+        int cost;
+    };
+
+    DexDBWrapper &db;
+    bool built;
+    vector<EdgeCost> costs;
+    vector< vector<Arc> > arcs;
+
+    vector<int> distance;
+    vector<int> previous;
+    vector<unsigned int> stamp;
+    unsigned int query;
+    vector< vector<int> > buckets;
+    vector<int> settled;
+
+    int nodeOf(MemberClass &member);
+    int run(int source, int destination, int limit);
+    void grow();
+    void addArcs(dex::gdb::type_t type, int tail, int head);
+    void removeArcs(dex::gdb::type_t type, int tail, int head);
+    static void eraseOne(vector<Arc> &list, int node, int cost);
+};
+
+#endif // WEIGHTEDRELATIONSEARCH_H
@@ -0,0 +1,119 @@
+#include "AhnentafelPedigree.h"
+#include "dex/gdb/Objects.h"
+#include "dex/gdb/ObjectsIterator.h"
+#include <algorithm>
+
+const int AhnentafelPedigree::MaxGenerations = 20;
+
+AhnentafelPedigree::AhnentafelPedigree(DexDBWrapper &db)
+: db(db)
+{
+    roundTrips=0;
+}
+
+const vector<dex::gdb::oid_t> & AhnentafelPedigree::getOids(){
+    return this->oids;
+}
+
+int AhnentafelPedigree::getRoundTrips(){
+    return this->roundTrips;
+}
+
+int AhnentafelPedigree::fetch(MemberClass root, int generations, vector<MemberClass> &pedigree){
+    roundTrips = 0;
+    pedigree.clear();
+    oids.clear();
+    dex::gdb::Graph *graph = db.getGraph();
+    if ((!graph)||(generations < 1)||(generations > MaxGenerations)){
+        return -1;
+    }
+    DexSchema &schema = db.getSchema();
+    dex::gdb::Objects *current = NULL;
+    dex::gdb::Objects *edges = NULL;
+    try{
+        dex::gdb::oid_t oid = db.oidOf(root.getId());
+        if (oid == dex::gdb::Objects::InvalidOID){
+            return -1;
+        }
+        // number 0 stays empty, the numbers fit the array as they are
+        size_t slots = static_cast<size_t>(1) << generations;
+        pedigree.assign(slots, MemberClass());
+        oids.assign(slots, dex::gdb::Objects::InvalidOID);
+        map<dex::gdb::oid_t, MemberClass> read;
+        schema.readMember(graph, oid, read[oid]);
+        pedigree[1] = read[oid];
+        oids[1] = oid;
+
+        Slots slotsOf;
+        slotsOf[oid].push_back(1);
+        current = db.getSession()->NewObjects();
+        current->Add(oid);
+        for (int generation = 1; (generation < generations)&&(!slotsOf.empty()); generation++){
+            edges = graph->Explode(current, schema.getParentType(), dex::gdb::Ingoing);
+            roundTrips++;
+            map<dex::gdb::oid_t, vector<dex::gdb::oid_t> > parentsOf;
+            dex::gdb::ObjectsIterator *it = edges->Iterator();
+            while (it->HasNext()){
+                dex::gdb::EdgeData *data = graph->GetEdgeData(it->Next());
+                parentsOf[data->GetHead()].push_back(data->GetTail());
+                delete data;
+            }
+            delete it;
+            delete edges;
+            edges = NULL;
+
+            Slots next;
+            for (Slots::iterator child = slotsOf.begin(); child != slotsOf.end(); child++){
+                vector<dex::gdb::oid_t> &parents = parentsOf[child->first];
+                // DEX keeps no order, creation order makes the result stable
+                sort(parents.begin(), parents.end());
+                for (size_t s = 0; s < child->second.size(); s++){
+                    for (size_t p = 0; (p < parents.size())&&(p < 2); p++){
+                        place(child->second[s], parents[p], pedigree, read, next);
+                    }
+                }
+            }
+            current->Clear();
+            for (Slots::iterator parent = next.begin(); parent != next.end(); parent++){
+                current->Add(parent->first);
+            }
+            slotsOf.swap(next);
+        }
+        delete current;
+    }catch(dex::gdb::Exception &e){
+        delete edges;
+        delete current;
+        pedigree.clear();
+        oids.clear();
+        return -1;
+    }
+    int found = 0;
+    for (size_t slot = 1; slot < oids.size(); slot++){
+        if (oids[slot] != dex::gdb::Objects::InvalidOID){
+            found++;
+        }
+    }
+    return found;
+}
+
+void AhnentafelPedigree::place(int slot, dex::gdb::oid_t parent, vector<MemberClass> &pedigree, map<dex::gdb::oid_t, MemberClass> &read, Slots &next){
+    map<dex::gdb::oid_t, MemberClass>::iterator member = read.find(parent);
+    if (member == read.end()){
+        member = read.insert(make_pair(parent, MemberClass())).first;
+        db.getSchema().readMember(db.getGraph(), parent, member->second);
+    }
+    int father = 2 * slot;
+    int mother = father + 1;
+    int number;
+    if (member->second.getSex() == female){
+        number = (oids[mother] == dex::gdb::Objects::InvalidOID) ? mother : father;
+    }else{
+        number = (oids[father] == dex::gdb::Objects::InvalidOID) ? father : mother;
+    }
+    if (oids[number] != dex::gdb::Objects::InvalidOID){
+        return;
+    }
+    pedigree[number] = member->second;
+    oids[number] = parent;
+    next[parent].push_back(number);
+}
@@ -0,0 +1,273 @@
+#include "AncestorSketches.h"
+#include "dex/gdb/Objects.h"
+#include <algorithm>
+#include <cmath>
+
+AncestorSketches::AncestorSketches(DexDBWrapper &db)
+: db(db)
+{
+    precision=0;
+    registers=0;
+    exact=false;
+    built=false;
+    pathsDirty=false;
+    setPrecision(10);
+    db.registerListener(*this);
+}
+
+AncestorSketches::~AncestorSketches()
+{
+    db.unregisterListener(*this);
+}
+
+void AncestorSketches::setPrecision(int precision){
+    this->precision = max(4, min(precision, 16));
+    registers = 1 << this->precision;
+    built = false;
+}
+
+void AncestorSketches::setExact(bool exact){
+    this->exact = exact;
+    built = false;
+}
+
+int AncestorSketches::build(){
+    built = false;
+    ParentDag &dag = db.getParentDag();
+    vector<int> nodes;
+    if ((!dag.isBuilt())||(generationOrder(nodes) == -1)){
+        return -1;
+    }
+    int size = dag.size();
+    sketches.clear();
+    ancestors.clear();
+    if (exact){
+        ancestors.assign(size, vector<int>());
+    }else{
+        sketches.assign(static_cast<size_t>(size) * registers, 0);
+    }
+    paths.assign(size, 0.0);
+    for (size_t i = 0; i < nodes.size(); i++){
+        const vector<int> &parents = dag.getParents(nodes[i]);
+        for (size_t p = 0; p < parents.size(); p++){
+            merge(nodes[i], parents[p]);
+            paths[nodes[i]] += 1.0 + paths[parents[p]];
+        }
+    }
+    pathsDirty = false;
+    built = true;
+    return 1;
+}
+
+int AncestorSketches::countAncestors(MemberClass member, double &count){
+    int node = nodeOf(member);
+    if (node == -1){
+        return -1;
+    }
+    count = estimate(node);
+    return 1;
+}
+
+int AncestorSketches::collapseRatio(MemberClass member, double &ratio){
+    int node = nodeOf(member);
+    if (node == -1){
+        return -1;
+    }
+    if (pathsDirty){
+        countPaths();
+    }
+    ratio = (paths[node] > 0.0) ? max(0.0, 1.0 - estimate(node) / paths[node]) : 0.0;
+    return 1;
+}
+
+int AncestorSketches::nodeOf(MemberClass &member){
+    if ((!db.getGraph())||((!built)&&(build() == -1))){
+        return -1;
+    }
+    try{
+        dex::gdb::oid_t oid = db.oidOf(member.getId());
+        if (oid == dex::gdb::Objects::InvalidOID){
+            return -1;
+        }
+        return db.getParentDag().indexOf(oid);
+    }catch(dex::gdb::Exception &e){
+        return -1;
+    }
+}
+
+int AncestorSketches::generationOrder(vector<int> &nodes){
+    // Kahn, parents before children
+    ParentDag &dag = db.getParentDag();
+    int size = dag.size();
+    vector<int> waiting(size, 0);
+    int alive = 0;
+    nodes.clear();
+    for (int node = 0; node < size; node++){
+        if (dag.isAlive(node)){
+            alive++;
+            waiting[node] = static_cast<int>(dag.getParents(node).size());
+            if (waiting[node] == 0){
+                nodes.push_back(node);
+            }
+        }
+    }
+    for (size_t i = 0; i < nodes.size(); i++){
+        const vector<int> &children = dag.getChildren(nodes[i]);
+        for (size_t c = 0; c < children.size(); c++){
+            if (--waiting[children[c]] == 0){
+                nodes.push_back(children[c]);
+            }
+        }
+    }
+    return (static_cast<int>(nodes.size()) == alive) ? 1 : -1;
+}
+
+void AncestorSketches::countPaths(){
+    ParentDag &dag = db.getParentDag();
+    vector<int> nodes;
+    generationOrder(nodes);
+    paths.assign(dag.size(), 0.0);
+    for (size_t i = 0; i < nodes.size(); i++){
+        const vector<int> &parents = dag.getParents(nodes[i]);
+        for (size_t p = 0; p < parents.size(); p++){
+            paths[nodes[i]] += 1.0 + paths[parents[p]];
+        }
+    }
+    pathsDirty = false;
+}
+
+void AncestorSketches::grow(){
+    int size = db.getParentDag().size();
+    if (exact){
+        ancestors.resize(size);
+    }else{
+        sketches.resize(static_cast<size_t>(size) * registers, 0);
+    }
+    paths.resize(size, 0.0);
+}
+
+bool AncestorSketches::insert(int node, int ancestor){
+    if (exact){
+        vector<int> &list = ancestors[node];
+        vector<int>::iterator at = lower_bound(list.begin(), list.end(), ancestor);
+        if ((at != list.end())&&(*at == ancestor)){
+            return false;
+        }
+        list.insert(at, ancestor);
+        return true;
+    }
+    // the first bits pick the register, it keeps the longest run of zeros
+    // seen in the rest
+    unsigned long long bits = hash(db.getParentDag().oidOf(ancestor));
+    int index = static_cast<int>(bits >> (64 - precision));
+    bits <<= precision;
+    unsigned char rank = static_cast<unsigned char>(bits ? __builtin_clzll(bits) + 1 : 64 - precision + 1);
+    unsigned char &cell = sketches[static_cast<size_t>(node) * registers + index];
+    if (cell >= rank){
+        return false;
+    }
+    cell = rank;
+    return true;
+}
+
+bool AncestorSketches::merge(int node, int parent){
+    bool changed = insert(node, parent);
+    if (exact){
+        vector<int> &list = ancestors[node];
+        const vector<int> &from = ancestors[parent];
+        vector<int> joined;
+        joined.reserve(list.size() + from.size());
+        set_union(list.begin(), list.end(), from.begin(), from.end(), back_inserter(joined));
+        if (joined.size() != list.size()){
+            list.swap(joined);
+            changed = true;
+        }
+        return changed;
+    }
+    unsigned char *cells = &sketches[static_cast<size_t>(node) * registers];
+    const unsigned char *source = &sketches[static_cast<size_t>(parent) * registers];
+    for (int i = 0; i < registers; i++){
+        if (source[i] > cells[i]){
+            cells[i] = source[i];
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+double AncestorSketches::estimate(int node){
+    if (exact){
+        return static_cast<double>(ancestors[node].size());
+    }
+    const unsigned char *cells = &sketches[static_cast<size_t>(node) * registers];
+    double sum = 0.0;
+    int zeros = 0;
+    for (int i = 0; i < registers; i++){
+        sum += ldexp(1.0, -cells[i]);
+        if (cells[i] == 0){
+            zeros++;
+        }
+    }
+    double alpha = (registers == 16) ? 0.673 : (registers == 32) ? 0.697 : (registers == 64) ? 0.709 : 0.7213 / (1.0 + 1.079 / registers);
+    double count = alpha * registers * registers / sum;
+    if ((count <= 2.5 * registers)&&(zeros > 0)){
+        // small sets: linear counting on the empty registers
+        count = registers * log(static_cast<double>(registers) / zeros);
+    }
+    return count;
+}
+
+unsigned long long AncestorSketches::hash(dex::gdb::oid_t oid){
+    // splitmix64 finalizer, oids are dense so they need mixing
+    unsigned long long bits = static_cast<unsigned long long>(oid) + 0x9E3779B97F4A7C15ULL;
+    bits = (bits ^ (bits >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    bits = (bits ^ (bits >> 27)) * 0x94D049BB133111EBULL;
+    return bits ^ (bits >> 31);
+}
+
+void AncestorSketches::memberAdded(dex::gdb::oid_t member, MemberClass &data){
+    if (built){
+        grow();
+    }
+}
+
+void AncestorSketches::memberDeleted(dex::gdb::oid_t member){
+    built = false;
+}
+
+void AncestorSketches::relationAdded(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head){
+    if ((!built)||(relation != db.getSchema().getParentType())){
+        return;
+    }
+    ParentDag &dag = db.getParentDag();
+    grow();
+    int parent = dag.indexOf(tail);
+    int child = dag.indexOf(head);
+    if ((parent == -1)||(child == -1)){
+        built = false;
+        return;
+    }
+    pathsDirty = true;
+    if (!merge(child, parent)){
+        return;
+    }
+    vector<int> queue(1, child);
+    for (size_t i = 0; i < queue.size(); i++){
+        const vector<int> &children = dag.getChildren(queue[i]);
+        for (size_t c = 0; c < children.size(); c++){
+            if (merge(children[c], queue[i])){
+                queue.push_back(children[c]);
+            }
+        }
+    }
+}
+
+void AncestorSketches::relationDeleted(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head){
+    if (relation == db.getSchema().getParentType()){
+        built = false;
+    }
+}
+
+void AncestorSketches::reset(){
+    built = false;
+}
@@ -0,0 +1,192 @@
+#include "BidirectionalPathBFS.h"
+#include <algorithm>
+
+BidirectionalPathBFS::BidirectionalPathBFS(dex::gdb::Session &session, dex::gdb::oid_t source, dex::gdb::oid_t destination)
+: session(session)
+{
+    graph=session.GetGraph();
+    this->source=source;
+    this->destination=destination;
+    maxHops=0;
+    found=false;
+    visited=0;
+}
+
+BidirectionalPathBFS::~BidirectionalPathBFS()
+{
+}
+
+void BidirectionalPathBFS::AddEdgeType(dex::gdb::type_t type, dex::gdb::EdgesDirection direction){
+    edgeTypes.push_back(type);
+    directions.push_back(direction);
+}
+
+void BidirectionalPathBFS::AddAllEdgeTypes(dex::gdb::EdgesDirection direction){
+    dex::gdb::TypeList *types = graph->FindEdgeTypes();
+    dex::gdb::TypeListIterator *it = types->Iterator();
+    while (it->HasNext()){
+        AddEdgeType(it->Next(), direction);
+    }
+    delete it;
+    delete types;
+}
+
+void BidirectionalPathBFS::AddNodeType(dex::gdb::type_t type){
+    nodeTypes.push_back(type);
+}
+
+void BidirectionalPathBFS::SetMaximumHops(int hops){
+    this->maxHops = hops;
+}
+
+bool BidirectionalPathBFS::Exists(){
+    return this->found;
+}
+
+double BidirectionalPathBFS::GetCost(){
+    return found ? static_cast<double>(path.size() - 1) : -1.0;
+}
+
+const vector<dex::gdb::oid_t> & BidirectionalPathBFS::GetPathAsNodes(){
+    return this->path;
+}
+
+dex::gdb::int64_t BidirectionalPathBFS::GetVisited(){
+    return this->visited;
+}
+
+void BidirectionalPathBFS::Run(){
+    found = false;
+    path.clear();
+    visited = 0;
+    if (source == destination){
+        found = true;
+        path.assign(1, source);
+        return;
+    }
+    dex::gdb::Objects *allowed = NULL;
+    dex::gdb::Objects *seenSource = NULL;
+    dex::gdb::Objects *seenDestination = NULL;
+    vector<dex::gdb::Objects *> sourceLevels;
+    vector<dex::gdb::Objects *> destinationLevels;
+    try{
+        if (!nodeTypes.empty()){
+            allowed = session.NewObjects();
+            for (size_t i = 0; i < nodeTypes.size(); i++){
+                dex::gdb::Objects *nodes = graph->Select(nodeTypes[i]);
+                allowed->Union(nodes);
+                delete nodes;
+            }
+        }
+        seenSource = session.NewObjects();
+        seenSource->Add(source);
+        seenDestination = session.NewObjects();
+        seenDestination->Add(destination);
+        sourceLevels.push_back(seenSource->Copy());
+        destinationLevels.push_back(seenDestination->Copy());
+
+        for (int hops = 0; (maxHops == 0)||(hops < maxHops); hops++){
+            // the smaller frontier costs less to expand, an empty one
+            // means the two ends are not connected
+            bool forward = (sourceLevels.back()->Count() <= destinationLevels.back()->Count());
+            vector<dex::gdb::Objects *> &levels = forward ? sourceLevels : destinationLevels;
+            dex::gdb::Objects *seen = forward ? seenSource : seenDestination;
+            dex::gdb::Objects *next = expand(levels.back(), forward, seen, allowed);
+            if (next->Count() == 0){
+                delete next;
+                break;
+            }
+            seen->Union(next);
+            levels.push_back(next);
+            dex::gdb::Objects *meet = dex::gdb::Objects::CombineIntersection(next, forward ? seenDestination : seenSource);
+            if (meet->Count() > 0){
+                dex::gdb::oid_t meeting = meet->Any();
+                delete meet;
+                trace(meeting, sourceLevels, destinationLevels);
+                found = true;
+                break;
+            }
+            delete meet;
+        }
+        visited = seenSource->Count() + seenDestination->Count();
+    }catch(dex::gdb::Exception &e){
+        delete allowed;
+        delete seenSource;
+        delete seenDestination;
+        release(sourceLevels);
+        release(destinationLevels);
+        throw;
+    }
+    delete allowed;
+    delete seenSource;
+    delete seenDestination;
+    release(sourceLevels);
+    release(destinationLevels);
+}
+
+dex::gdb::Objects * BidirectionalPathBFS::expand(dex::gdb::Objects *frontier, bool forward, dex::gdb::Objects *seen, dex::gdb::Objects *allowed){
+    dex::gdb::Objects *next = session.NewObjects();
+    for (size_t i = 0; i < edgeTypes.size(); i++){
+        dex::gdb::EdgesDirection direction = forward ? directions[i] : reverse(directions[i]);
+        dex::gdb::Objects *neighbors = graph->Neighbors(frontier, edgeTypes[i], direction);
+        next->Union(neighbors);
+        delete neighbors;
+    }
+    next->Difference(seen);
+    if (allowed){
+        next->Intersection(allowed);
+    }
+    return next;
+}
+
+dex::gdb::oid_t BidirectionalPathBFS::stepBack(dex::gdb::oid_t node, bool forward, dex::gdb::Objects *level){
+    // a neighbour in the previous level over an edge the search could use
+    for (size_t i = 0; i < edgeTypes.size(); i++){
+        dex::gdb::EdgesDirection direction = forward ? reverse(directions[i]) : directions[i];
+        dex::gdb::Objects *neighbors = graph->Neighbors(node, edgeTypes[i], direction);
+        neighbors->Intersection(level);
+        dex::gdb::oid_t previous = (neighbors->Count() > 0) ? neighbors->Any() : dex::gdb::Objects::InvalidOID;
+        delete neighbors;
+        if (previous != dex::gdb::Objects::InvalidOID){
+            return previous;
+        }
+    }
+    return dex::gdb::Objects::InvalidOID;
+}
+
+void BidirectionalPathBFS::trace(dex::gdb::oid_t meeting, vector<dex::gdb::Objects *> &sourceLevels, vector<dex::gdb::Objects *> &destinationLevels){
+    int sourceLevel = 0;
+    while (!sourceLevels[sourceLevel]->Exists(meeting)){
+        sourceLevel++;
+    }
+    int destinationLevel = 0;
+    while (!destinationLevels[destinationLevel]->Exists(meeting)){
+        destinationLevel++;
+    }
+    path.assign(1, meeting);
+    dex::gdb::oid_t node = meeting;
+    for (int level = sourceLevel - 1; level >= 0; level--){
+        node = stepBack(node, true, sourceLevels[level]);
+        path.push_back(node);
+    }
+    std::reverse(path.begin(), path.end());
+    node = meeting;
+    for (int level = destinationLevel - 1; level >= 0; level--){
+        node = stepBack(node, false, destinationLevels[level]);
+        path.push_back(node);
+    }
+}
+
+dex::gdb::EdgesDirection BidirectionalPathBFS::reverse(dex::gdb::EdgesDirection direction){
+    if (direction == dex::gdb::Outgoing){
+        return dex::gdb::Ingoing;
+    }
+    return (direction == dex::gdb::Ingoing) ? dex::gdb::Outgoing : direction;
+}
+
+void BidirectionalPathBFS::release(vector<dex::gdb::Objects *> &levels){
+    for (size_t i = 0; i < levels.size(); i++){
+        delete levels[i];
+    }
+    levels.clear();
+}
@@ -0,0 +1,265 @@
+#include "BufferedRowWriter.h"
+#include "DexSchema.h"
+#include "Utf8Codec.h"
+#include "dex/gdb/Graph_data.h"
+#include <cstdlib>
+#include <cstring>
+
+const size_t BufferedRowWriter::DefaultBufferSize;
+const size_t BufferedRowWriter::BufferAlignment;
+
+BufferedRowWriter::BufferedRowWriter()
+{
+    file=NULL;
+    format=csvFormat;
+    separator=',';
+    bufferSize=DefaultBufferSize;
+    memory=NULL;
+    buffer=NULL;
+    used=0;
+    field=0;
+    written=0;
+}
+
+BufferedRowWriter::~BufferedRowWriter()
+{
+    if (file){
+        try{
+            flush();
+        }catch(dex::gdb::IOException &e){
+        }
+        fclose(file);
+    }
+    free(memory);
+}
+
+void BufferedRowWriter::setFormat(RowFormat format){
+    this->format = format;
+}
+
+void BufferedRowWriter::setSeparator(char separator){
+    this->separator = separator;
+}
+
+void BufferedRowWriter::setBufferSize(size_t size){
+    // only takes effect on the next open()
+    this->bufferSize = (size < BufferAlignment) ? BufferAlignment : size;
+}
+
+dex::gdb::int64_t BufferedRowWriter::getWritten(){
+    return this->written + this->used;
+}
+
+int BufferedRowWriter::open(string path){
+    if (file){
+        flush();
+        fclose(file);
+    }
+    free(memory);
+    memory = static_cast<char *>(malloc(bufferSize + BufferAlignment));
+    if (!memory){
+        file = NULL;
+        return -1;
+    }
+    size_t misalignment = reinterpret_cast<size_t>(memory) % BufferAlignment;
+    buffer = memory + (misalignment ? BufferAlignment - misalignment : 0);
+    used = 0;
+    written = 0;
+
+    file = fopen(path.c_str(), "wb");
+    if (!file){
+        free(memory);
+        memory = NULL;
+        buffer = NULL;
+        return -1;
+    }
+    // the aligned buffer already batches the writes
+    setvbuf(file, NULL, _IONBF, 0);
+    return 1;
+}
+
+void BufferedRowWriter::requireOpen(){
+    // the buffer only exists while a file is open
+    if (!file){
+        throw dex::gdb::IOException("Export file is not open");
+    }
+}
+
+void BufferedRowWriter::flush(){
+    if ((used > 0)&&(file)){
+        if (fwrite(buffer, 1, used, file) != used){
+            used = 0;
+            throw dex::gdb::IOException("Cannot write export file");
+        }
+        written += used;
+        used = 0;
+    }
+}
+
+void BufferedRowWriter::reserve(size_t bytes){
+    if (used + bytes > bufferSize){
+        flush();
+    }
+}
+
+void BufferedRowWriter::put(char c){
+    if (used == bufferSize){
+        flush();
+    }
+    buffer[used++] = c;
+}
+
+void BufferedRowWriter::put(const char *text, size_t length){
+    while (length > 0){
+        if (used == bufferSize){
+            flush();
+        }
+        size_t chunk = bufferSize - used;
+        if (chunk > length){
+            chunk = length;
+        }
+        memcpy(buffer + used, text, chunk);
+        used += chunk;
+        text += chunk;
+        length -= chunk;
+    }
+}
+
+void BufferedRowWriter::putVarint(unsigned long long value){
+    reserve(10);
+    while (value >= 0x80){
+        buffer[used++] = static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    buffer[used++] = static_cast<char>(value);
+}
+
+void BufferedRowWriter::putDecimal(dex::gdb::int64_t value, int width){
+    char digits[24];
+    int length = 0;
+    unsigned long long magnitude = (value < 0) ? 0ULL - static_cast<unsigned long long>(value)
+                                               : static_cast<unsigned long long>(value);
+    do{
+        digits[length++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    }while (magnitude > 0);
+    while (length < width){
+        digits[length++] = '0';
+    }
+
+    reserve(length + 1);
+    if (value < 0){
+        buffer[used++] = '-';
+    }
+    while (length > 0){
+        buffer[used++] = digits[--length];
+    }
+}
+
+void BufferedRowWriter::beginRow(int fields){
+    requireOpen();
+    field = 0;
+    if (format == binaryFormat){
+        putVarint(static_cast<unsigned long long>(fields));
+    }
+}
+
+void BufferedRowWriter::endRow(){
+    requireOpen();
+    if (format == csvFormat){
+        put('\n');
+    }
+}
+
+void BufferedRowWriter::beginField(FieldTag tag){
+    requireOpen();
+    if (format == binaryFormat){
+        put(static_cast<char>(tag));
+    }else if (field > 0){
+        put(separator);
+    }
+    field++;
+}
+
+void BufferedRowWriter::putQuoted(const char *text, size_t length){
+    bool quote = false;
+    for (size_t i = 0; (i < length)&&(!quote); i++){
+        quote = (text[i] == separator)||(text[i] == '"')||(text[i] == '\n')||(text[i] == '\r');
+    }
+    if (!quote){
+        put(text, length);
+        return;
+    }
+    put('"');
+    for (size_t i = 0; i < length; i++){
+        if (text[i] == '"'){
+            put('"');
+        }
+        put(text[i]);
+    }
+    put('"');
+}
+
+void BufferedRowWriter::addNull(){
+    beginField(nullField);
+}
+
+void BufferedRowWriter::addString(const wstring &text){
+    encoded.clear();
+    Utf8Codec::encode(text, encoded);
+    addUtf8(encoded.data(), encoded.size());
+}
+
+void BufferedRowWriter::addUtf8(const char *text, size_t length){
+    beginField(stringField);
+    if (format == binaryFormat){
+        putVarint(length);
+        put(text, length);
+    }else{
+        putQuoted(text, length);
+    }
+}
+
+void BufferedRowWriter::addInteger(dex::gdb::int64_t value){
+    beginField(integerField);
+    if (format == binaryFormat){
+        putVarint((static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63));
+    }else{
+        putDecimal(value, 1);
+    }
+}
+
+void BufferedRowWriter::addDate(dex::gdb::int64_t timestamp){
+    beginField(timestampField);
+    if (format == binaryFormat){
+        putVarint((static_cast<unsigned long long>(timestamp) << 1) ^ static_cast<unsigned long long>(timestamp >> 63));
+        return;
+    }
+    int year, month, day;
+    DexSchema::dateOf(timestamp, year, month, day);
+    putDecimal(year, 4);
+    put('-');
+    putDecimal(month, 2);
+    put('-');
+    putDecimal(day, 2);
+}
+
+void BufferedRowWriter::Write(dex::gdb::StringList &row)
+throw(dex::gdb::IOException, dex::gdb::Error){
+    beginRow(row.Count());
+    dex::gdb::StringListIterator *it = row.Iterator();
+    while (it->HasNext()){
+        addString(it->Next());
+    }
+    delete it;
+    endRow();
+}
+
+void BufferedRowWriter::Close()
+throw(dex::gdb::IOException, dex::gdb::Error){
+    if (file){
+        flush();
+        fclose(file);
+        file = NULL;
+    }
+}
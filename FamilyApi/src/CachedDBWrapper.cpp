@@ -0,0 +1,430 @@
+#include "CachedDBWrapper.h"
+#include <algorithm>
+
+const int CachedDBWrapper::Stripes = 4096;
+const dex::gdb::int64_t CachedDBWrapper::Roster = -1;
+
+CachedDBWrapper::CachedDBWrapper(DexDBWrapper &db, size_t capacity)
+: db(db)
+{
+    this->capacity = max(capacity, static_cast<size_t>(1));
+    bytes = 0;
+    epochs.assign(Stripes, 0);
+    stats.hits = 0;
+    stats.misses = 0;
+    stats.stale = 0;
+    stats.evictions = 0;
+    stats.entries = 0;
+    stats.bytes = 0;
+    db.registerListener(*this);
+}
+
+CachedDBWrapper::~CachedDBWrapper()
+{
+    db.unregisterListener(*this);
+}
+
+int CachedDBWrapper::Connect(DBConnectionInf infClass){
+    return db.Connect(infClass);
+}
+
+int CachedDBWrapper::Initiate(){
+    return db.Initiate();
+}
+
+int CachedDBWrapper::addMember(MemberClass member){
+    return db.addMember(member);
+}
+
+int CachedDBWrapper::delMember(MemberClass member){
+    // the edges go with the member unannounced, so whoever they led to is
+    // collected first and bumped once the wrapper reports the deletion
+    deleting.clear();
+    dex::gdb::Graph *graph = db.getGraph();
+    if (graph){
+        try{
+            dex::gdb::oid_t oid = db.oidOf(member.getId());
+            if (oid != dex::gdb::Objects::InvalidOID){
+                MemberClass data;
+                db.getSchema().readMember(graph, oid, data);
+                deleting.push_back(oid);
+                deleting.push_back(nameKey(data.getName()));
+                // the family before it is split, the rebuilt ones get
+                // new roots or this one
+                dex::gdb::oid_t family = db.getFamilyComponents().familyOf(oid);
+                if (family != dex::gdb::Objects::InvalidOID){
+                    deleting.push_back(family);
+                }
+                ParentDag &dag = db.getParentDag();
+                int node = dag.indexOf(oid);
+                if (node != -1){
+                    const vector<int> &parents = dag.getParents(node);
+                    for (size_t i = 0; i < parents.size(); i++){
+                        deleting.push_back(dag.oidOf(parents[i]));
+                    }
+                    const vector<int> &children = dag.getChildren(node);
+                    for (size_t i = 0; i < children.size(); i++){
+                        deleting.push_back(dag.oidOf(children[i]));
+                    }
+                }
+            }
+        }catch(dex::gdb::Exception &e){
+            deleting.clear();
+        }
+    }
+    int result = db.delMember(member);
+    deleting.clear();
+    return result;
+}
+
+int CachedDBWrapper::addRelation(string relation){
+    return db.addRelation(relation);
+}
+
+int CachedDBWrapper::delRelation(string relation){
+    return db.delRelation(relation);
+}
+
+int CachedDBWrapper::addRelationTo(string relation, MemberClass member_1, MemberClass member_2){
+    return db.addRelationTo(relation, member_1, member_2);
+}
+
+int CachedDBWrapper::delRelationTo(string relation, MemberClass member_1, MemberClass member_2){
+    return db.delRelationTo(relation, member_1, member_2);
+}
+
+int CachedDBWrapper::findMember(MemberClass member){
+    // one index lookup, nothing to save
+    return db.findMember(member);
+}
+
+int CachedDBWrapper::findByName(MemberClass member){
+    return cached(ByName, member, NULL);
+}
+
+int CachedDBWrapper::findChildren(MemberClass member){
+    return cached(Children, member, NULL);
+}
+
+int CachedDBWrapper::findRealation(MemberClass member_1, MemberClass member_2){
+    return cached(Realation, member_1, &member_2);
+}
+
+int CachedDBWrapper::findSiblings(MemberClass member){
+    return cached(Siblings, member, NULL);
+}
+
+int CachedDBWrapper::findHalfSiblings(MemberClass member){
+    return cached(HalfSiblings, member, NULL);
+}
+
+int CachedDBWrapper::findStepRelatives(MemberClass member){
+    return cached(StepRelatives, member, NULL);
+}
+
+int CachedDBWrapper::isAncestor(MemberClass ancestor, MemberClass member){
+    return cached(Ancestor, ancestor, &member);
+}
+
+int CachedDBWrapper::isSameFamily(MemberClass member_1, MemberClass member_2){
+    return cached(SameFamily, member_1, &member_2);
+}
+
+int CachedDBWrapper::findFamilySize(MemberClass member){
+    return cached(FamilySize, member, NULL);
+}
+
+void CachedDBWrapper::getStats(CacheStats &stats){
+    stats = this->stats;
+    stats.entries = entries.size();
+    stats.bytes = bytes + epochs.size() * sizeof(unsigned int);
+}
+
+void CachedDBWrapper::clear(){
+    entries.clear();
+    index.clear();
+    bytes = 0;
+}
+
+int CachedDBWrapper::cached(Query query, MemberClass &member_1, MemberClass *member_2){
+    string key = keyOf(query, member_1, member_2);
+    map<string, list<Entry>::iterator>::iterator found = index.find(key);
+    if (found != index.end()){
+        list<Entry>::iterator entry = found->second;
+        bool fresh = true;
+        for (size_t i = 0; (fresh)&&(i < entry->depends.size()); i++){
+            fresh = isFresh(entry->depends[i]);
+        }
+        if (fresh){
+            stats.hits++;
+            entries.splice(entries.begin(), entries, entry);
+            return entry->result;
+        }
+        stats.stale++;
+        drop(entry);
+    }
+    stats.misses++;
+    int result = run(query, member_1, member_2);
+    if (result == -1){
+        return result;
+    }
+    Entry entry;
+    entry.key = key;
+    entry.result = result;
+    if (dependencies(query, member_1, member_2, entry.depends)){
+        store(entry);
+    }
+    return result;
+}
+
+int CachedDBWrapper::run(Query query, MemberClass &member_1, MemberClass *member_2){
+    switch (query){
+    case ByName:
+        return db.findByName(member_1);
+    case Children:
+        return db.findChildren(member_1);
+    case Realation:
+        return db.findRealation(member_1, *member_2);
+    case Siblings:
+        return db.findSiblings(member_1);
+    case HalfSiblings:
+        return db.findHalfSiblings(member_1);
+    case StepRelatives:
+        return db.findStepRelatives(member_1);
+    case Ancestor:
+        return db.isAncestor(member_1, *member_2);
+    case SameFamily:
+        return db.isSameFamily(member_1, *member_2);
+    default:
+        return db.findFamilySize(member_1);
+    }
+}
+
+bool CachedDBWrapper::dependencies(Query query, MemberClass &member_1, MemberClass *member_2, vector<Epoch> &depends){
+    switch (query){
+    case ByName:
+        // a name only ever narrows to name and surname
+        depends.push_back(epochOf(nameKey(member_1.getName())));
+        return true;
+    case Children:
+        return addMemberDependency(member_1, false, depends);
+    case Siblings:
+    case HalfSiblings:
+        // a new child of a parent bumps the parent
+        return addMemberDependency(member_1, true, depends);
+    case StepRelatives:
+        // partners named by partnerId may be in another family
+        depends.push_back(epochOf(Roster));
+        return addPartnerDependencies(member_1, depends);
+    default:
+        // paths, ancestry and family size never leave the families
+        try{
+            if (!addFamilyDependency(db.oidOf(member_1.getId()), depends)){
+                return false;
+            }
+            return (!member_2)||(addFamilyDependency(db.oidOf(member_2->getId()), depends));
+        }catch(dex::gdb::Exception &e){
+            return false;
+        }
+    }
+}
+
+bool CachedDBWrapper::addMemberDependency(MemberClass &member, bool parents, vector<Epoch> &depends){
+    try{
+        dex::gdb::oid_t oid = db.oidOf(member.getId());
+        if (oid == dex::gdb::Objects::InvalidOID){
+            return false;
+        }
+        depends.push_back(epochOf(oid));
+        if (parents){
+            ParentDag &dag = db.getParentDag();
+            int node = dag.indexOf(oid);
+            if (node == -1){
+                return false;
+            }
+            const vector<int> &up = dag.getParents(node);
+            for (size_t i = 0; i < up.size(); i++){
+                depends.push_back(epochOf(dag.oidOf(up[i])));
+            }
+        }
+    }catch(dex::gdb::Exception &e){
+        return false;
+    }
+    return true;
+}
+
+bool CachedDBWrapper::addFamilyDependency(dex::gdb::oid_t member, vector<Epoch> &depends){
+    dex::gdb::oid_t family = db.getFamilyComponents().familyOf(member);
+    if (family == dex::gdb::Objects::InvalidOID){
+        return false;
+    }
+    Epoch epoch = epochOf(family);
+    epoch.member = member;
+    depends.push_back(epoch);
+    return true;
+}
+
+bool CachedDBWrapper::addPartnerDependencies(MemberClass &member, vector<Epoch> &depends){
+    // the member's family, and the families of the partners the member and
+    // the parents name by partnerId
+    try{
+        dex::gdb::Graph *graph = db.getGraph();
+        DexSchema &schema = db.getSchema();
+        dex::gdb::oid_t oid = db.oidOf(member.getId());
+        if (!addFamilyDependency(oid, depends)){
+            return false;
+        }
+        ParentDag &dag = db.getParentDag();
+        int node = dag.indexOf(oid);
+        if (node == -1){
+            return false;
+        }
+        vector<dex::gdb::oid_t> named(1, oid);
+        const vector<int> &parents = dag.getParents(node);
+        for (size_t i = 0; i < parents.size(); i++){
+            named.push_back(dag.oidOf(parents[i]));
+        }
+        dex::gdb::Value value;
+        for (size_t i = 0; i < named.size(); i++){
+            graph->GetAttribute(named[i], schema.getPartnerIdAttr(), value);
+            if ((value.IsNull())||(value.GetLong() == 0)){
+                continue;
+            }
+            dex::gdb::oid_t partner = db.oidOf(static_cast<unsigned int>(value.GetLong()));
+            if ((partner != dex::gdb::Objects::InvalidOID)&&(!addFamilyDependency(partner, depends))){
+                return false;
+            }
+        }
+    }catch(dex::gdb::Exception &e){
+        return false;
+    }
+    return true;
+}
+
+bool CachedDBWrapper::isFresh(const Epoch &epoch){
+    // a family merged into another or rebuilt has a new root
+    if ((epoch.member != dex::gdb::Objects::InvalidOID)&&(db.getFamilyComponents().familyOf(epoch.member) != epoch.key)){
+        return false;
+    }
+    return stripe(epoch.key) == epoch.epoch;
+}
+
+CachedDBWrapper::Epoch CachedDBWrapper::epochOf(dex::gdb::int64_t key){
+    Epoch epoch;
+    epoch.member = dex::gdb::Objects::InvalidOID;
+    epoch.key = key;
+    epoch.epoch = stripe(key);
+    return epoch;
+}
+
+unsigned int & CachedDBWrapper::stripe(dex::gdb::int64_t key){
+    // Fibonacci hashing, oids and name keys are far from uniform
+    unsigned long long mixed = static_cast<unsigned long long>(key) * 11400714819323198485ULL;
+    return epochs[static_cast<size_t>(mixed >> 52) % epochs.size()];
+}
+
+void CachedDBWrapper::bump(dex::gdb::int64_t key){
+    stripe(key)++;
+}
+
+void CachedDBWrapper::bumpFamily(dex::gdb::oid_t member){
+    dex::gdb::oid_t family = db.getFamilyComponents().familyOf(member);
+    if (family != dex::gdb::Objects::InvalidOID){
+        bump(family);
+    }
+}
+
+void CachedDBWrapper::store(Entry &entry){
+    entries.push_front(entry);
+    index[entry.key] = entries.begin();
+    bytes += sizeOf(entry);
+    while (entries.size() > capacity){
+        list<Entry>::iterator last = entries.end();
+        drop(--last);
+        stats.evictions++;
+    }
+}
+
+void CachedDBWrapper::drop(list<Entry>::iterator entry){
+    bytes -= sizeOf(*entry);
+    index.erase(entry->key);
+    entries.erase(entry);
+}
+
+string CachedDBWrapper::keyOf(Query query, MemberClass &member_1, MemberClass *member_2){
+    string key(1, static_cast<char>(query));
+    if (query == ByName){
+        key += member_1.getName();
+        key += '\0';
+        key += member_1.getSurname();
+        return key;
+    }
+    unsigned int id = member_1.getId();
+    key.append(reinterpret_cast<const char *>(&id), sizeof(id));
+    if (member_2){
+        id = member_2->getId();
+        key.append(reinterpret_cast<const char *>(&id), sizeof(id));
+    }
+    return key;
+}
+
+dex::gdb::int64_t CachedDBWrapper::nameKey(const string &name){
+    return Roster - 1 - static_cast<dex::gdb::int64_t>(hash(name) >> 2);
+}
+
+unsigned long long CachedDBWrapper::hash(const string &text){
+    // FNV-1a
+    unsigned long long value = 14695981039346656037ULL;
+    for (size_t i = 0; i < text.size(); i++){
+        value ^= static_cast<unsigned char>(text[i]);
+        value *= 1099511628211ULL;
+    }
+    return value;
+}
+
+size_t CachedDBWrapper::sizeOf(const Entry &entry){
+    // the key is held by the entry and by the index, plus the two nodes
+    return sizeof(Entry) + 2 * entry.key.size() + entry.depends.size() * sizeof(Epoch)
+        + sizeof(string) + sizeof(list<Entry>::iterator) + 6 * sizeof(void *);
+}
+
+void CachedDBWrapper::memberAdded(dex::gdb::oid_t member, MemberClass &data){
+    bump(nameKey(data.getName()));
+    bump(Roster);
+}
+
+void CachedDBWrapper::memberDeleted(dex::gdb::oid_t member){
+    bump(Roster);
+    if ((deleting.empty())||(deleting[0] != member)){
+        // deleted behind the cache, the neighbours are not known any more
+        clear();
+        return;
+    }
+    for (size_t i = 0; i < deleting.size(); i++){
+        bump(deleting[i]);
+    }
+}
+
+void CachedDBWrapper::relationAdded(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head){
+    // FamilyComponents has already merged the two families, the entries of
+    // the one that lost its root see a new root, the other is bumped
+    bump(tail);
+    bump(head);
+    bumpFamily(tail);
+    bumpFamily(head);
+}
+
+void CachedDBWrapper::relationDeleted(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head){
+    // every member of the split family ends up in the family of tail or of
+    // head, either under a new root or under a bumped one
+    bump(tail);
+    bump(head);
+    bumpFamily(tail);
+    bumpFamily(head);
+}
+
+void CachedDBWrapper::reset(){
+    clear();
+    // nothing refers to the old epochs once the entries are gone
+    epochs.assign(Stripes, 0);
+}
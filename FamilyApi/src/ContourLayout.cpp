@@ -0,0 +1,236 @@
+#include "ContourLayout.h"
+#include <algorithm>
+#include <cmath>
+
+ContourLayout::ContourLayout()
+{
+    gap=1.0;
+}
+
+void ContourLayout::setGap(double gap){
+    this->gap = gap;
+}
+
+int ContourLayout::size(){
+    return static_cast<int>(parent.size());
+}
+
+bool ContourLayout::isAlive(int node){
+    return (node >= 0)&&(node < size())&&(alive[node]);
+}
+
+int ContourLayout::getParent(int node){
+    return parent[node];
+}
+
+const vector<int> & ContourLayout::getChildren(int node){
+    return children[node];
+}
+
+int ContourLayout::getDepth(int node){
+    return depth[node];
+}
+
+double ContourLayout::getOffset(int node){
+    return offset[node];
+}
+
+double ContourLayout::getX(int node){
+    double x = 0.0;
+    for (; node != -1; node = parent[node]){
+        x += offset[node];
+    }
+    return x;
+}
+
+const vector<int> & ContourLayout::getMoved(){
+    return this->moved;
+}
+
+void ContourLayout::build(const vector<int> &parent, const vector<double> &width){
+    // breadth first order as for TreeLayout, so going backwards places
+    // every child before its parent
+    int nodes = static_cast<int>(parent.size());
+    this->parent = parent;
+    this->width = width;
+    children.assign(nodes, vector<int>());
+    depth.assign(nodes, 0);
+    offset.assign(nodes, 0.0);
+    alive.assign(nodes, true);
+    dirty.assign(nodes, 0);
+    left.assign(nodes, vector<double>());
+    right.assign(nodes, vector<double>());
+    pending.clear();
+    moved.clear();
+    for (int node = 1; node < nodes; node++){
+        children[parent[node]].push_back(node);
+        depth[node] = depth[parent[node]] + 1;
+    }
+    for (int node = nodes - 1; node >= 0; node--){
+        place(node);
+    }
+    moved.clear();
+}
+
+// push_back on a full vector of vectors copies every row in C++98, this
+// moves them instead
+template <class T> static void appendRow(vector< vector<T> > &rows){
+    if (rows.size() == rows.capacity()){
+        vector< vector<T> > bigger;
+        bigger.reserve(rows.size() * 2 + 16);
+        bigger.resize(rows.size());
+        for (size_t i = 0; i < rows.size(); i++){
+            bigger[i].swap(rows[i]);
+        }
+        rows.swap(bigger);
+    }
+    rows.push_back(vector<T>());
+}
+
+int ContourLayout::addNode(int parent, int index, double width){
+    int node = size();
+    this->parent.push_back(parent);
+    appendRow(children);
+    depth.push_back((parent == -1) ? 0 : depth[parent] + 1);
+    this->width.push_back(width);
+    offset.push_back(0.0);
+    alive.push_back(true);
+    dirty.push_back(0);
+    appendRow(left);
+    appendRow(right);
+    if (parent != -1){
+        vector<int> &siblings = children[parent];
+        index = max(0, min(index, static_cast<int>(siblings.size())));
+        siblings.insert(siblings.begin() + index, node);
+    }
+    markDirty(node);
+    return node;
+}
+
+void ContourLayout::removeSubtree(int node){
+    if (!isAlive(node)){
+        return;
+    }
+    int up = parent[node];
+    if (up != -1){
+        vector<int> &siblings = children[up];
+        siblings.erase(find(siblings.begin(), siblings.end(), node));
+        markDirty(up);
+    }
+    vector<int> stack(1, node);
+    while (!stack.empty()){
+        int next = stack.back();
+        stack.pop_back();
+        alive[next] = false;
+        stack.insert(stack.end(), children[next].begin(), children[next].end());
+        children[next].clear();
+        left[next].clear();
+        right[next].clear();
+    }
+}
+
+void ContourLayout::setWidth(int node, double width){
+    if ((isAlive(node))&&(this->width[node] != width)){
+        this->width[node] = width;
+        markDirty(node);
+    }
+}
+
+void ContourLayout::markDirty(int node){
+    for (; (node != -1)&&(!dirty[node]); node = parent[node]){
+        dirty[node] = 1;
+        pending.push_back(node);
+    }
+}
+
+static bool deeper(const pair<int, int> &a, const pair<int, int> &b){
+    return a.first > b.first;
+}
+
+void ContourLayout::update(){
+    moved.clear();
+    vector< pair<int, int> > order;
+    order.reserve(pending.size());
+    for (size_t i = 0; i < pending.size(); i++){
+        dirty[pending[i]] = 0;
+        if (alive[pending[i]]){
+            order.push_back(make_pair(depth[pending[i]], pending[i]));
+        }
+    }
+    pending.clear();
+    stable_sort(order.begin(), order.end(), deeper);
+    for (size_t i = 0; i < order.size(); i++){
+        place(order[i].second);
+    }
+}
+
+void ContourLayout::place(int node){
+    vector<int> &kids = children[node];
+    left[node].assign(1, -width[node] / 2.0);
+    right[node].assign(1, width[node] / 2.0);
+    int count = static_cast<int>(kids.size());
+    if (count == 0){
+        return;
+    }
+
+    // children row first, positions relative to the first child. forest is
+    // the right contour of the children placed so far, owner tells which
+    // child each level of it belongs to.
+    position.assign(count, 0.0);
+    shift.assign(count, 0.0);
+    change.assign(count, 0.0);
+    forest = right[kids[0]];
+    owner.assign(forest.size(), 0);
+    for (int i = 1; i < count; i++){
+        const vector<double> &inner = left[kids[i]];
+        position[i] = position[i - 1] + right[kids[i - 1]][0] - inner[0] + gap;
+        size_t levels = min(forest.size(), inner.size());
+        for (size_t level = 1; level < levels; level++){
+            double overlap = forest[level] - (inner[level] + position[i]) + gap;
+            if (overlap > 0){
+                // the smaller siblings in between get their share below
+                int from = owner[level];
+                position[i] += overlap;
+                shift[i] += overlap;
+                change[i] -= overlap / (i - from);
+                change[from] += overlap / (i - from);
+            }
+        }
+        const vector<double> &outer = right[kids[i]];
+        for (size_t level = 0; level < outer.size(); level++){
+            if (level < forest.size()){
+                forest[level] = outer[level] + position[i];
+                owner[level] = i;
+            }else{
+                forest.push_back(outer[level] + position[i]);
+                owner.push_back(i);
+            }
+        }
+    }
+    double spread = 0.0, rate = 0.0;
+    for (int i = count - 1; i >= 0; i--){
+        position[i] += spread;
+        rate += change[i];
+        spread += shift[i] + rate;
+    }
+
+    // centred over the children, the contours follow from theirs
+    double middle = (position[0] + position[count - 1]) / 2.0;
+    for (int i = 0; i < count; i++){
+        double before = offset[kids[i]];
+        offset[kids[i]] = position[i] - middle;
+        if (fabs(offset[kids[i]] - before) > 1e-9){
+            moved.push_back(kids[i]);
+        }
+        const vector<double> &outer = left[kids[i]];
+        for (size_t level = left[node].size() - 1; level < outer.size(); level++){
+            left[node].push_back(outer[level] + offset[kids[i]]);
+        }
+    }
+    for (int i = count - 1; i >= 0; i--){
+        const vector<double> &outer = right[kids[i]];
+        for (size_t level = right[node].size() - 1; level < outer.size(); level++){
+            right[node].push_back(outer[level] + offset[kids[i]]);
+        }
+    }
+}
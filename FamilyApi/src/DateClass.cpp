@@ -45,14 +45,14 @@ int DateClass::getNumberOfDaysInMonth(Months mon){
         return 28;
     }
 
-    if (mon < 6){
+    if (mon < 7){
         if (mon%2 == 0){
             return 31;
         }else{
             return 30;
         }
     }else{
-        int tmp =mon-6;
+        int tmp =mon-7;
         if (tmp%2 == 0){
             return 31;
         }else{
@@ -106,7 +106,7 @@ int DateClass::setMin(int min){
 }
 
 int DateClass::setHour(int hour){
-    if(validRange(sec,24)){
+    if(validRange(hour,24)){
         this->hour = hour;
         return dateOk;
     }else{
@@ -116,7 +116,7 @@ int DateClass::setHour(int hour){
 
 int DateClass::setMday(int day){
     if ((this->year != -1)&&(this->mon != -1)){
-        if(validRange(sec,getNumberOfDaysInMonth(this->mon))){
+        if(validRange(day-1,getNumberOfDaysInMonth(this->mon))){
             this->mday = day;
             return dateOk;
         }else{
@@ -153,14 +153,24 @@ int DateClass::setWday(){
         int y = tyear%100;
         int c = tyear/100;
 
-        this->wday =static_cast<Days>((this->mday + (int)(2.6 * tmon - 0.2) + y + y/4 + c/4 - 2*c)%7);
-
+        // 0 is Sunday in this formula, Days starts with Monday
+        int sundayBased = ((this->mday + (int)(2.6 * tmon - 0.2) + y + y/4 + c/4 - 2*c)%7 + 7)%7;
+        this->wday =static_cast<Days>((sundayBased + 6)%7);
+        return dateOk;
     }
-    return -1;
+    return badWday;
 }
 
 int DateClass::setYday(){
-    return -1;
+    if ((this->year != -1)&&(this->mon != -1)&&(this->mday != -1)){
+        int days = this->mday - 1;
+        for (int month = January; month < this->mon; month++){
+            days += getNumberOfDaysInMonth(static_cast<Months>(month));
+        }
+        this->yday = days;
+        return dateOk;
+    }
+    return badYday;
 }
 
 int DateClass::setDate(tm date, string &cause){
@@ -169,10 +179,8 @@ int DateClass::setDate(tm date, string &cause){
     causeCode |= this->setSec(date.tm_sec);
     causeCode |= this->setMin(date.tm_min);
     causeCode |= this->setHour(date.tm_hour);
-    causeCode |= this->setMday(date.tm_mday);
-    causeCode |= this->setMday(date.tm_mday);
-    causeCode |= this->setMon(static_cast<Months>(date.tm_mon));
     causeCode |= this->setYear(date.tm_year);
+    causeCode |= this->setMon(static_cast<Months>(date.tm_mon));
     causeCode |= this->setMday(date.tm_mday);
     causeCode |= this->setWday();
     causeCode |= this->setYday();
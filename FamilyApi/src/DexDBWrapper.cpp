@@ -1,45 +1,790 @@
 #include "DexDBWrapper.h"
+#include "Utf8Codec.h"
+#include "dex/gdb/Objects.h"
+#include "dex/gdb/ObjectsIterator.h"
+#include "BidirectionalPathBFS.h"
+#include <cstdio>
+#include <algorithm>
+
+using namespace dex::gdb;
 
 DexDBWrapper::DexDBWrapper()
+: ancestry(dag), order(dag), families(dag), kinship(dag, order)
+{
+	registerListener(ancestry);
+	registerListener(order);
+	registerListener(families);
+	registerListener(kinship);
+	dex=NULL;
+	db=NULL;
+	sess=NULL;
+	graph=NULL;
+}
+
+DexDBWrapper::~DexDBWrapper()
 {
+	disconnect();
+}
+
+void DexDBWrapper::disconnect(){
+	dag.attach(NULL, NULL);
+	memberIds.attach(NULL, NULL);
+	memberOids.clear();
+	families.attach(NULL);
+	delete sess;
+	delete db;
+	delete dex;
+	sess=NULL;
+	db=NULL;
+	dex=NULL;
+	graph=NULL;
 }
 
 int DexDBWrapper::Connect(DBConnectionInf infClass){
-	return 0;
+	// DEX is embedded, the database name is the path of the image file
+	wstring path = Utf8Codec::decode(infClass.getDbName());
+	if (path.empty()){
+		return -1;
+	}
+	disconnect();
+	try{
+		DexConfig config;
+		config.SetRecoveryEnabled(true);
+		dex = new Dex(config);
+
+		FILE *image = fopen(infClass.getDbName().c_str(), "rb");
+		if (image){
+			fclose(image);
+			db = dex->Open(path, false);
+		}else{
+			db = dex->Create(path, path);
+		}
+		sess = db->NewSession();
+		graph = sess->GetGraph();
+	}catch(Exception &e){
+		disconnect();
+		return -1;
+	}
+	return 1;
 }
 int DexDBWrapper::Initiate(){
-	return 0;
+	if (!graph){
+		return -1;
+	}
+	try{
+		if (schema.create(graph) == -1){
+			return -1;
+		}
+	}catch(Exception &e){
+		return -1;
+	}
+	dag.attach(graph, &schema);
+	memberIds.attach(graph, &schema);
+	memberOids.clear();
+	families.attach(graph);
+	resetIndexes();
+	return 1;
 }
 
 int DexDBWrapper::addMember(MemberClass member){
-	return 0;
+	if (!graph){
+		return -1;
+	}
+	try{
+		if (memberOid(member) != Objects::InvalidOID){
+			return -1;
+		}
+		oid_t oid = graph->NewNode(schema.getMemberType());
+		schema.writeMember(graph, oid, member);
+		memberAdded(oid, member);
+	}catch(Exception &e){
+		return -1;
+	}
+	return 1;
 }
 int DexDBWrapper::delMember(MemberClass member){
-	return 0;
+	if (!graph){
+		return -1;
+	}
+	try{
+		oid_t oid = memberOid(member);
+		if (oid == Objects::InvalidOID){
+			return -1;
+		}
+		memberDeleting(oid);
+		graph->Drop(oid);
+		memberIds.remove(member.getId());
+		memberOids.erase(member.getId());
+		memberDeleted(oid);
+	}catch(Exception &e){
+		return -1;
+	}
+	return 1;
 }
 
 int DexDBWrapper::addRelation(string relation){
-	return 0;
+	if (!graph){
+		return -1;
+	}
+	try{
+		wstring name = Utf8Codec::decode(relation);
+		if (schema.findRelation(graph, name) != Type::InvalidType){
+			return -1;
+		}
+		schema.createRelation(graph, name);
+	}catch(Exception &e){
+		return -1;
+	}
+	return 1;
 }
 int DexDBWrapper::delRelation(string relation){
-	return 0;
+	if (!graph){
+		return -1;
+	}
+	try{
+		type_t type = schema.findRelation(graph, Utf8Codec::decode(relation));
+		if ((type == Type::InvalidType)||(type == schema.getParentType())||(type == schema.getPartnerType())){
+			return -1;
+		}
+		graph->RemoveType(type);
+		// the edges went with the type without passing through here
+		resetIndexes();
+	}catch(Exception &e){
+		return -1;
+	}
+	return 1;
 }
 int DexDBWrapper::addRelationTo(string relation, MemberClass member_1, MemberClass member_2){
-	return 0;
+	if (!graph){
+		return -1;
+	}
+	try{
+		type_t type = schema.findRelation(graph, Utf8Codec::decode(relation));
+		oid_t tail = memberOid(member_1);
+		oid_t head = memberOid(member_2);
+		if ((type == Type::InvalidType)||(tail == Objects::InvalidOID)||(head == Objects::InvalidOID)){
+			return -1;
+		}
+		// nobody may become their own ancestor
+		if ((type == schema.getParentType())&&(order.insertEdge(tail, head) != 1)){
+			return -1;
+		}
+		graph->NewEdge(type, tail, head);
+		relationAdded(type, tail, head);
+	}catch(Exception &e){
+		return -1;
+	}
+	return 1;
 }
 int DexDBWrapper::delRelationTo(string relation, MemberClass member_1, MemberClass member_2){
-	return 0;
+	if (!graph){
+		return -1;
+	}
+	try{
+		type_t type = schema.findRelation(graph, Utf8Codec::decode(relation));
+		oid_t tail = memberOid(member_1);
+		oid_t head = memberOid(member_2);
+		if ((type == Type::InvalidType)||(tail == Objects::InvalidOID)||(head == Objects::InvalidOID)){
+			return -1;
+		}
+		oid_t edge = graph->FindEdge(type, tail, head);
+		if (edge == Objects::InvalidOID){
+			return -1;
+		}
+		graph->Drop(edge);
+		relationDeleted(type, tail, head);
+	}catch(Exception &e){
+		return -1;
+	}
+	return 1;
 }
 
 int DexDBWrapper::findMember(MemberClass member){
-	return 0;
+	if (!graph){
+		return -1;
+	}
+	try{
+		return (memberOid(member) != Objects::InvalidOID) ? 1 : 0;
+	}catch(Exception &e){
+		return -1;
+	}
 }
 int DexDBWrapper::findByName(MemberClass member){
-	return 0;
+	if (!graph){
+		return -1;
+	}
+	try{
+		Objects *found = selectByName(member);
+		int count = static_cast<int>(found->Count());
+		delete found;
+		return count;
+	}catch(Exception &e){
+		return -1;
+	}
 }
 int DexDBWrapper::findChildren(MemberClass member){
-	return 0;
+	if (!graph){
+		return -1;
+	}
+	try{
+		oid_t oid = memberOid(member);
+		if (oid == Objects::InvalidOID){
+			return -1;
+		}
+		Objects *children = graph->Neighbors(oid, schema.getParentType(), Outgoing);
+		int count = static_cast<int>(children->Count());
+		delete children;
+		return count;
+	}catch(Exception &e){
+		return -1;
+	}
 }
 int DexDBWrapper::findRealation(MemberClass member_1, MemberClass member_2){
-	return 0;
+	if (!graph){
+		return -1;
+	}
+	try{
+		oid_t source = memberOid(member_1);
+		oid_t destination = memberOid(member_2);
+		if ((source == Objects::InvalidOID)||(destination == Objects::InvalidOID)){
+			return -1;
+		}
+		BidirectionalPathBFS bfs(*sess, source, destination);
+		bfs.AddAllEdgeTypes(Any);
+		bfs.AddNodeType(schema.getMemberType());
+		bfs.Run();
+		return bfs.Exists() ? static_cast<int>(bfs.GetCost()) : 0;
+	}catch(Exception &e){
+		return -1;
+	}
+}
+
+int DexDBWrapper::findSiblings(MemberClass member){
+	return findKin(member, Siblings, NULL);
+}
+int DexDBWrapper::findSiblings(MemberClass member, vector<MemberClass> &siblings){
+	return findKin(member, Siblings, &siblings);
+}
+int DexDBWrapper::findHalfSiblings(MemberClass member){
+	return findKin(member, HalfSiblings, NULL);
+}
+int DexDBWrapper::findHalfSiblings(MemberClass member, vector<MemberClass> &siblings){
+	return findKin(member, HalfSiblings, &siblings);
+}
+int DexDBWrapper::findStepRelatives(MemberClass member){
+	return findKin(member, StepRelatives, NULL);
+}
+int DexDBWrapper::findStepRelatives(MemberClass member, vector<MemberClass> &relatives){
+	return findKin(member, StepRelatives, &relatives);
+}
+
+int DexDBWrapper::findKin(MemberClass &member, Kin kin, vector<MemberClass> *members){
+	if (members){
+		members->clear();
+	}
+	if (!graph){
+		return -1;
+	}
+	Objects *found = NULL;
+	try{
+		oid_t oid = memberOid(member);
+		if (oid == Objects::InvalidOID){
+			return -1;
+		}
+		found = kinOf(oid, kin);
+		int count = static_cast<int>(found->Count());
+		if (members){
+			members->resize(count);
+			ObjectsIterator *it = found->Iterator();
+			for (int i = 0; it->HasNext(); i++){
+				schema.readMember(graph, it->Next(), (*members)[i]);
+			}
+			delete it;
+		}
+		delete found;
+		return count;
+	}catch(Exception &e){
+		delete found;
+		if (members){
+			members->clear();
+		}
+		return -1;
+	}
+}
+
+int DexDBWrapper::openChildren(MemberClass member, MemberCursor &cursor){
+	cursor.close();
+	if (!graph){
+		return -1;
+	}
+	try{
+		oid_t oid = memberOid(member);
+		if (oid == Objects::InvalidOID){
+			return -1;
+		}
+		cursor.open(graph, &schema, graph->Neighbors(oid, schema.getParentType(), Outgoing));
+		return static_cast<int>(cursor.count());
+	}catch(Exception &e){
+		cursor.close();
+		return -1;
+	}
+}
+int DexDBWrapper::openByName(MemberClass member, MemberCursor &cursor){
+	cursor.close();
+	if (!graph){
+		return -1;
+	}
+	try{
+		cursor.open(graph, &schema, selectByName(member));
+		return static_cast<int>(cursor.count());
+	}catch(Exception &e){
+		cursor.close();
+		return -1;
+	}
+}
+int DexDBWrapper::openSiblings(MemberClass member, MemberCursor &cursor){
+	return openKin(member, Siblings, cursor);
+}
+int DexDBWrapper::openHalfSiblings(MemberClass member, MemberCursor &cursor){
+	return openKin(member, HalfSiblings, cursor);
+}
+int DexDBWrapper::openStepRelatives(MemberClass member, MemberCursor &cursor){
+	return openKin(member, StepRelatives, cursor);
+}
+
+int DexDBWrapper::openKin(MemberClass &member, Kin kin, MemberCursor &cursor){
+	cursor.close();
+	if (!graph){
+		return -1;
+	}
+	try{
+		oid_t oid = memberOid(member);
+		if (oid == Objects::InvalidOID){
+			return -1;
+		}
+		cursor.open(graph, &schema, kinOf(oid, kin));
+		return static_cast<int>(cursor.count());
+	}catch(Exception &e){
+		cursor.close();
+		return -1;
+	}
+}
+
+Objects * DexDBWrapper::selectByName(MemberClass &member){
+	Value value;
+	Objects *found = graph->Select(schema.getNameAttr(), Equal, value.SetString(Utf8Codec::decode(member.getName())));
+	if (!member.getSurname().empty()){
+		Objects *surnames = graph->Select(schema.getSurnameAttr(), Equal, value.SetString(Utf8Codec::decode(member.getSurname())));
+		found->Intersection(surnames);
+		delete surnames;
+	}
+	return found;
+}
+
+Objects * DexDBWrapper::kinOf(oid_t oid, Kin kin){
+	// one expansion to the parents, the rest is set algebra on them
+	Objects *parents = graph->Neighbors(oid, schema.getParentType(), Ingoing);
+	Objects *found = NULL;
+	try{
+		if (kin == Siblings){
+			found = fullSiblingsOf(parents);
+		}else if (kin == HalfSiblings){
+			found = halfSiblingsOf(parents);
+		}else{
+			found = stepRelativesOf(oid, parents);
+		}
+		found->Remove(oid);
+	}catch(Exception &e){
+		delete found;
+		delete parents;
+		throw;
+	}
+	delete parents;
+	return found;
+}
+
+Objects * DexDBWrapper::fullSiblingsOf(Objects *parents){
+	// the children every known parent has in common
+	Objects *siblings = NULL;
+	ObjectsIterator *it = parents->Iterator();
+	while (it->HasNext()){
+		Objects *children = graph->Neighbors(it->Next(), schema.getParentType(), Outgoing);
+		if (!siblings){
+			siblings = children;
+			continue;
+		}
+		Objects *common = Objects::CombineIntersection(siblings, children);
+		delete siblings;
+		delete children;
+		siblings = common;
+	}
+	delete it;
+	return siblings ? siblings : sess->NewObjects();
+}
+
+Objects * DexDBWrapper::halfSiblingsOf(Objects *parents){
+	Objects *children = graph->Neighbors(parents, schema.getParentType(), Outgoing);
+	Objects *full = fullSiblingsOf(parents);
+	Objects *half = Objects::CombineDifference(children, full);
+	delete full;
+	delete children;
+	return half;
+}
+
+Objects * DexDBWrapper::stepRelativesOf(oid_t oid, Objects *parents){
+	// partners of the parents who are not parents themselves, their
+	// children who are no child of a parent, and the children of the
+	// member's own partners who are not the member's
+	Objects *stepParents = partnersOf(parents);
+	stepParents->Difference(parents);
+	Objects *relatives = graph->Neighbors(stepParents, schema.getParentType(), Outgoing);
+	Objects *siblings = graph->Neighbors(parents, schema.getParentType(), Outgoing);
+	relatives->Difference(siblings);
+	relatives->Union(stepParents);
+	delete siblings;
+	delete stepParents;
+
+	Objects *self = sess->NewObjects();
+	self->Add(oid);
+	Objects *partners = partnersOf(self);
+	Objects *stepChildren = graph->Neighbors(partners, schema.getParentType(), Outgoing);
+	Objects *children = graph->Neighbors(oid, schema.getParentType(), Outgoing);
+	stepChildren->Difference(children);
+	relatives->Union(stepChildren);
+	delete children;
+	delete stepChildren;
+	delete partners;
+	delete self;
+	return relatives;
+}
+
+Objects * DexDBWrapper::partnersOf(Objects *members){
+	// partner edges either way, plus the partnerId a member was stored with
+	Objects *partners = graph->Neighbors(members, schema.getPartnerType(), Any);
+	ObjectsIterator *it = members->Iterator();
+	while (it->HasNext()){
+		unsigned int id = partnerIdOf(it->Next());
+		if (id != 0){
+			oid_t partner = oidOf(id);
+			if (partner != Objects::InvalidOID){
+				partners->Add(partner);
+			}
+		}
+	}
+	delete it;
+	return partners;
+}
+
+int DexDBWrapper::visitMembers(MemberVisitor &visitor){
+	if (!graph){
+		return -1;
+	}
+	Objects *members = NULL;
+	try{
+		members = graph->Select(schema.getMemberType());
+		int visited = visitSet(members, visitor);
+		delete members;
+		return visited;
+	}catch(Exception &e){
+		delete members;
+		return -1;
+	}
+}
+int DexDBWrapper::visitChildren(MemberClass member, MemberVisitor &visitor){
+	if (!graph){
+		return -1;
+	}
+	Objects *children = NULL;
+	try{
+		oid_t oid = memberOid(member);
+		if (oid == Objects::InvalidOID){
+			return -1;
+		}
+		children = graph->Neighbors(oid, schema.getParentType(), Outgoing);
+		int visited = visitSet(children, visitor);
+		delete children;
+		return visited;
+	}catch(Exception &e){
+		delete children;
+		return -1;
+	}
+}
+int DexDBWrapper::visitByName(MemberClass member, MemberVisitor &visitor){
+	if (!graph){
+		return -1;
+	}
+	Objects *found = NULL;
+	try{
+		found = selectByName(member);
+		int visited = visitSet(found, visitor);
+		delete found;
+		return visited;
+	}catch(Exception &e){
+		delete found;
+		return -1;
+	}
+}
+int DexDBWrapper::visitDescendants(MemberClass member, MemberVisitor &visitor){
+	return visitLine(member, true, visitor);
+}
+int DexDBWrapper::visitAncestors(MemberClass member, MemberVisitor &visitor){
+	return visitLine(member, false, visitor);
+}
+
+int DexDBWrapper::visitSet(Objects *members, MemberVisitor &visitor){
+	MemberView view(graph, &schema);
+	int visited = 0;
+	ObjectsIterator *it = members->Iterator();
+	try{
+		while (it->HasNext()){
+			view.moveTo(it->Next());
+			visited++;
+			if (!visitor.visit(view)){
+				break;
+			}
+		}
+	}catch(Exception &e){
+		delete it;
+		throw;
+	}
+	delete it;
+	return visited;
+}
+
+int DexDBWrapper::visitLine(MemberClass &member, bool down, MemberVisitor &visitor){
+	if (!graph){
+		return -1;
+	}
+	try{
+		int start = getParentDag().indexOf(memberOid(member));
+		if (start == -1){
+			return -1;
+		}
+		// breadth first over the in-memory dag, nearest generations first
+		MemberView view(graph, &schema);
+		vector<bool> seen(dag.size(), false);
+		vector<int> queue(1, start);
+		seen[start] = true;
+		for (size_t i = 0; i < queue.size(); i++){
+			const vector<int> &next = down ? dag.getChildren(queue[i]) : dag.getParents(queue[i]);
+			for (size_t n = 0; n < next.size(); n++){
+				if (seen[next[n]]){
+					continue;
+				}
+				seen[next[n]] = true;
+				queue.push_back(next[n]);
+				view.moveTo(dag.oidOf(next[n]));
+				if (!visitor.visit(view)){
+					return static_cast<int>(queue.size()) - 1;
+				}
+			}
+		}
+		return static_cast<int>(queue.size()) - 1;
+	}catch(Exception &e){
+		return -1;
+	}
+}
+
+int DexDBWrapper::isAncestor(MemberClass ancestor, MemberClass member){
+	if (!graph){
+		return -1;
+	}
+	try{
+		oid_t tail = memberOid(ancestor);
+		oid_t head = memberOid(member);
+		if ((tail == Objects::InvalidOID)||(head == Objects::InvalidOID)){
+			return -1;
+		}
+		return this->ancestry.isAncestor(tail, head);
+	}catch(Exception &e){
+		return -1;
+	}
+}
+
+int DexDBWrapper::isSameFamily(MemberClass member_1, MemberClass member_2){
+	if (!graph){
+		return -1;
+	}
+	try{
+		oid_t oid_1 = memberOid(member_1);
+		oid_t oid_2 = memberOid(member_2);
+		if ((oid_1 == Objects::InvalidOID)||(oid_2 == Objects::InvalidOID)){
+			return -1;
+		}
+		return this->families.sameFamily(oid_1, oid_2);
+	}catch(Exception &e){
+		return -1;
+	}
+}
+int DexDBWrapper::findFamilySize(MemberClass member){
+	if (!graph){
+		return -1;
+	}
+	try{
+		oid_t oid = memberOid(member);
+		if (oid == Objects::InvalidOID){
+			return -1;
+		}
+		return this->families.familySize(oid);
+	}catch(Exception &e){
+		return -1;
+	}
+}
+
+int DexDBWrapper::findKinship(MemberClass member_1, MemberClass member_2, double &coefficient){
+	if (!graph){
+		return -1;
+	}
+	try{
+		oid_t oid_1 = memberOid(member_1);
+		oid_t oid_2 = memberOid(member_2);
+		if ((oid_1 == Objects::InvalidOID)||(oid_2 == Objects::InvalidOID)){
+			return -1;
+		}
+		return this->kinship.kinship(oid_1, oid_2, coefficient);
+	}catch(Exception &e){
+		return -1;
+	}
+}
+
+int DexDBWrapper::findInbreeding(MemberClass member, double &coefficient){
+	if (!graph){
+		return -1;
+	}
+	try{
+		oid_t oid = memberOid(member);
+		if (oid == Objects::InvalidOID){
+			return -1;
+		}
+		return this->kinship.inbreeding(oid, coefficient);
+	}catch(Exception &e){
+		return -1;
+	}
+}
+
+Session * DexDBWrapper::getSession(){
+	return this->sess;
+}
+
+Graph * DexDBWrapper::getGraph(){
+	return this->graph;
+}
+
+DexSchema & DexDBWrapper::getSchema(){
+	return this->schema;
+}
+
+ParentDag & DexDBWrapper::getParentDag(){
+	dag.build();
+	return this->dag;
+}
+
+MemberFilter & DexDBWrapper::getMemberIds(){
+	return this->memberIds;
+}
+
+ReachabilityIndex & DexDBWrapper::getAncestry(){
+	return this->ancestry;
+}
+
+TopologicalOrder & DexDBWrapper::getOrder(){
+	return this->order;
+}
+
+FamilyComponents & DexDBWrapper::getFamilyComponents(){
+	return this->families;
+}
+
+KinshipCoefficients & DexDBWrapper::getKinship(){
+	return this->kinship;
+}
+
+void DexDBWrapper::registerListener(DexDBWrapperListener &listener){
+	listeners.push_back(&listener);
+}
+
+void DexDBWrapper::unregisterListener(DexDBWrapperListener &listener){
+	listeners.erase(remove(listeners.begin(), listeners.end(), &listener), listeners.end());
+}
+
+void DexDBWrapper::resetIndexes(){
+	dag.clear();
+	memberIds.clear();
+	memberOids.clear();
+	for (size_t i = 0; i < listeners.size(); i++){
+		listeners[i]->reset();
+	}
+}
+
+oid_t DexDBWrapper::memberOid(MemberClass &member){
+	return oidOf(member.getId());
+}
+
+oid_t DexDBWrapper::oidOf(unsigned int id){
+	if (!graph){
+		return Objects::InvalidOID;
+	}
+	oid_t oid = memberOids.find(id);
+	if (oid != Objects::InvalidOID){
+		return oid;
+	}
+	// most ids asked for during an import are not there yet
+	if (memberIds.mayContain(id) == 0){
+		return Objects::InvalidOID;
+	}
+	oid = schema.findMember(graph, id);
+	if (oid != Objects::InvalidOID){
+		memberOids.put(id, oid);
+	}
+	return oid;
+}
+
+unsigned int DexDBWrapper::partnerIdOf(oid_t member){
+	Value value;
+	graph->GetAttribute(member, schema.getPartnerIdAttr(), value);
+	return value.IsNull() ? 0 : static_cast<unsigned int>(value.GetLong());
+}
+
+void DexDBWrapper::memberAdded(oid_t oid, MemberClass &member){
+	if (dag.isBuilt()){
+		dag.addNode(oid);
+	}
+	memberIds.insert(member.getId());
+	memberOids.put(member.getId(), oid);
+	for (size_t i = 0; i < listeners.size(); i++){
+		listeners[i]->memberAdded(oid, member);
+	}
+}
+
+void DexDBWrapper::memberDeleting(oid_t oid){
+	for (size_t i = 0; i < listeners.size(); i++){
+		listeners[i]->memberDeleting(oid);
+	}
+}
+
+void DexDBWrapper::memberDeleted(oid_t oid){
+	if (dag.isBuilt()){
+		dag.removeNode(dag.indexOf(oid));
+	}
+	for (size_t i = 0; i < listeners.size(); i++){
+		listeners[i]->memberDeleted(oid);
+	}
+}
+
+void DexDBWrapper::relationAdded(type_t type, oid_t tail, oid_t head){
+	if ((dag.isBuilt())&&(type == schema.getParentType())){
+		dag.addEdge(dag.indexOf(tail), dag.indexOf(head));
+	}
+	for (size_t i = 0; i < listeners.size(); i++){
+		listeners[i]->relationAdded(type, tail, head);
+	}
+}
+
+void DexDBWrapper::relationDeleted(type_t type, oid_t tail, oid_t head){
+	if ((dag.isBuilt())&&(type == schema.getParentType())){
+		dag.removeEdge(dag.indexOf(tail), dag.indexOf(head));
+	}
+	for (size_t i = 0; i < listeners.size(); i++){
+		listeners[i]->relationDeleted(type, tail, head);
+	}
 }
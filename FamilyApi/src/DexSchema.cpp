@@ -0,0 +1,259 @@
+#include "DexSchema.h"
+#include "Utf8Codec.h"
+
+using dex::gdb::Graph;
+using dex::gdb::Value;
+using dex::gdb::Type;
+using dex::gdb::Attribute;
+using dex::gdb::type_t;
+using dex::gdb::attr_t;
+using dex::gdb::oid_t;
+using dex::gdb::Long;
+using dex::gdb::String;
+using dex::gdb::Integer;
+using dex::gdb::Timestamp;
+using dex::gdb::Basic;
+using dex::gdb::Indexed;
+using dex::gdb::Unique;
+
+const wstring DexSchema::MemberTypeName = L"member";
+const wstring DexSchema::ParentRelationName = L"parent";
+const wstring DexSchema::PartnerRelationName = L"partner";
+
+static const dex::gdb::int64_t MillisecondsPerDay = 86400000LL;
+
+DexSchema::DexSchema()
+{
+    memberType = parentType = partnerType = Type::InvalidType;
+    idAttr = nameAttr = surnameAttr = sexAttr = Attribute::InvalidAttribute;
+    birthAttr = heavenAttr = partnerIdAttr = Attribute::InvalidAttribute;
+}
+
+int DexSchema::load(Graph *graph){
+    memberType = graph->FindType(MemberTypeName);
+    parentType = graph->FindType(ParentRelationName);
+    partnerType = graph->FindType(PartnerRelationName);
+    if ((memberType == Type::InvalidType)||(parentType == Type::InvalidType)||(partnerType == Type::InvalidType)){
+        return -1;
+    }
+
+    idAttr = graph->FindAttribute(memberType, L"id");
+    nameAttr = graph->FindAttribute(memberType, L"name");
+    surnameAttr = graph->FindAttribute(memberType, L"surname");
+    sexAttr = graph->FindAttribute(memberType, L"sex");
+    birthAttr = graph->FindAttribute(memberType, L"birth");
+    heavenAttr = graph->FindAttribute(memberType, L"heaven");
+    partnerIdAttr = graph->FindAttribute(memberType, L"partnerId");
+    if ((idAttr == Attribute::InvalidAttribute)||(nameAttr == Attribute::InvalidAttribute)
+            ||(surnameAttr == Attribute::InvalidAttribute)||(sexAttr == Attribute::InvalidAttribute)
+            ||(birthAttr == Attribute::InvalidAttribute)||(heavenAttr == Attribute::InvalidAttribute)
+            ||(partnerIdAttr == Attribute::InvalidAttribute)){
+        return -1;
+    }
+    return 1;
+}
+
+int DexSchema::create(Graph *graph){
+    if (load(graph) == 1){
+        return 1;
+    }
+
+    if (graph->FindType(MemberTypeName) == Type::InvalidType){
+        memberType = graph->NewNodeType(MemberTypeName);
+        graph->NewAttribute(memberType, L"id", Long, Unique);
+        graph->NewAttribute(memberType, L"name", String, Indexed);
+        graph->NewAttribute(memberType, L"surname", String, Indexed);
+        graph->NewAttribute(memberType, L"sex", Integer, Indexed);
+        graph->NewAttribute(memberType, L"birth", Timestamp, Indexed);
+        graph->NewAttribute(memberType, L"heaven", Timestamp, Indexed);
+        graph->NewAttribute(memberType, L"partnerId", Long, Basic);
+    }
+    createRelation(graph, ParentRelationName);
+    createRelation(graph, PartnerRelationName);
+
+    return load(graph);
+}
+
+type_t DexSchema::getMemberType(){
+    return this->memberType;
+}
+
+type_t DexSchema::getParentType(){
+    return this->parentType;
+}
+
+type_t DexSchema::getPartnerType(){
+    return this->partnerType;
+}
+
+attr_t DexSchema::getIdAttr(){
+    return this->idAttr;
+}
+
+attr_t DexSchema::getNameAttr(){
+    return this->nameAttr;
+}
+
+attr_t DexSchema::getSurnameAttr(){
+    return this->surnameAttr;
+}
+
+attr_t DexSchema::getSexAttr(){
+    return this->sexAttr;
+}
+
+attr_t DexSchema::getBirthAttr(){
+    return this->birthAttr;
+}
+
+attr_t DexSchema::getHeavenAttr(){
+    return this->heavenAttr;
+}
+
+attr_t DexSchema::getPartnerIdAttr(){
+    return this->partnerIdAttr;
+}
+
+type_t DexSchema::findRelation(Graph *graph, const wstring &relation){
+    return graph->FindType(relation);
+}
+
+type_t DexSchema::createRelation(Graph *graph, const wstring &relation){
+    type_t type = graph->FindType(relation);
+    if (type == Type::InvalidType){
+        // relations are always read from both ends, keep the neighbor index
+        type = graph->NewEdgeType(relation, true, true);
+    }
+    return type;
+}
+
+oid_t DexSchema::findMember(Graph *graph, unsigned int id){
+    Value value;
+    return graph->FindObject(idAttr, value.SetLong(id));
+}
+
+void DexSchema::writeMember(Graph *graph, oid_t oid, MemberClass &member){
+    Value value;
+
+    graph->SetAttribute(oid, idAttr, value.SetLong(member.getId()));
+    graph->SetAttribute(oid, nameAttr, value.SetString(Utf8Codec::decode(member.getName())));
+    graph->SetAttribute(oid, surnameAttr, value.SetString(Utf8Codec::decode(member.getSurname())));
+    graph->SetAttribute(oid, sexAttr, value.SetInteger(member.getSex()));
+
+    DateClass birthDate = member.getBirthDate();
+    toTimestamp(birthDate, value);
+    graph->SetAttribute(oid, birthAttr, value);
+
+    DateClass heavenDate = member.getHeavenDate();
+    toTimestamp(heavenDate, value);
+    graph->SetAttribute(oid, heavenAttr, value);
+
+    graph->SetAttribute(oid, partnerIdAttr, value.SetLong(member.getPartnerId()));
+}
+
+void DexSchema::readMember(Graph *graph, oid_t oid, MemberClass &member){
+    Value value;
+
+    graph->GetAttribute(oid, idAttr, value);
+    member.setId(value.IsNull() ? 0 : static_cast<unsigned int>(value.GetLong()));
+    graph->GetAttribute(oid, nameAttr, value);
+    member.setName(value.IsNull() ? "" : Utf8Codec::encode(value.GetString()));
+    graph->GetAttribute(oid, surnameAttr, value);
+    member.setSurname(value.IsNull() ? "" : Utf8Codec::encode(value.GetString()));
+    graph->GetAttribute(oid, sexAttr, value);
+    member.setSex(value.IsNull() ? nn : static_cast<Sex>(value.GetInteger()));
+
+    DateClass birthDate;
+    graph->GetAttribute(oid, birthAttr, value);
+    toDate(value, birthDate);
+    member.setBirthDate(birthDate);
+
+    DateClass heavenDate;
+    graph->GetAttribute(oid, heavenAttr, value);
+    toDate(value, heavenDate);
+    member.setHeavenDate(heavenDate);
+
+    graph->GetAttribute(oid, partnerIdAttr, value);
+    member.setPartnerId(value.IsNull() ? 0 : static_cast<unsigned int>(value.GetLong()));
+}
+
+void DexSchema::toTimestamp(DateClass &date, Value &value){
+    if (date.getYear() == -1){
+        value.SetNull();
+        return;
+    }
+    int month = (date.getMon() == -1) ? 1 : date.getMon() + 1;
+    int day = (date.getMday() == -1) ? 1 : date.getMday();
+    dex::gdb::int64_t ms = daysFromCivil(date.getYear(), month, day) * MillisecondsPerDay;
+    if (date.getHour() != -1){
+        ms += ((date.getHour() * 60LL + date.getMin()) * 60LL + date.getSec()) * 1000LL;
+    }
+    value.SetTimestamp(ms);
+}
+
+void DexSchema::toDate(const Value &value, DateClass &date){
+    if (value.IsNull()){
+        return;
+    }
+    dex::gdb::int64_t ms = value.GetTimestamp();
+    dex::gdb::int64_t days = ms / MillisecondsPerDay;
+    if (ms % MillisecondsPerDay < 0){
+        days--;
+    }
+    dex::gdb::int64_t rest = (ms - days * MillisecondsPerDay) / 1000;
+
+    tm time;
+    int year, month, day;
+    civilFromDays(days, year, month, day);
+    time.tm_year = year;
+    time.tm_mon = month - 1;
+    time.tm_mday = day;
+    time.tm_hour = static_cast<int>(rest / 3600);
+    time.tm_min = static_cast<int>((rest / 60) % 60);
+    time.tm_sec = static_cast<int>(rest % 60);
+    time.tm_wday = time.tm_yday = time.tm_isdst = 0;
+
+    string cause;
+    date.setDate(time, cause);
+}
+
+dex::gdb::int64_t DexSchema::timestampOf(int year, int month, int day){
+    return daysFromCivil(year, month, day) * MillisecondsPerDay;
+}
+
+int DexSchema::yearOf(dex::gdb::int64_t timestamp){
+    int year, month, day;
+    dateOf(timestamp, year, month, day);
+    return year;
+}
+
+void DexSchema::dateOf(dex::gdb::int64_t timestamp, int &year, int &month, int &day){
+    dex::gdb::int64_t days = timestamp / MillisecondsPerDay;
+    if (timestamp % MillisecondsPerDay < 0){
+        days--;
+    }
+    civilFromDays(days, year, month, day);
+}
+
+// proleptic Gregorian calendar, days counted from 1970-01-01
+dex::gdb::int64_t DexSchema::daysFromCivil(int year, int month, int day){
+    dex::gdb::int64_t y = (month <= 2) ? year - 1 : year;
+    dex::gdb::int64_t era = (y >= 0 ? y : y - 399) / 400;
+    dex::gdb::int64_t yoe = y - era * 400;
+    dex::gdb::int64_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    dex::gdb::int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+void DexSchema::civilFromDays(dex::gdb::int64_t days, int &year, int &month, int &day){
+    dex::gdb::int64_t z = days + 719468;
+    dex::gdb::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    dex::gdb::int64_t doe = z - era * 146097;
+    dex::gdb::int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    dex::gdb::int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    dex::gdb::int64_t mp = (5 * doy + 2) / 153;
+
+    day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    year = static_cast<int>(yoe + era * 400 + (month <= 2 ? 1 : 0));
+}
@@ -0,0 +1,345 @@
+#include "FamilyAggregates.h"
+#include "dex/gdb/Objects.h"
+#include <algorithm>
+
+const int FamilyAggregates::Unknown = -1;
+
+FamilyAggregates::FamilyAggregates(DexDBWrapper &db)
+: db(db)
+{
+    built=false;
+    dirty=false;
+    deleting=-1;
+    db.registerListener(*this);
+}
+
+FamilyAggregates::~FamilyAggregates()
+{
+    db.unregisterListener(*this);
+}
+
+int FamilyAggregates::build(){
+    built = false;
+    records.clear();
+    surnames.clear();
+    decades.clear();
+    generationCounts.clear();
+    lifespanSums.clear();
+    lifespanCounts.clear();
+    if (!db.getGraph()){
+        return -1;
+    }
+    ParentDag &dag = db.getParentDag();
+    if (!dag.isBuilt()){
+        return -1;
+    }
+    grow();
+    try{
+        for (int node = 0; node < dag.size(); node++){
+            if (dag.isAlive(node)){
+                MemberClass data;
+                db.getSchema().readMember(db.getGraph(), dag.oidOf(node), data);
+                count(node, data);
+            }
+        }
+    }catch(dex::gdb::Exception &e){
+        records.clear();
+        return -1;
+    }
+    recount();
+    built = true;
+    return 1;
+}
+
+int FamilyAggregates::countSurname(string surname){
+    if (!ready()){
+        return -1;
+    }
+    map<string, int>::iterator found = surnames.find(surname);
+    return (found == surnames.end()) ? 0 : found->second;
+}
+
+int FamilyAggregates::countDecade(int decade){
+    if (!ready()){
+        return -1;
+    }
+    map<int, int>::iterator found = decades.find(decade);
+    return (found == decades.end()) ? 0 : found->second;
+}
+
+int FamilyAggregates::countGeneration(int generation){
+    if (!ready()){
+        return -1;
+    }
+    return ((generation >= 0)&&(generation < static_cast<int>(generationCounts.size()))) ? generationCounts[generation] : 0;
+}
+
+int FamilyAggregates::generations(){
+    if (!ready()){
+        return -1;
+    }
+    int last = static_cast<int>(generationCounts.size());
+    while ((last > 0)&&(generationCounts[last - 1] == 0)){
+        last--;
+    }
+    return last;
+}
+
+int FamilyAggregates::averageLifespan(int generation, double &years){
+    if (!ready()){
+        return -1;
+    }
+    if ((generation < 0)||(generation >= static_cast<int>(lifespanCounts.size()))||(lifespanCounts[generation] == 0)){
+        return 0;
+    }
+    years = lifespanSums[generation] / lifespanCounts[generation];
+    return 1;
+}
+
+const map<string, int> & FamilyAggregates::getSurnames(){
+    ready();
+    return this->surnames;
+}
+
+const map<int, int> & FamilyAggregates::getDecades(){
+    ready();
+    return this->decades;
+}
+
+bool FamilyAggregates::ready(){
+    if ((!db.getGraph())||((!built)&&(build() == -1))){
+        return false;
+    }
+    if (dirty){
+        recount();
+    }
+    return true;
+}
+
+void FamilyAggregates::count(int node, MemberClass &data){
+    Record &record = records[node];
+    record.surname = data.getSurname();
+    int birth = data.getBirthDate().getYear();
+    int heaven = data.getHeavenDate().getYear();
+    // decades by their first year, also before year 0
+    record.decade = (birth == -1) ? Unknown : ((birth >= 0) ? birth : birth - 9) / 10 * 10;
+    record.lifespan = ((birth != -1)&&(heaven != -1)&&(heaven >= birth)) ? heaven - birth : Unknown;
+    record.generation = 0;
+    record.counted = true;
+    if (!record.surname.empty()){
+        surnames[record.surname]++;
+    }
+    if (record.decade != Unknown){
+        decades[record.decade]++;
+    }
+    addToGeneration(node, 1);
+}
+
+void FamilyAggregates::uncount(int node){
+    Record &record = records[node];
+    if (!record.surname.empty()){
+        decrement(surnames, record.surname);
+    }
+    if (record.decade != Unknown){
+        decrement(decades, record.decade);
+    }
+    addToGeneration(node, -1);
+    record.counted = false;
+}
+
+void FamilyAggregates::addToGeneration(int node, int sign){
+    Record &record = records[node];
+    size_t generation = static_cast<size_t>(record.generation);
+    if (generationCounts.size() <= generation){
+        generationCounts.resize(generation + 1, 0);
+        lifespanSums.resize(generation + 1, 0.0);
+        lifespanCounts.resize(generation + 1, 0);
+    }
+    generationCounts[generation] += sign;
+    if (record.lifespan != Unknown){
+        lifespanSums[generation] += sign * record.lifespan;
+        lifespanCounts[generation] += sign;
+    }
+}
+
+void FamilyAggregates::place(int node, int generation){
+    addToGeneration(node, -1);
+    records[node].generation = generation;
+    addToGeneration(node, 1);
+}
+
+void FamilyAggregates::settle(vector<int> &queue){
+    // carry a move down until the generations agree with the parents again
+    ParentDag &dag = db.getParentDag();
+    for (size_t i = 0; i < queue.size(); i++){
+        const vector<int> &children = dag.getChildren(queue[i]);
+        for (size_t c = 0; c < children.size(); c++){
+            int depth = depthOf(children[c]);
+            if (depth != records[children[c]].generation){
+                place(children[c], depth);
+                queue.push_back(children[c]);
+            }
+        }
+    }
+}
+
+int FamilyAggregates::depthOf(int node){
+    const vector<int> &parents = db.getParentDag().getParents(node);
+    int depth = 0;
+    for (size_t p = 0; p < parents.size(); p++){
+        depth = max(depth, records[parents[p]].generation + 1);
+    }
+    return depth;
+}
+
+void FamilyAggregates::recount(){
+    // drop the deleted members, then generations again in parents-first order
+    ParentDag &dag = db.getParentDag();
+    int size = dag.size();
+    vector<int> waiting(size, 0);
+    vector<int> nodes;
+    for (int node = 0; node < size; node++){
+        if ((records[node].counted)&&(!dag.isAlive(node))){
+            uncount(node);
+        }
+        if (dag.isAlive(node)){
+            waiting[node] = static_cast<int>(dag.getParents(node).size());
+            if (waiting[node] == 0){
+                nodes.push_back(node);
+            }
+        }
+    }
+    generationCounts.clear();
+    lifespanSums.clear();
+    lifespanCounts.clear();
+    for (size_t i = 0; i < nodes.size(); i++){
+        records[nodes[i]].generation = depthOf(nodes[i]);
+        addToGeneration(nodes[i], 1);
+        const vector<int> &children = dag.getChildren(nodes[i]);
+        for (size_t c = 0; c < children.size(); c++){
+            if (--waiting[children[c]] == 0){
+                nodes.push_back(children[c]);
+            }
+        }
+    }
+    dirty = false;
+}
+
+void FamilyAggregates::grow(){
+    Record blank;
+    blank.counted = false;
+    blank.decade = Unknown;
+    blank.lifespan = Unknown;
+    blank.generation = 0;
+    records.resize(db.getParentDag().size(), blank);
+}
+
+void FamilyAggregates::decrement(map<string, int> &counts, const string &key){
+    map<string, int>::iterator found = counts.find(key);
+    if ((found != counts.end())&&(--found->second == 0)){
+        counts.erase(found);
+    }
+}
+
+void FamilyAggregates::decrement(map<int, int> &counts, int key){
+    map<int, int>::iterator found = counts.find(key);
+    if ((found != counts.end())&&(--found->second == 0)){
+        counts.erase(found);
+    }
+}
+
+void FamilyAggregates::memberAdded(dex::gdb::oid_t member, MemberClass &data){
+    if (!built){
+        return;
+    }
+    ParentDag &dag = db.getParentDag();
+    grow();
+    int node = dag.indexOf(member);
+    if (node == -1){
+        built = false;
+        return;
+    }
+    count(node, data);
+}
+
+void FamilyAggregates::memberDeleting(dex::gdb::oid_t member){
+    // the edges go with the member unannounced, its children are noted
+    // while the dag still has them
+    deleting = -1;
+    orphans.clear();
+    if ((!built)||(dirty)){
+        return;
+    }
+    ParentDag &dag = db.getParentDag();
+    deleting = dag.indexOf(member);
+    if (deleting != -1){
+        orphans = dag.getChildren(deleting);
+    }
+}
+
+void FamilyAggregates::memberDeleted(dex::gdb::oid_t member){
+    if ((!built)||(dirty)){
+        return;
+    }
+    ParentDag &dag = db.getParentDag();
+    int node = deleting;
+    deleting = -1;
+    if ((node == -1)||(dag.oidOf(node) != member)||(dag.isAlive(node))){
+        // not seen coming, the next read recounts
+        dirty = true;
+        return;
+    }
+    if (records[node].counted){
+        uncount(node);
+    }
+    vector<int> queue;
+    for (size_t c = 0; c < orphans.size(); c++){
+        int depth = depthOf(orphans[c]);
+        if (depth != records[orphans[c]].generation){
+            place(orphans[c], depth);
+            queue.push_back(orphans[c]);
+        }
+    }
+    orphans.clear();
+    settle(queue);
+}
+
+void FamilyAggregates::relationAdded(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head){
+    if ((!built)||(dirty)||(relation != db.getSchema().getParentType())){
+        return;
+    }
+    ParentDag &dag = db.getParentDag();
+    int parent = dag.indexOf(tail);
+    int child = dag.indexOf(head);
+    if ((parent == -1)||(child == -1)){
+        built = false;
+        return;
+    }
+    if (records[parent].generation + 1 > records[child].generation){
+        place(child, records[parent].generation + 1);
+        vector<int> queue(1, child);
+        settle(queue);
+    }
+}
+
+void FamilyAggregates::relationDeleted(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head){
+    if ((!built)||(dirty)||(relation != db.getSchema().getParentType())){
+        return;
+    }
+    ParentDag &dag = db.getParentDag();
+    int child = dag.indexOf(head);
+    if (child == -1){
+        built = false;
+        return;
+    }
+    int depth = depthOf(child);
+    if (depth != records[child].generation){
+        place(child, depth);
+        vector<int> queue(1, child);
+        settle(queue);
+    }
+}
+
+void FamilyAggregates::reset(){
+    built = false;
+}
@@ -0,0 +1,188 @@
+#include "FamilyComponents.h"
+#include "dex/gdb/Objects.h"
+#include "dex/gdb/ObjectsIterator.h"
+
+FamilyComponents::FamilyComponents(ParentDag &dag)
+: dag(dag)
+{
+    graph=NULL;
+    built=false;
+    dirty=false;
+    families=0;
+}
+
+void FamilyComponents::attach(dex::gdb::Graph *graph){
+    this->graph = graph;
+    reset();
+}
+
+int FamilyComponents::build(){
+    if ((!graph)||(dag.build() == -1)){
+        return -1;
+    }
+    leader.clear();
+    members.clear();
+    families = 0;
+    grow();
+
+    try{
+        dex::gdb::TypeList *types = graph->FindEdgeTypes();
+        dex::gdb::TypeListIterator *typeIt = types->Iterator();
+        while (typeIt->HasNext()){
+            dex::gdb::Objects *edges = graph->Select(typeIt->Next());
+            dex::gdb::ObjectsIterator *it = edges->Iterator();
+            while (it->HasNext()){
+                dex::gdb::EdgeData *edge = graph->GetEdgeData(it->Next());
+                int tail = dag.indexOf(edge->GetTail());
+                int head = dag.indexOf(edge->GetHead());
+                delete edge;
+                if ((tail != -1)&&(head != -1)){
+                    unite(tail, head);
+                }
+            }
+            delete it;
+            delete edges;
+        }
+        delete typeIt;
+        delete types;
+    }catch(dex::gdb::Exception &e){
+        leader.clear();
+        members.clear();
+        return -1;
+    }
+    built = true;
+    dirty = false;
+    return 1;
+}
+
+int FamilyComponents::ready(){
+    if ((!built)||(dirty)){
+        return build();
+    }
+    return 1;
+}
+
+int FamilyComponents::sameFamily(dex::gdb::oid_t member_1, dex::gdb::oid_t member_2){
+    if (ready() == -1){
+        return -1;
+    }
+    int node_1 = dag.indexOf(member_1);
+    int node_2 = dag.indexOf(member_2);
+    if ((node_1 == -1)||(node_2 == -1)){
+        return -1;
+    }
+    return (find(node_1) == find(node_2)) ? 1 : 0;
+}
+
+int FamilyComponents::familySize(dex::gdb::oid_t member){
+    if (ready() == -1){
+        return -1;
+    }
+    int node = dag.indexOf(member);
+    if (node == -1){
+        return -1;
+    }
+    return members[find(node)];
+}
+
+dex::gdb::oid_t FamilyComponents::familyOf(dex::gdb::oid_t member){
+    if (ready() == -1){
+        return dex::gdb::Objects::InvalidOID;
+    }
+    int node = dag.indexOf(member);
+    if (node == -1){
+        return dex::gdb::Objects::InvalidOID;
+    }
+    return dag.oidOf(find(node));
+}
+
+int FamilyComponents::countFamilies(){
+    if (ready() == -1){
+        return -1;
+    }
+    return families;
+}
+
+int FamilyComponents::getFamilies(vector< vector<dex::gdb::oid_t> > &clans){
+    if (ready() == -1){
+        return -1;
+    }
+    clans.clear();
+    vector<int> slot(leader.size(), -1);
+    for (int node = 0; node < static_cast<int>(leader.size()); node++){
+        if (!dag.isAlive(node)){
+            continue;
+        }
+        int root = find(node);
+        if (slot[root] == -1){
+            slot[root] = static_cast<int>(clans.size());
+            clans.push_back(vector<dex::gdb::oid_t>());
+            clans.back().reserve(members[root]);
+        }
+        clans[slot[root]].push_back(dag.oidOf(node));
+    }
+    return static_cast<int>(clans.size());
+}
+
+int FamilyComponents::find(int node){
+    while (leader[node] != node){
+        leader[node] = leader[leader[node]];
+        node = leader[node];
+    }
+    return node;
+}
+
+void FamilyComponents::unite(int node_1, int node_2){
+    int root_1 = find(node_1);
+    int root_2 = find(node_2);
+    if (root_1 == root_2){
+        return;
+    }
+    if (members[root_1] < members[root_2]){
+        swap(root_1, root_2);
+    }
+    leader[root_2] = root_1;
+    members[root_1] += members[root_2];
+    families--;
+}
+
+void FamilyComponents::grow(){
+    for (int node = static_cast<int>(leader.size()); node < dag.size(); node++){
+        bool alive = dag.isAlive(node);
+        leader.push_back(node);
+        members.push_back(alive ? 1 : 0);
+        families += alive ? 1 : 0;
+    }
+}
+
+void FamilyComponents::memberAdded(dex::gdb::oid_t member, MemberClass &data){
+    if ((built)&&(!dirty)){
+        grow();
+    }
+}
+
+void FamilyComponents::memberDeleted(dex::gdb::oid_t member){
+    dirty = true;
+}
+
+void FamilyComponents::relationAdded(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head){
+    if ((!built)||(dirty)){
+        return;
+    }
+    grow();
+    int node_1 = dag.indexOf(tail);
+    int node_2 = dag.indexOf(head);
+    if ((node_1 == -1)||(node_2 == -1)){
+        dirty = true;
+        return;
+    }
+    unite(node_1, node_2);
+}
+
+void FamilyComponents::relationDeleted(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head){
+    dirty = true;
+}
+
+void FamilyComponents::reset(){
+    built = false;
+}
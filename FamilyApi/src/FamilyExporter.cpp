@@ -0,0 +1,133 @@
+#include "FamilyExporter.h"
+#include "dex/gdb/Objects.h"
+#include "dex/gdb/ObjectsIterator.h"
+#include <cstring>
+
+FamilyExporter::FamilyExporter(DexDBWrapper &db)
+: db(db)
+{
+    header = false;
+}
+
+void FamilyExporter::setHeader(bool header){
+    this->header = header;
+}
+
+void FamilyExporter::addLong(BufferedRowWriter &writer, dex::gdb::oid_t oid, dex::gdb::attr_t attr){
+    db.getGraph()->GetAttribute(oid, attr, value);
+    if (value.IsNull()){
+        writer.addNull();
+    }else if (value.GetDataType() == dex::gdb::Integer){
+        writer.addInteger(value.GetInteger());
+    }else{
+        writer.addInteger(value.GetLong());
+    }
+}
+
+void FamilyExporter::addString(BufferedRowWriter &writer, dex::gdb::oid_t oid, dex::gdb::attr_t attr){
+    db.getGraph()->GetAttribute(oid, attr, value);
+    if (value.IsNull()){
+        writer.addNull();
+    }else{
+        writer.addString(value.GetString());
+    }
+}
+
+void FamilyExporter::addDate(BufferedRowWriter &writer, dex::gdb::oid_t oid, dex::gdb::attr_t attr){
+    db.getGraph()->GetAttribute(oid, attr, value);
+    if (value.IsNull()){
+        writer.addNull();
+    }else{
+        writer.addDate(value.GetTimestamp());
+    }
+}
+
+dex::gdb::int64_t FamilyExporter::exportMembers(BufferedRowWriter &writer){
+    dex::gdb::Graph *graph = db.getGraph();
+    if (!graph){
+        return -1;
+    }
+    DexSchema &schema = db.getSchema();
+    dex::gdb::int64_t rows = 0;
+    try{
+        if (header){
+            static const char *names[] = {"id", "name", "surname", "sex", "birth", "heaven", "partnerId"};
+            writer.beginRow(7);
+            for (int i = 0; i < 7; i++){
+                writer.addUtf8(names[i], strlen(names[i]));
+            }
+            writer.endRow();
+        }
+
+        dex::gdb::Objects *members = graph->Select(schema.getMemberType());
+        dex::gdb::ObjectsIterator *it = members->Iterator();
+        while (it->HasNext()){
+            dex::gdb::oid_t oid = it->Next();
+            writer.beginRow(7);
+            addLong(writer, oid, schema.getIdAttr());
+            addString(writer, oid, schema.getNameAttr());
+            addString(writer, oid, schema.getSurnameAttr());
+            addLong(writer, oid, schema.getSexAttr());
+            addDate(writer, oid, schema.getBirthAttr());
+            addDate(writer, oid, schema.getHeavenAttr());
+            addLong(writer, oid, schema.getPartnerIdAttr());
+            writer.endRow();
+            rows++;
+        }
+        delete it;
+        delete members;
+        writer.Close();
+    }catch(dex::gdb::Exception &e){
+        return -1;
+    }
+    return rows;
+}
+
+dex::gdb::int64_t FamilyExporter::exportRelations(BufferedRowWriter &writer){
+    dex::gdb::Graph *graph = db.getGraph();
+    if (!graph){
+        return -1;
+    }
+    DexSchema &schema = db.getSchema();
+    dex::gdb::int64_t rows = 0;
+    try{
+        if (header){
+            static const char *names[] = {"relation", "id_1", "id_2"};
+            writer.beginRow(3);
+            for (int i = 0; i < 3; i++){
+                writer.addUtf8(names[i], strlen(names[i]));
+            }
+            writer.endRow();
+        }
+
+        dex::gdb::TypeList *types = graph->FindEdgeTypes();
+        dex::gdb::TypeListIterator *typeIt = types->Iterator();
+        while (typeIt->HasNext()){
+            dex::gdb::type_t type = typeIt->Next();
+            dex::gdb::Type *typeData = graph->GetType(type);
+            wstring relation = typeData->GetName();
+            delete typeData;
+
+            dex::gdb::Objects *edges = graph->Select(type);
+            dex::gdb::ObjectsIterator *it = edges->Iterator();
+            while (it->HasNext()){
+                dex::gdb::EdgeData *edge = graph->GetEdgeData(it->Next());
+                writer.beginRow(3);
+                writer.addString(relation);
+                addLong(writer, edge->GetTail(), schema.getIdAttr());
+                addLong(writer, edge->GetHead(), schema.getIdAttr());
+                writer.endRow();
+                delete edge;
+                rows++;
+            }
+            delete it;
+            delete edges;
+        }
+        delete typeIt;
+        delete types;
+        writer.Close();
+    }catch(dex::gdb::Exception &e){
+        return -1;
+    }
+    return rows;
+}
@@ -0,0 +1,290 @@
+#include "FamilyImporter.h"
+#include "Utf8Codec.h"
+#include "dex/gdb/Objects.h"
+#include <cwchar>
+
+const int FamilyImporter::DefaultBatchSize;
+
+FamilyImporter::FamilyImporter(DexDBWrapper &db, ImportCheckpoint &checkpoint)
+: db(db), checkpoint(checkpoint)
+{
+    batchSize = DefaultBatchSize;
+    imported = 0;
+    rejected = 0;
+}
+
+void FamilyImporter::setBatchSize(int rows){
+    this->batchSize = (rows > 0) ? rows : DefaultBatchSize;
+}
+
+dex::gdb::int64_t FamilyImporter::getImported(){
+    return this->imported;
+}
+
+dex::gdb::int64_t FamilyImporter::getRejected(){
+    return this->rejected;
+}
+
+int FamilyImporter::run(SeekableCSVReader &members, SeekableCSVReader &relations){
+    if (!db.getGraph()){
+        return -1;
+    }
+    if (checkpoint.load() == -1){
+        return -1;
+    }
+    // the counts of the runs this one resumes
+    imported = checkpoint.getImported();
+    rejected = checkpoint.getRejected();
+    if (checkpoint.getPhase() == importDone){
+        // already imported, clear() the checkpoint to import again
+        return 0;
+    }
+    int result = 1;
+    if ((importPhase(importMembers, members) == -1)||(importPhase(importRelations, relations) == -1)){
+        result = -1;
+    }
+    // rows went straight to the graph, the in-memory indexes have to follow
+    db.resetIndexes();
+    return result;
+}
+
+int FamilyImporter::importPhase(ImportPhase phase, SeekableCSVReader &reader){
+    if (checkpoint.getPhase() > phase){
+        return 1;
+    }
+    if (phase == importRelations){
+        // the parent order has to see the members stored so far; an image
+        // that already holds a cycle cannot take parent edges at all
+        db.resetIndexes();
+        if (db.getOrder().build() == -1){
+            return -1;
+        }
+    }
+
+    bool replay = false;
+    bool open = false;
+    dex::gdb::Session *sess = db.getSession();
+    dex::gdb::int64_t batchOffset = 0;
+    dex::gdb::int32_t batchRow = 0;
+    dex::gdb::int64_t batchImported = imported;
+    dex::gdb::int64_t batchRejected = rejected;
+    try{
+        if ((checkpoint.getPhase() == phase)&&(checkpoint.getBatch() > 0)){
+            if (reader.seek(checkpoint.getOffset(), checkpoint.getRow()) == -1){
+                return -1;
+            }
+            replay = true;
+        }else{
+            reader.Reset();
+        }
+
+        dex::gdb::StringList row;
+        bool more = true;
+        while (more){
+            batchOffset = reader.getOffset();
+            batchRow = reader.GetRow();
+            batchImported = imported;
+            batchRejected = rejected;
+            sess->Begin();
+            open = true;
+            for (int rows = 0; rows < batchSize; rows++){
+                row.Clear();
+                more = reader.Read(row);
+                if (!more){
+                    break;
+                }
+
+                fields.clear();
+                dex::gdb::StringListIterator *it = row.Iterator();
+                while (it->HasNext()){
+                    fields.push_back(it->Next());
+                }
+                delete it;
+
+                int stored = (phase == importMembers) ? storeMember(replay) : storeRelation(replay);
+                if (stored == 1){
+                    imported++;
+                }else{
+                    rejected++;
+                }
+            }
+            open = false;
+            sess->Commit();
+
+            if (more){
+                checkpoint.advance(phase, reader.getOffset(), reader.GetRow());
+            }else{
+                checkpoint.advance(static_cast<ImportPhase>(phase + 1), 0, 0);
+            }
+            checkpoint.setCounts(imported, rejected);
+            if (checkpoint.save() == -1){
+                return -1;
+            }
+            replay = false;
+        }
+    }catch(dex::gdb::Exception &e){
+        abortBatch(phase, open, batchOffset, batchRow, batchImported, batchRejected);
+        return -1;
+    }
+    return 1;
+}
+
+void FamilyImporter::abortBatch(ImportPhase phase, bool open, dex::gdb::int64_t offset, dex::gdb::int32_t row, dex::gdb::int64_t imported, dex::gdb::int64_t rejected){
+    // DEX has no rollback: the rows stored so far are committed and the
+    // checkpoint is moved to the start of the batch, so a resume replays
+    // it and skips what is already there
+    this->imported = imported;
+    this->rejected = rejected;
+    try{
+        if (open){
+            db.getSession()->Commit();
+        }
+    }catch(dex::gdb::Exception &e){
+        return;
+    }
+    if (open){
+        // the ids mapped in this batch go too, the replay maps them again
+        checkpoint.discard();
+        checkpoint.advance(phase, offset, row);
+        checkpoint.setCounts(imported, rejected);
+        checkpoint.save();
+    }
+}
+
+int FamilyImporter::storeMember(bool replay){
+    MemberClass member;
+    unsigned int id;
+    if ((fields.size() < 7)||(!parseId(fields[0], id))){
+        return -1;
+    }
+
+    if (checkpoint.findId(id) != dex::gdb::Objects::InvalidOID){
+        // twice in the file
+        return -1;
+    }
+    dex::gdb::Graph *graph = db.getGraph();
+    DexSchema &schema = db.getSchema();
+    dex::gdb::oid_t oid = db.oidOf(id);
+    if (oid != dex::gdb::Objects::InvalidOID){
+        // only a replayed batch may find its own rows stored already
+        if (!replay){
+            return -1;
+        }
+    }else{
+        member.setId(id);
+        member.setName(Utf8Codec::encode(fields[1]));
+        member.setSurname(Utf8Codec::encode(fields[2]));
+        member.setSex(parseSex(fields[3]));
+
+        DateClass birthDate;
+        if (parseDate(fields[4], birthDate)){
+            member.setBirthDate(birthDate);
+        }
+        DateClass heavenDate;
+        if (parseDate(fields[5], heavenDate)){
+            member.setHeavenDate(heavenDate);
+        }
+        unsigned int partnerId;
+        if (parseId(fields[6], partnerId)){
+            member.setPartnerId(partnerId);
+        }
+
+        oid = graph->NewNode(schema.getMemberType());
+        try{
+            schema.writeMember(graph, oid, member);
+        }catch(dex::gdb::Exception &e){
+            // no node without an id may outlive the batch
+            graph->Drop(oid);
+            throw;
+        }
+        db.getMemberIds().insert(id);
+    }
+    checkpoint.mapId(id, oid);
+    return 1;
+}
+
+int FamilyImporter::storeRelation(bool replay){
+    unsigned int id_1, id_2;
+    if ((fields.size() < 3)||(!parseId(fields[1], id_1))||(!parseId(fields[2], id_2))){
+        return -1;
+    }
+
+    dex::gdb::Graph *graph = db.getGraph();
+    dex::gdb::type_t type;
+    map<wstring, dex::gdb::type_t>::iterator known = relations.find(fields[0]);
+    if (known != relations.end()){
+        type = known->second;
+    }else{
+        type = db.getSchema().createRelation(graph, fields[0]);
+        relations[fields[0]] = type;
+    }
+
+    dex::gdb::oid_t tail = findMember(id_1);
+    dex::gdb::oid_t head = findMember(id_2);
+    if ((tail == dex::gdb::Objects::InvalidOID)||(head == dex::gdb::Objects::InvalidOID)){
+        return -1;
+    }
+    if ((replay)&&(graph->FindEdge(type, tail, head) != dex::gdb::Objects::InvalidOID)){
+        return 1;
+    }
+    if (type == db.getSchema().getParentType()){
+        // nobody may become their own ancestor, as in addRelationTo
+        if (db.getOrder().insertEdge(tail, head) != 1){
+            return -1;
+        }
+        graph->NewEdge(type, tail, head);
+        ParentDag &dag = db.getParentDag();
+        dag.addEdge(dag.indexOf(tail), dag.indexOf(head));
+        return 1;
+    }
+    graph->NewEdge(type, tail, head);
+    return 1;
+}
+
+dex::gdb::oid_t FamilyImporter::findMember(unsigned int id){
+    dex::gdb::oid_t oid = checkpoint.findId(id);
+    if (oid == dex::gdb::Objects::InvalidOID){
+        // member stored before this import started
+        oid = db.oidOf(id);
+    }
+    return oid;
+}
+
+bool FamilyImporter::parseId(const wstring &text, unsigned int &id){
+    if (text.empty()){
+        return false;
+    }
+    wchar_t *end;
+    unsigned long value = wcstoul(text.c_str(), &end, 10);
+    if (*end != L'\0'){
+        return false;
+    }
+    id = static_cast<unsigned int>(value);
+    return true;
+}
+
+Sex FamilyImporter::parseSex(const wstring &text){
+    if ((text == L"1")||(text == L"m")||(text == L"M")){
+        return male;
+    }else if ((text == L"0")||(text == L"f")||(text == L"F")){
+        return female;
+    }
+    return nn;
+}
+
+bool FamilyImporter::parseDate(const wstring &text, DateClass &date){
+    // YYYY, YYYY-MM or YYYY-MM-DD
+    int year = 0, month = 1, day = 1;
+    if ((text.empty())||(swscanf(text.c_str(), L"%d-%d-%d", &year, &month, &day) < 1)){
+        return false;
+    }
+    tm time;
+    time.tm_year = year;
+    time.tm_mon = month - 1;
+    time.tm_mday = day;
+    time.tm_hour = time.tm_min = time.tm_sec = 0;
+    time.tm_wday = time.tm_yday = time.tm_isdst = 0;
+
+    string cause;
+    return date.setDate(time, cause) == 1;
+}
@@ -0,0 +1,499 @@
+#include "FamilyLayout.h"
+#include "dex/gdb/Objects.h"
+#include "dex/gdb/ObjectsIterator.h"
+#include <algorithm>
+
+FamilyLayout::FamilyLayout(DexDBWrapper &db)
+: db(db)
+{
+    maxGenerations=0;
+    direction=descendantChart;
+    charted=false;
+    stale=false;
+    contoursBuilt=false;
+    boxesDirty=false;
+    partnersBuilt=false;
+    db.registerListener(*this);
+}
+
+FamilyLayout::~FamilyLayout()
+{
+    db.unregisterListener(*this);
+}
+
+void FamilyLayout::setMaxGenerations(int generations){
+    this->maxGenerations = generations;
+}
+
+void FamilyLayout::setGap(double gap){
+    tree.setGap(gap);
+    contours.setGap(gap);
+}
+
+void FamilyLayout::setThreads(int threads){
+    tree.setThreads(threads);
+}
+
+const vector<LayoutBox> & FamilyLayout::getBoxes(){
+    if ((charted)&&(stale)){
+        layout(root, direction);
+    }else if ((charted)&&(boxesDirty)){
+        contourBoxes();
+        boxesDirty = false;
+    }
+    return this->boxes;
+}
+
+const vector<dex::gdb::oid_t> & FamilyLayout::getMoved(){
+    return this->moved;
+}
+
+int FamilyLayout::layout(MemberClass root, ChartDirection direction){
+    boxes.clear();
+    moved.clear();
+    charted = false;
+    dex::gdb::Graph *graph = db.getGraph();
+    if (!graph){
+        return -1;
+    }
+    try{
+        dex::gdb::oid_t oid = db.oidOf(root.getId());
+        ParentDag &dag = db.getParentDag();
+        if ((oid == dex::gdb::Objects::InvalidOID)||(!dag.isBuilt())){
+            return -1;
+        }
+        if ((direction == descendantChart)&&(buildPartners() == -1)){
+            return -1;
+        }
+        this->root = root;
+        this->direction = direction;
+        collect(dag.indexOf(oid));
+        tree.layout(chartParent, chartWidth);
+
+        int nodes = static_cast<int>(chart.size());
+        vector<int> order(nodes);
+        vector<int> generations(nodes);
+        vector<double> centres(nodes);
+        for (int node = 0; node < nodes; node++){
+            order[node] = node;
+            generations[node] = tree.getDepth(node);
+            centres[node] = tree.getX(node);
+        }
+        fillBoxes(order, chartParent, centres, generations);
+    }catch(dex::gdb::Exception &e){
+        boxes.clear();
+        return -1;
+    }
+    charted = true;
+    stale = false;
+    contoursBuilt = false;
+    boxesDirty = false;
+    return static_cast<int>(boxes.size());
+}
+
+void FamilyLayout::collect(int root){
+    ParentDag &dag = db.getParentDag();
+    chart.clear();
+    chartParent.clear();
+    chartWidth.clear();
+    chartNode.assign(dag.size(), -1);
+
+    // breadth first, so the tree comes out in the order TreeLayout wants
+    vector<int> generation(1, 0);
+    vector<int> next;
+    addToChart(-1, root);
+    for (size_t i = 0; i < chart.size(); i++){
+        if ((maxGenerations > 0)&&(generation[i] >= maxGenerations)){
+            continue;
+        }
+        // node numbers follow the oids, that is the order of creation
+        next = linksOf(chart[i]);
+        sort(next.begin(), next.end());
+        for (size_t j = 0; j < next.size(); j++){
+            if (chartOf(next[j]) == -1){
+                addToChart(static_cast<int>(i), next[j]);
+                generation.push_back(generation[i] + 1);
+            }
+        }
+    }
+}
+
+void FamilyLayout::addToChart(int parent, int node){
+    if (node >= static_cast<int>(chartNode.size())){
+        chartNode.resize(node + 1, -1);
+    }
+    chartNode[node] = static_cast<int>(chart.size());
+    chart.push_back(node);
+    chartParent.push_back(parent);
+    chartWidth.push_back((direction == descendantChart) ? 1.0 + partnersOf(node).size() : 1.0);
+}
+
+int FamilyLayout::chartOf(int node){
+    return ((node >= 0)&&(node < static_cast<int>(chartNode.size()))) ? chartNode[node] : -1;
+}
+
+const vector<int> & FamilyLayout::linksOf(int node){
+    ParentDag &dag = db.getParentDag();
+    return (direction == descendantChart) ? dag.getChildren(node) : dag.getParents(node);
+}
+
+const vector<int> & FamilyLayout::backLinksOf(int node){
+    ParentDag &dag = db.getParentDag();
+    return (direction == descendantChart) ? dag.getParents(node) : dag.getChildren(node);
+}
+
+void FamilyLayout::fillBoxes(const vector<int> &nodes, const vector<int> &parents, const vector<double> &centres, const vector<int> &generations){
+    // nodes are chart nodes, parents index into nodes
+    ParentDag &dag = db.getParentDag();
+    boxes.clear();
+    vector<int> boxOf(nodes.size());
+    double left = 0.0;
+    for (size_t i = 0; i < nodes.size(); i++){
+        int node = nodes[i];
+        LayoutBox box;
+        box.member = dag.oidOf(chart[node]);
+        box.partner = false;
+        box.parentBox = (parents[i] == -1) ? -1 : boxOf[parents[i]];
+        box.generation = (direction == descendantChart) ? generations[i] : -generations[i];
+        box.x = centres[i] - (chartWidth[node] - 1.0) / 2.0;
+        left = (i == 0) ? box.x : min(left, box.x);
+        boxOf[i] = static_cast<int>(boxes.size());
+        boxes.push_back(box);
+
+        if (direction == descendantChart){
+            const vector<int> &couple = partnersOf(chart[node]);
+            for (size_t p = 0; p < couple.size(); p++){
+                box.member = dag.oidOf(couple[p]);
+                box.partner = true;
+                box.parentBox = boxOf[i];
+                box.x += 1.0;
+                boxes.push_back(box);
+            }
+        }
+    }
+    for (size_t i = 0; i < boxes.size(); i++){
+        boxes[i].x -= left;
+    }
+}
+
+void FamilyLayout::contourBoxes(){
+    // offsets add up from the root, breadth first as TreeLayout gives them
+    vector<int> order(1, 0);
+    vector<int> parents(1, -1);
+    vector<int> generations(1, 0);
+    vector<double> centres(1, 0.0);
+    for (size_t i = 0; i < order.size(); i++){
+        const vector<int> &kids = contours.getChildren(order[i]);
+        for (size_t k = 0; k < kids.size(); k++){
+            order.push_back(kids[k]);
+            parents.push_back(static_cast<int>(i));
+            generations.push_back(generations[i] + 1);
+            centres.push_back(centres[i] + contours.getOffset(kids[k]));
+        }
+    }
+    fillBoxes(order, parents, centres, generations);
+}
+
+void FamilyLayout::grow(dex::gdb::oid_t from, dex::gdb::oid_t to){
+    ParentDag &dag = db.getParentDag();
+    int parent = chartOf(dag.indexOf(from));
+    int start = dag.indexOf(to);
+    if (parent == -1){
+        return;
+    }
+    if ((start == -1)||(chartOf(start) != -1)){
+        // already drawn: which line reaches it first may have changed
+        stale = true;
+        return;
+    }
+    if (!contoursBuilt){
+        contours.build(chartParent, chartWidth);
+        contoursBuilt = true;
+    }
+    if ((maxGenerations > 0)&&(contours.getDepth(parent) >= maxGenerations)){
+        return;
+    }
+
+    int index = 0;
+    const vector<int> &siblings = contours.getChildren(parent);
+    for (size_t i = 0; i < siblings.size(); i++){
+        index += (chart[siblings[i]] < start) ? 1 : 0;
+    }
+    int first = static_cast<int>(chart.size());
+    addToChart(parent, start);
+    contours.addNode(parent, index, chartWidth.back());
+
+    // the new member brings along whatever hangs below it
+    vector<int> next;
+    for (int i = first; i < static_cast<int>(chart.size()); i++){
+        if ((maxGenerations > 0)&&(contours.getDepth(i) >= maxGenerations)){
+            continue;
+        }
+        next = linksOf(chart[i]);
+        sort(next.begin(), next.end());
+        for (size_t j = 0; j < next.size(); j++){
+            int drawn = chartOf(next[j]);
+            if ((drawn != -1)&&(drawn < first)){
+                stale = true;
+                return;
+            }
+            if (drawn == -1){
+                addToChart(i, next[j]);
+                contours.addNode(i, static_cast<int>(contours.getChildren(i).size()), chartWidth.back());
+            }
+        }
+    }
+    updated(first);
+}
+
+void FamilyLayout::shrink(dex::gdb::oid_t from, dex::gdb::oid_t to){
+    ParentDag &dag = db.getParentDag();
+    int parent = chartOf(dag.indexOf(from));
+    int start = chartOf(dag.indexOf(to));
+    if ((parent == -1)||(start == -1)){
+        return;
+    }
+    if (!contoursBuilt){
+        contours.build(chartParent, chartWidth);
+        contoursBuilt = true;
+    }
+    if (contours.getParent(start) != parent){
+        // not the edge it hangs from in the chart
+        return;
+    }
+
+    vector<int> subtree(1, start);
+    for (size_t i = 0; i < subtree.size(); i++){
+        const vector<int> &kids = contours.getChildren(subtree[i]);
+        subtree.insert(subtree.end(), kids.begin(), kids.end());
+    }
+    for (size_t i = 0; i < subtree.size(); i++){
+        chartNode[chart[subtree[i]]] = -2;
+    }
+    // still reached from the rest of the chart, it has to be drawn there
+    for (size_t i = 0; i < subtree.size(); i++){
+        const vector<int> &back = backLinksOf(chart[subtree[i]]);
+        for (size_t j = 0; j < back.size(); j++){
+            if (chartOf(back[j]) >= 0){
+                stale = true;
+                return;
+            }
+        }
+    }
+    for (size_t i = 0; i < subtree.size(); i++){
+        chartNode[chart[subtree[i]]] = -1;
+    }
+    contours.removeSubtree(start);
+    updated(static_cast<int>(chart.size()));
+}
+
+void FamilyLayout::resize(int node){
+    int drawn = chartOf(node);
+    if (drawn == -1){
+        return;
+    }
+    if (!contoursBuilt){
+        contours.build(chartParent, chartWidth);
+        contoursBuilt = true;
+    }
+    chartWidth[drawn] = 1.0 + partnersOf(node).size();
+    contours.setWidth(drawn, chartWidth[drawn]);
+}
+
+void FamilyLayout::updated(int first){
+    ParentDag &dag = db.getParentDag();
+    contours.update();
+    moved.clear();
+    const vector<int> &shifted = contours.getMoved();
+    for (size_t i = 0; i < shifted.size(); i++){
+        if (shifted[i] < first){
+            moved.push_back(dag.oidOf(chart[shifted[i]]));
+        }
+    }
+    for (int node = first; node < static_cast<int>(chart.size()); node++){
+        moved.push_back(dag.oidOf(chart[node]));
+    }
+    boxesDirty = true;
+}
+
+int FamilyLayout::buildPartners(){
+    if (partnersBuilt){
+        return 1;
+    }
+    ParentDag &dag = db.getParentDag();
+    dex::gdb::Graph *graph = db.getGraph();
+    partners.assign(dag.size(), vector<int>());
+    waiting.clear();
+
+    dex::gdb::Objects *edges = graph->Select(db.getSchema().getPartnerType());
+    dex::gdb::ObjectsIterator *it = edges->Iterator();
+    while (it->HasNext()){
+        dex::gdb::EdgeData *edge = graph->GetEdgeData(it->Next());
+        link(dag.indexOf(edge->GetTail()), dag.indexOf(edge->GetHead()));
+        delete edge;
+    }
+    delete it;
+    delete edges;
+    for (int node = 0; node < dag.size(); node++){
+        if (dag.isAlive(node)){
+            name(node, db.partnerIdOf(dag.oidOf(node)));
+        }
+    }
+    partnersBuilt = true;
+    return 1;
+}
+
+const vector<int> & FamilyLayout::partnersOf(int node){
+    static const vector<int> none;
+    return (node < static_cast<int>(partners.size())) ? partners[node] : none;
+}
+
+void FamilyLayout::link(int node_1, int node_2){
+    if ((node_1 == -1)||(node_2 == -1)||(node_1 == node_2)){
+        return;
+    }
+    int last = max(node_1, node_2);
+    if (last >= static_cast<int>(partners.size())){
+        partners.resize(last + 1);
+    }
+    // a couple may be linked in both directions
+    if (find(partners[node_1].begin(), partners[node_1].end(), node_2) == partners[node_1].end()){
+        partners[node_1].push_back(node_2);
+        partners[node_2].push_back(node_1);
+    }
+}
+
+void FamilyLayout::name(int node, unsigned int partnerId){
+    if (partnerId == 0){
+        return;
+    }
+    dex::gdb::oid_t partner = db.oidOf(partnerId);
+    if (partner == dex::gdb::Objects::InvalidOID){
+        waiting[partnerId].push_back(node);
+    }else{
+        link(node, db.getParentDag().indexOf(partner));
+    }
+}
+
+bool FamilyLayout::names(dex::gdb::oid_t member, dex::gdb::oid_t partner){
+    unsigned int id = db.partnerIdOf(member);
+    return (id != 0)&&(db.oidOf(id) == partner);
+}
+
+void FamilyLayout::couple(int node_1, int node_2){
+    link(node_1, node_2);
+    if ((charted)&&(!stale)&&(direction == descendantChart)){
+        resize(node_1);
+        resize(node_2);
+        updated(static_cast<int>(chart.size()));
+    }
+}
+
+void FamilyLayout::unlink(int node_1, int node_2){
+    if ((node_1 == -1)||(node_2 == -1)||(max(node_1, node_2) >= static_cast<int>(partners.size()))){
+        return;
+    }
+    partners[node_1].erase(remove(partners[node_1].begin(), partners[node_1].end(), node_2), partners[node_1].end());
+    partners[node_2].erase(remove(partners[node_2].begin(), partners[node_2].end(), node_1), partners[node_2].end());
+}
+
+void FamilyLayout::memberAdded(dex::gdb::oid_t member, MemberClass &data){
+    if (!partnersBuilt){
+        return;
+    }
+    ParentDag &dag = db.getParentDag();
+    int node = dag.indexOf(member);
+    if (node == -1){
+        partnersBuilt = false;
+        stale = charted;
+        return;
+    }
+    // the partner it names, and whoever named it before it was there
+    vector<int> named;
+    map<unsigned int, vector<int> >::iterator found = waiting.find(data.getId());
+    if (found != waiting.end()){
+        named.swap(found->second);
+        waiting.erase(found);
+    }
+    try{
+        dex::gdb::oid_t partner = (data.getPartnerId() == 0) ? dex::gdb::Objects::InvalidOID : db.oidOf(data.getPartnerId());
+        if (partner != dex::gdb::Objects::InvalidOID){
+            named.push_back(dag.indexOf(partner));
+        }else if (data.getPartnerId() != 0){
+            waiting[data.getPartnerId()].push_back(node);
+        }
+    }catch(dex::gdb::Exception &e){
+        partnersBuilt = false;
+        stale = charted;
+        return;
+    }
+    for (size_t i = 0; i < named.size(); i++){
+        couple(node, named[i]);
+    }
+}
+
+void FamilyLayout::memberDeleted(dex::gdb::oid_t member){
+    partnersBuilt = false;
+    stale = charted;
+}
+
+void FamilyLayout::relationAdded(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head){
+    DexSchema &schema = db.getSchema();
+    ParentDag &dag = db.getParentDag();
+    if ((relation == schema.getPartnerType())&&(partnersBuilt)){
+        couple(dag.indexOf(tail), dag.indexOf(head));
+    }else if ((relation == schema.getParentType())&&(charted)&&(!stale)){
+        if (direction == descendantChart){
+            grow(tail, head);
+        }else{
+            grow(head, tail);
+        }
+    }
+}
+
+void FamilyLayout::relationDeleted(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head){
+    DexSchema &schema = db.getSchema();
+    ParentDag &dag = db.getParentDag();
+    if ((relation == schema.getPartnerType())&&(partnersBuilt)){
+        dex::gdb::Objects *forward = NULL;
+        dex::gdb::Objects *backward = NULL;
+        try{
+            // still a couple while any partner edge between them is left,
+            // either way round or a second one the same way, or while one
+            // names the other by partnerId
+            dex::gdb::Graph *graph = db.getGraph();
+            forward = graph->Edges(relation, tail, head);
+            backward = graph->Edges(relation, head, tail);
+            dex::gdb::int64_t left = forward->Count() + backward->Count();
+            delete forward;
+            delete backward;
+            forward = backward = NULL;
+            if ((left > 0)||(names(tail, head))||(names(head, tail))){
+                return;
+            }
+        }catch(dex::gdb::Exception &e){
+            delete forward;
+            delete backward;
+            partnersBuilt = false;
+            stale = charted;
+            return;
+        }
+        unlink(dag.indexOf(tail), dag.indexOf(head));
+        if ((charted)&&(!stale)&&(direction == descendantChart)){
+            resize(dag.indexOf(tail));
+            resize(dag.indexOf(head));
+            updated(static_cast<int>(chart.size()));
+        }
+    }else if ((relation == schema.getParentType())&&(charted)&&(!stale)){
+        if (direction == descendantChart){
+            shrink(tail, head);
+        }else{
+            shrink(head, tail);
+        }
+    }
+}
+
+void FamilyLayout::reset(){
+    partnersBuilt = false;
+    stale = charted;
+}
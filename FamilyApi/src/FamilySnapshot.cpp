@@ -0,0 +1,532 @@
+#include "FamilySnapshot.h"
+#include "dex/gdb/Objects.h"
+#include <sched.h>
+#include <set>
+
+const int SnapshotPublisher::RecordsPerChunk = 256;
+const int SnapshotPublisher::MembersPerBucket = 8;
+int SnapshotPublisher::live = 0;
+
+FamilySnapshot::FamilySnapshot()
+{
+    version=NULL;
+}
+
+FamilySnapshot::FamilySnapshot(const FamilySnapshot &other)
+{
+    version=NULL;
+    hold(other.version);
+}
+
+FamilySnapshot::~FamilySnapshot()
+{
+    release();
+}
+
+FamilySnapshot & FamilySnapshot::operator=(const FamilySnapshot &other){
+    hold(other.version);
+    return *this;
+}
+
+bool FamilySnapshot::isValid() const{
+    return (version != NULL);
+}
+
+unsigned long long FamilySnapshot::getEpoch() const{
+    return version ? version->epoch : 0;
+}
+
+int FamilySnapshot::size() const{
+    return version ? version->members : -1;
+}
+
+dex::gdb::oid_t FamilySnapshot::findMember(MemberClass member) const{
+    int node = nodeOf(member.getId());
+    return (node == -1) ? dex::gdb::Objects::InvalidOID : memberAt(node).oid;
+}
+
+int FamilySnapshot::findByName(MemberClass member, vector<unsigned int> *ids) const{
+    if (ids){
+        ids->clear();
+    }
+    if (!version){
+        return -1;
+    }
+    string name = member.getName();
+    string surname = member.getSurname();
+    const vector< pair<string, int> > &bucket = version->names[nameBucket(name, version->names.size())]->items;
+    int count = 0;
+    for (size_t i = 0; i < bucket.size(); i++){
+        if (bucket[i].first != name){
+            continue;
+        }
+        const SnapshotMember &found = memberAt(bucket[i].second);
+        // no surname matches any, as in DexDBWrapper::findByName
+        if ((surname.empty())||(found.surname == surname)){
+            count++;
+            if (ids){
+                ids->push_back(found.id);
+            }
+        }
+    }
+    return count;
+}
+
+int FamilySnapshot::findChildren(MemberClass member, vector<unsigned int> *ids) const{
+    if (ids){
+        ids->clear();
+    }
+    int node = nodeOf(member.getId());
+    return (node == -1) ? -1 : listIds(memberAt(node).children, ids);
+}
+
+int FamilySnapshot::findParents(MemberClass member, vector<unsigned int> *ids) const{
+    if (ids){
+        ids->clear();
+    }
+    int node = nodeOf(member.getId());
+    return (node == -1) ? -1 : listIds(memberAt(node).parents, ids);
+}
+
+int FamilySnapshot::isAncestor(MemberClass ancestor, MemberClass member) const{
+    int from = nodeOf(ancestor.getId());
+    int to = nodeOf(member.getId());
+    if ((from == -1)||(to == -1)){
+        return -1;
+    }
+    // up from the member, a report asks about one line at a time
+    set<int> seen;
+    vector<int> open(1, to);
+    while (!open.empty()){
+        int node = open.back();
+        open.pop_back();
+        const vector<int> &parents = memberAt(node).parents;
+        for (size_t i = 0; i < parents.size(); i++){
+            if (parents[i] == from){
+                return 1;
+            }
+            if (seen.insert(parents[i]).second){
+                open.push_back(parents[i]);
+            }
+        }
+    }
+    return 0;
+}
+
+void FamilySnapshot::release(){
+    if ((version)&&(__sync_sub_and_fetch(&version->refs, 1) == 0)){
+        SnapshotPublisher::release(*version);
+        delete version;
+        __sync_sub_and_fetch(&SnapshotPublisher::live, 1);
+    }
+    version = NULL;
+}
+
+void FamilySnapshot::adopt(SnapshotVersion *version){
+    // the reference was taken by the caller
+    release();
+    this->version = version;
+}
+
+void FamilySnapshot::hold(SnapshotVersion *version){
+    // taken before the old one goes, the two may be the same
+    if (version){
+        __sync_add_and_fetch(&version->refs, 1);
+    }
+    release();
+    this->version = version;
+}
+
+int FamilySnapshot::nodeOf(unsigned int id) const{
+    if (!version){
+        return -1;
+    }
+    const vector< pair<unsigned int, int> > &bucket = version->ids[idBucket(id, version->ids.size())]->items;
+    for (size_t i = 0; i < bucket.size(); i++){
+        if (bucket[i].first == id){
+            return bucket[i].second;
+        }
+    }
+    return -1;
+}
+
+const SnapshotMember & FamilySnapshot::memberAt(int node) const{
+    return version->chunks[node / SnapshotPublisher::RecordsPerChunk]->items[node % SnapshotPublisher::RecordsPerChunk];
+}
+
+int FamilySnapshot::listIds(const vector<int> &nodes, vector<unsigned int> *ids) const{
+    if (ids){
+        for (size_t i = 0; i < nodes.size(); i++){
+            ids->push_back(memberAt(nodes[i]).id);
+        }
+    }
+    return static_cast<int>(nodes.size());
+}
+
+size_t FamilySnapshot::idBucket(unsigned int id, size_t buckets){
+    return static_cast<size_t>((id * 0x9e3779b97f4a7c15ULL) >> 32) & (buckets - 1);
+}
+
+size_t FamilySnapshot::nameBucket(const string &name, size_t buckets){
+    // FNV-1a
+    unsigned long long value = 14695981039346656037ULL;
+    for (size_t i = 0; i < name.size(); i++){
+        value ^= static_cast<unsigned char>(name[i]);
+        value *= 1099511628211ULL;
+    }
+    return static_cast<size_t>(value) & (buckets - 1);
+}
+
+SnapshotPublisher::SnapshotPublisher(DexDBWrapper &db)
+: db(db)
+{
+    built=false;
+    epoch=0;
+    working.epoch=0;
+    working.refs=0;
+    working.members=0;
+    latest=NULL;
+    phase=0;
+    readers[0]=0;
+    readers[1]=0;
+    db.registerListener(*this);
+}
+
+SnapshotPublisher::~SnapshotPublisher()
+{
+    db.unregisterListener(*this);
+    swap(NULL);
+    drop();
+}
+
+int SnapshotPublisher::acquire(FamilySnapshot &snapshot){
+    if (!built){
+        if (build() == -1){
+            return -1;
+        }
+        working.epoch = epoch;
+        swap(publish(working));
+    }
+    read(snapshot);
+    return 1;
+}
+
+int SnapshotPublisher::read(FamilySnapshot &snapshot){
+    // count in under the current phase, unless it flips meanwhile
+    int current;
+    while (true){
+        current = __sync_add_and_fetch(&phase, 0);
+        __sync_add_and_fetch(&readers[current & 1], 1);
+        if (__sync_add_and_fetch(&phase, 0) == current){
+            break;
+        }
+        __sync_sub_and_fetch(&readers[current & 1], 1);
+    }
+    SnapshotVersion *version = __sync_val_compare_and_swap(&latest, NULL, NULL);
+    if (version){
+        __sync_add_and_fetch(&version->refs, 1);
+    }
+    __sync_sub_and_fetch(&readers[current & 1], 1);
+    snapshot.adopt(version);
+    return version ? 1 : 0;
+}
+
+unsigned long long SnapshotPublisher::getEpoch(){
+    return this->epoch;
+}
+
+int SnapshotPublisher::getLive(){
+    return __sync_add_and_fetch(&live, 0);
+}
+
+int SnapshotPublisher::build(){
+    drop();
+    if (!db.getGraph()){
+        return -1;
+    }
+    ParentDag &dag = db.getParentDag();
+    if (!dag.isBuilt()){
+        return -1;
+    }
+    try{
+        for (int node = 0; node < dag.size(); node++){
+            if (!dag.isAlive(node)){
+                continue;
+            }
+            MemberClass data;
+            db.getSchema().readMember(db.getGraph(), dag.oidOf(node), data);
+            SnapshotMember &member = writable(node);
+            member.oid = dag.oidOf(node);
+            member.id = data.getId();
+            member.name = data.getName();
+            member.surname = data.getSurname();
+            member.parents = dag.getParents(node);
+            member.children = dag.getChildren(node);
+            nodes[member.oid] = node;
+            working.members++;
+        }
+    }catch(dex::gdb::Exception &e){
+        drop();
+        return -1;
+    }
+    int buckets = 64;
+    while (buckets * MembersPerBucket < working.members){
+        buckets *= 2;
+    }
+    index(buckets);
+    built = true;
+    epoch++;
+    return 1;
+}
+
+void SnapshotPublisher::index(int buckets){
+    for (size_t i = 0; i < working.ids.size(); i++){
+        unref(working.ids[i]);
+    }
+    for (size_t i = 0; i < working.names.size(); i++){
+        unref(working.names[i]);
+    }
+    working.ids.resize(buckets);
+    working.names.resize(buckets);
+    for (int i = 0; i < buckets; i++){
+        working.ids[i] = new IdBucket();
+        working.ids[i]->refs = 1;
+        working.names[i] = new NameBucket();
+        working.names[i]->refs = 1;
+        __sync_add_and_fetch(&live, 2);
+    }
+    for (size_t c = 0; c < working.chunks.size(); c++){
+        const vector<SnapshotMember> &members = working.chunks[c]->items;
+        for (size_t i = 0; i < members.size(); i++){
+            if (members[i].oid != dex::gdb::Objects::InvalidOID){
+                int node = static_cast<int>(c * RecordsPerChunk + i);
+                writableIds(members[i].id).push_back(make_pair(members[i].id, node));
+                writableNames(members[i].name).push_back(make_pair(members[i].name, node));
+            }
+        }
+    }
+}
+
+void SnapshotPublisher::changed(){
+    epoch++;
+    working.epoch = epoch;
+    swap(publish(working));
+}
+
+void SnapshotPublisher::swap(SnapshotVersion *version){
+    if (version){
+        // the slot's own reference
+        version->refs = 1;
+    }
+    SnapshotVersion *old = __sync_lock_test_and_set(&latest, version);
+    __sync_synchronize();
+    // a reader counted in under the old phase may have loaded old without
+    // taking its reference yet; the ones coming later see the flip and
+    // load the new version
+    int current = __sync_fetch_and_add(&phase, 1);
+    while (__sync_add_and_fetch(&readers[current & 1], 0) != 0){
+        sched_yield();
+    }
+    FamilySnapshot last;
+    last.adopt(old);
+}
+
+void SnapshotPublisher::place(int node, SnapshotMember &member){
+    writable(node) = member;
+    writableIds(member.id).push_back(make_pair(member.id, node));
+    writableNames(member.name).push_back(make_pair(member.name, node));
+    nodes[member.oid] = node;
+    working.members++;
+}
+
+SnapshotMember & SnapshotPublisher::writable(int node){
+    size_t chunk = static_cast<size_t>(node / RecordsPerChunk);
+    while (working.chunks.size() <= chunk){
+        SnapshotMember empty;
+        empty.oid = dex::gdb::Objects::InvalidOID;
+        empty.id = 0;
+        MemberChunk *added = new MemberChunk();
+        added->items.assign(RecordsPerChunk, empty);
+        added->refs = 1;
+        __sync_add_and_fetch(&live, 1);
+        working.chunks.push_back(added);
+    }
+    working.chunks[chunk] = own(working.chunks[chunk]);
+    return working.chunks[chunk]->items[node % RecordsPerChunk];
+}
+
+vector< pair<unsigned int, int> > & SnapshotPublisher::writableIds(unsigned int id){
+    size_t bucket = FamilySnapshot::idBucket(id, working.ids.size());
+    working.ids[bucket] = own(working.ids[bucket]);
+    return working.ids[bucket]->items;
+}
+
+vector< pair<string, int> > & SnapshotPublisher::writableNames(const string &name){
+    size_t bucket = FamilySnapshot::nameBucket(name, working.names.size());
+    working.names[bucket] = own(working.names[bucket]);
+    return working.names[bucket]->items;
+}
+
+void SnapshotPublisher::linkParent(int parent, int child, bool add){
+    if (add){
+        writable(child).parents.push_back(parent);
+        writable(parent).children.push_back(child);
+    }else{
+        eraseOne(writable(child).parents, parent);
+        eraseOne(writable(parent).children, child);
+    }
+}
+
+void SnapshotPublisher::drop(){
+    release(working);
+    working.members = 0;
+    nodes.clear();
+    built = false;
+}
+
+void SnapshotPublisher::memberAdded(dex::gdb::oid_t member, MemberClass &data){
+    if (!built){
+        return;
+    }
+    int node = db.getParentDag().indexOf(member);
+    if (node == -1){
+        drop();
+        return;
+    }
+    SnapshotMember added;
+    added.oid = member;
+    added.id = data.getId();
+    added.name = data.getName();
+    added.surname = data.getSurname();
+    place(node, added);
+    if (working.members > 2 * MembersPerBucket * static_cast<int>(working.ids.size())){
+        // a new bucket table once in a while, the members stay shared
+        index(2 * static_cast<int>(working.ids.size()));
+    }
+    changed();
+}
+
+void SnapshotPublisher::memberDeleted(dex::gdb::oid_t member){
+    if (!built){
+        return;
+    }
+    map<dex::gdb::oid_t, int>::iterator found = nodes.find(member);
+    if (found == nodes.end()){
+        drop();
+        return;
+    }
+    int node = found->second;
+    nodes.erase(found);
+    // DEX dropped the edges unannounced, the member's own lists say which
+    SnapshotMember gone = writable(node);
+    for (size_t i = 0; i < gone.parents.size(); i++){
+        eraseOne(writable(gone.parents[i]).children, node);
+    }
+    for (size_t i = 0; i < gone.children.size(); i++){
+        eraseOne(writable(gone.children[i]).parents, node);
+    }
+    eraseOne(writableIds(gone.id), make_pair(gone.id, node));
+    eraseOne(writableNames(gone.name), make_pair(gone.name, node));
+    SnapshotMember &empty = writable(node);
+    empty.oid = dex::gdb::Objects::InvalidOID;
+    empty.id = 0;
+    empty.name.clear();
+    empty.surname.clear();
+    empty.parents.clear();
+    empty.children.clear();
+    working.members--;
+    changed();
+}
+
+void SnapshotPublisher::relationAdded(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head){
+    if ((!built)||(relation != db.getSchema().getParentType())){
+        return;
+    }
+    map<dex::gdb::oid_t, int>::iterator parent = nodes.find(tail);
+    map<dex::gdb::oid_t, int>::iterator child = nodes.find(head);
+    if ((parent == nodes.end())||(child == nodes.end())){
+        drop();
+        return;
+    }
+    linkParent(parent->second, child->second, true);
+    changed();
+}
+
+void SnapshotPublisher::relationDeleted(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head){
+    if ((!built)||(relation != db.getSchema().getParentType())){
+        return;
+    }
+    map<dex::gdb::oid_t, int>::iterator parent = nodes.find(tail);
+    map<dex::gdb::oid_t, int>::iterator child = nodes.find(head);
+    if ((parent == nodes.end())||(child == nodes.end())){
+        drop();
+        return;
+    }
+    linkParent(parent->second, child->second, false);
+    changed();
+}
+
+void SnapshotPublisher::reset(){
+    // the snapshots handed out and the last published version stay
+    drop();
+}
+
+SnapshotVersion * SnapshotPublisher::publish(SnapshotVersion &working){
+    SnapshotVersion *version = new SnapshotVersion(working);
+    version->refs = 0;
+    __sync_add_and_fetch(&live, 1);
+    retain(*version);
+    return version;
+}
+
+void SnapshotPublisher::retain(SnapshotVersion &version){
+    for (size_t i = 0; i < version.chunks.size(); i++){
+        __sync_add_and_fetch(&version.chunks[i]->refs, 1);
+    }
+    for (size_t i = 0; i < version.ids.size(); i++){
+        __sync_add_and_fetch(&version.ids[i]->refs, 1);
+        __sync_add_and_fetch(&version.names[i]->refs, 1);
+    }
+}
+
+void SnapshotPublisher::release(SnapshotVersion &version){
+    for (size_t i = 0; i < version.chunks.size(); i++){
+        unref(version.chunks[i]);
+    }
+    for (size_t i = 0; i < version.ids.size(); i++){
+        unref(version.ids[i]);
+        unref(version.names[i]);
+    }
+    version.chunks.clear();
+    version.ids.clear();
+    version.names.clear();
+}
+
+template <class T> T * SnapshotPublisher::own(T *chunk){
+    if (__sync_add_and_fetch(&chunk->refs, 0) == 1){
+        return chunk;
+    }
+    // a published version still reads it, the working copy gets its own
+    T *copy = new T(*chunk);
+    copy->refs = 1;
+    __sync_add_and_fetch(&live, 1);
+    unref(chunk);
+    return copy;
+}
+
+template <class T> void SnapshotPublisher::eraseOne(vector<T> &items, const T &item){
+    for (size_t i = 0; i < items.size(); i++){
+        if (items[i] == item){
+            items[i] = items.back();
+            items.pop_back();
+            return;
+        }
+    }
+}
+
+template <class T> void SnapshotPublisher::unref(T *chunk){
+    if (__sync_sub_and_fetch(&chunk->refs, 1) == 0){
+        delete chunk;
+        __sync_sub_and_fetch(&live, 1);
+    }
+}
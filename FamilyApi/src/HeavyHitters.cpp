@@ -0,0 +1,109 @@
+#include "HeavyHitters.h"
+#include <algorithm>
+
+static bool moreFrequent(const HeavyHitter &a, const HeavyHitter &b){
+    return (a.count != b.count) ? (a.count > b.count) : (a.key < b.key);
+}
+
+HeavyHitters::HeavyHitters(int capacity)
+{
+    this->capacity=max(1, capacity);
+    total=0;
+}
+
+void HeavyHitters::clear(){
+    total = 0;
+    counters.clear();
+    heap.clear();
+    slot.clear();
+    index.clear();
+}
+
+void HeavyHitters::add(const string &key){
+    total++;
+    map<string, int>::iterator found = index.find(key);
+    if (found != index.end()){
+        counters[found->second].count++;
+        siftDown(slot[found->second]);
+        return;
+    }
+    if (static_cast<int>(counters.size()) < capacity){
+        // counts start at 1, the smallest one, so a new counter is a leaf
+        HeavyHitter counter;
+        counter.key = key;
+        counter.count = 1;
+        counter.error = 0;
+        int added = static_cast<int>(counters.size());
+        counters.push_back(counter);
+        index[key] = added;
+        slot.push_back(static_cast<int>(heap.size()));
+        heap.push_back(added);
+        for (int at = slot[added]; (at > 0)&&(counters[heap[(at - 1) / 2]].count > counters[heap[at]].count); at = (at - 1) / 2){
+            swapAt(at, (at - 1) / 2);
+        }
+        return;
+    }
+    int smallest = heap[0];
+    HeavyHitter &counter = counters[smallest];
+    index.erase(counter.key);
+    counter.key = key;
+    counter.error = counter.count;
+    counter.count++;
+    index[key] = smallest;
+    siftDown(0);
+}
+
+int HeavyHitters::getCapacity(){
+    return this->capacity;
+}
+
+long long HeavyHitters::getTotal(){
+    return this->total;
+}
+
+int HeavyHitters::estimate(const string &key, long long &count, long long &error){
+    map<string, int>::iterator found = index.find(key);
+    if (found == index.end()){
+        // not counted, so seen at most as often as the smallest counter
+        count = 0;
+        error = (static_cast<int>(counters.size()) < capacity) ? 0 : counters[heap[0]].count;
+        return 0;
+    }
+    count = counters[found->second].count;
+    error = counters[found->second].error;
+    return 1;
+}
+
+int HeavyHitters::top(int k, vector<HeavyHitter> &hitters){
+    hitters = counters;
+    int found = min(max(k, 0), static_cast<int>(hitters.size()));
+    partial_sort(hitters.begin(), hitters.begin() + found, hitters.end(), moreFrequent);
+    hitters.resize(found);
+    return found;
+}
+
+void HeavyHitters::siftDown(int at){
+    int size = static_cast<int>(heap.size());
+    while (true){
+        int smallest = at;
+        int left = 2 * at + 1;
+        int right = left + 1;
+        if ((left < size)&&(counters[heap[left]].count < counters[heap[smallest]].count)){
+            smallest = left;
+        }
+        if ((right < size)&&(counters[heap[right]].count < counters[heap[smallest]].count)){
+            smallest = right;
+        }
+        if (smallest == at){
+            return;
+        }
+        swapAt(at, smallest);
+        at = smallest;
+    }
+}
+
+void HeavyHitters::swapAt(int a, int b){
+    swap(heap[a], heap[b]);
+    slot[heap[a]] = a;
+    slot[heap[b]] = b;
+}
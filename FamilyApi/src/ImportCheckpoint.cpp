@@ -0,0 +1,237 @@
+#include "ImportCheckpoint.h"
+#include "dex/gdb/Objects.h"
+#include <cstdio>
+#include <cstring>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+ImportCheckpoint::ImportCheckpoint(string path)
+{
+    this->path = path;
+    phase = importMembers;
+    offset = 0;
+    row = 0;
+    batch = 0;
+    journalLength = 0;
+    imported = 0;
+    rejected = 0;
+}
+
+ImportPhase ImportCheckpoint::getPhase(){
+    return this->phase;
+}
+
+dex::gdb::int64_t ImportCheckpoint::getOffset(){
+    return this->offset;
+}
+
+dex::gdb::int32_t ImportCheckpoint::getRow(){
+    return this->row;
+}
+
+dex::gdb::int64_t ImportCheckpoint::getBatch(){
+    return this->batch;
+}
+
+dex::gdb::int64_t ImportCheckpoint::getImported(){
+    return this->imported;
+}
+
+dex::gdb::int64_t ImportCheckpoint::getRejected(){
+    return this->rejected;
+}
+
+void ImportCheckpoint::setCounts(dex::gdb::int64_t imported, dex::gdb::int64_t rejected){
+    this->imported = imported;
+    this->rejected = rejected;
+}
+
+void ImportCheckpoint::advance(ImportPhase phase, dex::gdb::int64_t offset, dex::gdb::int32_t row){
+    this->phase = phase;
+    this->offset = offset;
+    this->row = row;
+    this->batch++;
+}
+
+void ImportCheckpoint::mapId(unsigned int id, dex::gdb::oid_t oid){
+    char line[64];
+    sprintf(line, "%u %lld\n", id, static_cast<long long>(oid));
+    pending += line;
+    ids[id] = oid;
+}
+
+dex::gdb::oid_t ImportCheckpoint::findId(unsigned int id){
+    map<unsigned int, dex::gdb::oid_t>::iterator found = ids.find(id);
+    if (found == ids.end()){
+        return dex::gdb::Objects::InvalidOID;
+    }
+    return found->second;
+}
+
+int ImportCheckpoint::discard(){
+    // back to the ids of the last save
+    return readJournal();
+}
+
+string ImportCheckpoint::slotPath(dex::gdb::int64_t batch){
+    return path + ((batch % 2 == 0) ? ".0" : ".1");
+}
+
+string ImportCheckpoint::journalPath(){
+    return path + ".ids";
+}
+
+string ImportCheckpoint::format(){
+    char text[256];
+    sprintf(text, "batch %lld\nphase %d\noffset %lld\nrow %d\njournal %lld\nimported %lld\nrejected %lld\n",
+            static_cast<long long>(batch), static_cast<int>(phase), static_cast<long long>(offset),
+            static_cast<int>(row), static_cast<long long>(journalLength),
+            static_cast<long long>(imported), static_cast<long long>(rejected));
+    return text;
+}
+
+unsigned int ImportCheckpoint::checksum(const string &text){
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < text.size(); i++){
+        hash ^= static_cast<unsigned char>(text[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+int ImportCheckpoint::syncFile(FILE *file){
+    if (fflush(file) != 0){
+        return -1;
+    }
+#ifdef _WIN32
+    return (_commit(_fileno(file)) == 0) ? 1 : -1;
+#else
+    return (fsync(fileno(file)) == 0) ? 1 : -1;
+#endif
+}
+
+int ImportCheckpoint::save(){
+    // journal first: a checkpoint must never point past synced id map bytes
+    if (!pending.empty()){
+        FILE *journal = fopen(journalPath().c_str(), "r+b");
+        if (!journal){
+            journal = fopen(journalPath().c_str(), "w+b");
+        }
+        if (!journal){
+            return -1;
+        }
+        bool written = (fseek(journal, static_cast<long>(journalLength), SEEK_SET) == 0)
+                && (fwrite(pending.data(), 1, pending.size(), journal) == pending.size())
+                && (syncFile(journal) == 1);
+        fclose(journal);
+        if (!written){
+            return -1;
+        }
+        journalLength += pending.size();
+        pending.clear();
+    }
+
+    string text = format();
+    char sum[32];
+    sprintf(sum, "sum %08x\n", checksum(text));
+    text += sum;
+
+    FILE *slot = fopen(slotPath(batch).c_str(), "wb");
+    if (!slot){
+        return -1;
+    }
+    bool written = (fwrite(text.data(), 1, text.size(), slot) == text.size()) && (syncFile(slot) == 1);
+    fclose(slot);
+    return written ? 1 : -1;
+}
+
+int ImportCheckpoint::readSlot(string path, dex::gdb::int64_t &batch){
+    FILE *slot = fopen(path.c_str(), "rb");
+    if (!slot){
+        return 0;
+    }
+    char text[512];
+    size_t length = fread(text, 1, sizeof(text) - 1, slot);
+    fclose(slot);
+    text[length] = '\0';
+
+    long long readBatch, readOffset, readJournal, readImported, readRejected;
+    int readPhase, readRow;
+    unsigned int readSum;
+    if (sscanf(text, "batch %lld\nphase %d\noffset %lld\nrow %d\njournal %lld\nimported %lld\nrejected %lld\nsum %x",
+               &readBatch, &readPhase, &readOffset, &readRow, &readJournal, &readImported, &readRejected, &readSum) != 8){
+        return 0;
+    }
+    const char *sum = strstr(text, "sum ");
+    if (checksum(string(text, sum - text)) != readSum){
+        return 0;
+    }
+    if (readBatch <= batch){
+        return 0;
+    }
+
+    batch = readBatch;
+    this->batch = readBatch;
+    this->phase = static_cast<ImportPhase>(readPhase);
+    this->offset = readOffset;
+    this->row = readRow;
+    this->journalLength = readJournal;
+    this->imported = readImported;
+    this->rejected = readRejected;
+    return 1;
+}
+
+int ImportCheckpoint::readJournal(){
+    ids.clear();
+    pending.clear();
+    if (journalLength == 0){
+        return 1;
+    }
+    FILE *journal = fopen(journalPath().c_str(), "rb");
+    if (!journal){
+        return -1;
+    }
+    dex::gdb::int64_t position = 0;
+    char line[64];
+    while ((position < journalLength)&&(fgets(line, sizeof(line), journal))){
+        unsigned int id;
+        long long oid;
+        if (sscanf(line, "%u %lld", &id, &oid) != 2){
+            fclose(journal);
+            return -1;
+        }
+        ids[id] = oid;
+        position += strlen(line);
+    }
+    fclose(journal);
+    return (position == journalLength) ? 1 : -1;
+}
+
+int ImportCheckpoint::load(){
+    dex::gdb::int64_t latest = 0;
+    int found = readSlot(slotPath(0), latest);
+    found |= readSlot(slotPath(1), latest);
+    if (!found){
+        return 0;
+    }
+    return readJournal();
+}
+
+int ImportCheckpoint::clear(){
+    remove(slotPath(0).c_str());
+    remove(slotPath(1).c_str());
+    remove(journalPath().c_str());
+    phase = importMembers;
+    offset = 0;
+    row = 0;
+    batch = 0;
+    journalLength = 0;
+    imported = 0;
+    rejected = 0;
+    ids.clear();
+    pending.clear();
+    return 1;
+}
@@ -0,0 +1,314 @@
+#include "KinshipCoefficients.h"
+#include <algorithm>
+#include <pthread.h>
+
+const int KinshipCoefficients::Block = 64;
+const size_t KinshipCoefficients::MemoLimit = 4000000;
+
+KinshipCoefficients::KinshipCoefficients(ParentDag &dag, TopologicalOrder &order)
+: dag(dag), order(order)
+{
+    threads=1;
+    matrix=NULL;
+    nextColumn=0;
+}
+
+void KinshipCoefficients::setThreads(int threads){
+    this->threads = (threads < 1) ? 1 : threads;
+}
+
+int KinshipCoefficients::ready(){
+    if (dag.build() == -1){
+        return -1;
+    }
+    if (memo.size() > MemoLimit){
+        memo.clear();
+    }
+    return 1;
+}
+
+int KinshipCoefficients::kinship(dex::gdb::oid_t member_1, dex::gdb::oid_t member_2, double &coefficient){
+    if (ready() == -1){
+        return -1;
+    }
+    int node_1 = dag.indexOf(member_1);
+    int node_2 = dag.indexOf(member_2);
+    if ((node_1 == -1)||(node_2 == -1)||(order.positionOf(node_1) == -1)){
+        return -1;
+    }
+    coefficient = evaluate(node_1, node_2, memo);
+    return 1;
+}
+
+int KinshipCoefficients::inbreeding(dex::gdb::oid_t member, double &coefficient){
+    if (ready() == -1){
+        return -1;
+    }
+    int node = dag.indexOf(member);
+    if ((node == -1)||(order.positionOf(node) == -1)){
+        return -1;
+    }
+    const vector<int> &parents = dag.getParents(node);
+    coefficient = (parents.size() < 2) ? 0.0 : evaluate(parents[0], parents[1], memo);
+    return 1;
+}
+
+int KinshipCoefficients::kinshipMatrix(const vector<dex::gdb::oid_t> &members, vector<double> &matrix){
+    if ((dag.build() == -1)||(collectAncestors(members) == -1)){
+        return -1;
+    }
+    computeVariances();
+    size_t count = members.size();
+    matrix.assign(count * count, 0.0);
+    this->matrix = &matrix;
+    nextColumn = 0;
+
+    vector<pthread_t> workers(threads - 1);
+    int started = 0;
+    for (int i = 0; i < threads - 1; i++){
+        if (pthread_create(&workers[started], NULL, worker, this) == 0){
+            started++;
+        }
+    }
+    // the calling thread takes columns too, alone if no thread started
+    worker(this);
+    for (int i = 0; i < started; i++){
+        pthread_join(workers[i], NULL);
+    }
+    this->matrix = NULL;
+    return 1;
+}
+
+int KinshipCoefficients::collectAncestors(const vector<dex::gdb::oid_t> &members){
+    vector<int> nodes;
+    map<int, int> rowOf;
+    for (size_t i = 0; i < members.size(); i++){
+        int node = dag.indexOf(members[i]);
+        if ((node == -1)||(order.positionOf(node) == -1)){
+            return -1;
+        }
+        if (rowOf.insert(make_pair(node, 0)).second){
+            nodes.push_back(node);
+        }
+    }
+    for (size_t i = 0; i < nodes.size(); i++){
+        const vector<int> &parents = dag.getParents(nodes[i]);
+        for (size_t p = 0; (p < parents.size())&&(p < 2); p++){
+            if (rowOf.insert(make_pair(parents[p], 0)).second){
+                nodes.push_back(parents[p]);
+            }
+        }
+    }
+
+    // generation order, every parent gets a lower row than its children
+    vector<Pair> ranked;
+    ranked.reserve(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++){
+        ranked.push_back(Pair(order.positionOf(nodes[i]), nodes[i]));
+    }
+    sort(ranked.begin(), ranked.end());
+    for (size_t row = 0; row < ranked.size(); row++){
+        rowOf[ranked[row].second] = static_cast<int>(row);
+    }
+    sire.assign(ranked.size(), -1);
+    dam.assign(ranked.size(), -1);
+    for (size_t row = 0; row < ranked.size(); row++){
+        const vector<int> &parents = dag.getParents(ranked[row].second);
+        if (parents.size() > 0){
+            sire[row] = rowOf[parents[0]];
+        }
+        if (parents.size() > 1){
+            dam[row] = rowOf[parents[1]];
+        }
+    }
+    selectedRow.resize(members.size());
+    for (size_t i = 0; i < members.size(); i++){
+        selectedRow[i] = rowOf[dag.indexOf(members[i])];
+    }
+    return 1;
+}
+
+void KinshipCoefficients::computeVariances(){
+    // Meuwissen & Luo: 1 + F(i) is the sum of L(i, j)^2 D(j) over i and its
+    // ancestors j, where L(i, j) is the share of j's genes in i. The
+    // ancestors are visited from the youngest down so every share is
+    // complete when it is used.
+    int rows = static_cast<int>(sire.size());
+    vector<double> inbred(rows, 0.0);
+    vector<double> share(rows, 0.0);
+    vector<char> queued(rows, 0);
+    variance.assign(rows, 1.0);
+    for (int row = 0; row < rows; row++){
+        int father = sire[row];
+        int mother = dam[row];
+        if ((father != -1)&&(mother != -1)){
+            variance[row] = 0.5 - 0.25 * (inbred[father] + inbred[mother]);
+        }else if ((father != -1)||(mother != -1)){
+            variance[row] = 0.75 - 0.25 * inbred[(father != -1) ? father : mother];
+        }
+        if ((father == -1)||(mother == -1)){
+            continue;
+        }
+        double sum = 0.0;
+        vector<int> heap(1, row);
+        share[row] = 1.0;
+        while (!heap.empty()){
+            pop_heap(heap.begin(), heap.end());
+            int next = heap.back();
+            heap.pop_back();
+            sum += share[next] * share[next] * variance[next];
+            int parents[2] = {sire[next], dam[next]};
+            for (int p = 0; p < 2; p++){
+                if (parents[p] == -1){
+                    continue;
+                }
+                share[parents[p]] += share[next] / 2.0;
+                if (!queued[parents[p]]){
+                    queued[parents[p]] = 1;
+                    heap.push_back(parents[p]);
+                    push_heap(heap.begin(), heap.end());
+                }
+            }
+            share[next] = 0.0;
+            queued[next] = 0;
+        }
+        inbred[row] = sum - 1.0;
+    }
+}
+
+void * KinshipCoefficients::worker(void *coefficients){
+    KinshipCoefficients *self = static_cast<KinshipCoefficients *>(coefficients);
+    vector<double> work;
+    int count = static_cast<int>(self->selectedRow.size());
+    for (;;){
+        int first = __sync_fetch_and_add(&self->nextColumn, Block);
+        if (first >= count){
+            break;
+        }
+        self->fillColumns(first, work);
+    }
+    return NULL;
+}
+
+void KinshipCoefficients::fillColumns(int first, vector<double> &work){
+    // 2A x = T (D (T' x)) for the unit vectors of Block selected members
+    // at once, row r of the work area holds the Block values of member r
+    int count = static_cast<int>(selectedRow.size());
+    int columns = min(Block, count - first);
+    int rows = static_cast<int>(sire.size());
+    work.assign(static_cast<size_t>(rows) * Block, 0.0);
+    int highest = 0;
+    for (int k = 0; k < columns; k++){
+        int row = selectedRow[first + k];
+        work[static_cast<size_t>(row) * Block + k] = 1.0;
+        highest = max(highest, row);
+    }
+    for (int row = highest; row >= 0; row--){
+        double *cell = &work[static_cast<size_t>(row) * Block];
+        int parents[2] = {sire[row], dam[row]};
+        for (int p = 0; p < 2; p++){
+            if (parents[p] != -1){
+                double *up = &work[static_cast<size_t>(parents[p]) * Block];
+                for (int k = 0; k < columns; k++){
+                    up[k] += cell[k] / 2.0;
+                }
+            }
+        }
+    }
+    for (int row = 0; row < rows; row++){
+        double *cell = &work[static_cast<size_t>(row) * Block];
+        for (int k = 0; k < columns; k++){
+            cell[k] *= variance[row];
+        }
+        int parents[2] = {sire[row], dam[row]};
+        for (int p = 0; p < 2; p++){
+            if (parents[p] != -1){
+                const double *up = &work[static_cast<size_t>(parents[p]) * Block];
+                for (int k = 0; k < columns; k++){
+                    cell[k] += up[k] / 2.0;
+                }
+            }
+        }
+    }
+    vector<double> &cells = *matrix;
+    for (int i = 0; i < count; i++){
+        const double *cell = &work[static_cast<size_t>(selectedRow[i]) * Block];
+        for (int k = 0; k < columns; k++){
+            cells[static_cast<size_t>(i) * count + first + k] = cell[k] / 2.0;
+        }
+    }
+}
+
+KinshipCoefficients::Pair KinshipCoefficients::key(int node_1, int node_2){
+    return (node_1 < node_2) ? Pair(node_1, node_2) : Pair(node_2, node_1);
+}
+
+double KinshipCoefficients::evaluate(int node_1, int node_2, Memo &memo){
+    Pair wanted = key(node_1, node_2);
+    vector<Pair> stack(1, wanted);
+    while (!stack.empty()){
+        Pair top = stack.back();
+        if (memo.find(top) != memo.end()){
+            stack.pop_back();
+            continue;
+        }
+        // expand the member drawn later, it cannot be an ancestor of the other
+        int later = top.first;
+        int other = top.second;
+        if (order.positionOf(later) < order.positionOf(other)){
+            later = top.second;
+            other = top.first;
+        }
+        const vector<int> &parents = dag.getParents(later);
+        size_t known = min(parents.size(), static_cast<size_t>(2));
+        Pair needs[2];
+        size_t count = 0;
+        if (later == other){
+            if (known == 2){
+                needs[count++] = key(parents[0], parents[1]);
+            }
+        }else{
+            for (size_t i = 0; i < known; i++){
+                needs[count++] = key(parents[i], other);
+            }
+        }
+
+        double sum = 0.0;
+        bool missing = false;
+        for (size_t i = 0; i < count; i++){
+            Memo::iterator found = memo.find(needs[i]);
+            if (found == memo.end()){
+                stack.push_back(needs[i]);
+                missing = true;
+            }else{
+                sum += found->second;
+            }
+        }
+        if (missing){
+            continue;
+        }
+        memo[top] = (later == other) ? (1.0 + sum) / 2.0 : sum / 2.0;
+        stack.pop_back();
+    }
+    return memo[wanted];
+}
+
+void KinshipCoefficients::memberDeleted(dex::gdb::oid_t member){
+    memo.clear();
+}
+
+void KinshipCoefficients::relationAdded(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head){
+    if (relation == dag.getParentType()){
+        memo.clear();
+    }
+}
+
+void KinshipCoefficients::relationDeleted(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head){
+    if (relation == dag.getParentType()){
+        memo.clear();
+    }
+}
+
+void KinshipCoefficients::reset(){
+    memo.clear();
+}
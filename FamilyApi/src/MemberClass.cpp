@@ -4,6 +4,8 @@ MemberClass::MemberClass()
 {
     relationTo=NULL;
     sex=nn;
+    id=0;
+    partnerId=0;
 }
 
 MemberClass::~MemberClass()
@@ -12,3 +14,59 @@ MemberClass::~MemberClass()
         delete relationTo;
     }
 }
+
+unsigned int MemberClass::getId(){
+    return this->id;
+}
+
+void MemberClass::setId(unsigned int id){
+    this->id = id;
+}
+
+string MemberClass::getName(){
+    return this->name;
+}
+
+void MemberClass::setName(string name){
+    this->name = name;
+}
+
+string MemberClass::getSurname(){
+    return this->surname;
+}
+
+void MemberClass::setSurname(string surname){
+    this->surname = surname;
+}
+
+Sex MemberClass::getSex(){
+    return this->sex;
+}
+
+void MemberClass::setSex(Sex sex){
+    this->sex = sex;
+}
+
+DateClass MemberClass::getBirthDate(){
+    return this->birthDate;
+}
+
+void MemberClass::setBirthDate(DateClass birthDate){
+    this->birthDate = birthDate;
+}
+
+DateClass MemberClass::getHeavenDate(){
+    return this->heavenDate;
+}
+
+void MemberClass::setHeavenDate(DateClass heavenDate){
+    this->heavenDate = heavenDate;
+}
+
+unsigned int MemberClass::getPartnerId(){
+    return this->partnerId;
+}
+
+void MemberClass::setPartnerId(unsigned int partnerId){
+    this->partnerId = partnerId;
+}
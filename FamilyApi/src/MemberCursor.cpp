@@ -0,0 +1,154 @@
+#include "MemberCursor.h"
+#include <algorithm>
+
+const int MemberCursor::BlockSize = 256;
+
+MemberCursor::MemberCursor()
+{
+    graph=NULL;
+    schema=NULL;
+    members=NULL;
+    it=NULL;
+    blockAt=0;
+    last=dex::gdb::Objects::InvalidOID;
+}
+
+MemberCursor::~MemberCursor()
+{
+    close();
+}
+
+void MemberCursor::open(dex::gdb::Graph *graph, DexSchema *schema, dex::gdb::Objects *members){
+    close();
+    this->graph = graph;
+    this->schema = schema;
+    this->members = members;
+    restart(members->Iterator());
+}
+
+void MemberCursor::close(){
+    // the iterator has to go before the set it walks
+    delete it;
+    delete members;
+    it = NULL;
+    members = NULL;
+    block.clear();
+    blockAt = 0;
+    last = dex::gdb::Objects::InvalidOID;
+}
+
+bool MemberCursor::isOpen(){
+    return members != NULL;
+}
+
+dex::gdb::int64_t MemberCursor::count(){
+    if (!members){
+        return -1;
+    }
+    try{
+        return members->Count();
+    }catch(dex::gdb::Exception &e){
+        return -1;
+    }
+}
+
+int MemberCursor::seek(dex::gdb::int64_t index){
+    if ((!members)||(index < 0)){
+        return -1;
+    }
+    try{
+        if (index >= members->Count()){
+            restart(NULL);
+            return 0;
+        }
+        restart(members->IteratorFromIndex(index));
+    }catch(dex::gdb::Exception &e){
+        restart(NULL);
+        return -1;
+    }
+    return 1;
+}
+
+int MemberCursor::seekAfter(dex::gdb::oid_t last){
+    if (!members){
+        return -1;
+    }
+    try{
+        if (!members->Exists(last)){
+            return 0;
+        }
+        // the iterator starts at the element itself
+        restart(members->IteratorFromElement(last));
+        if (it->HasNext()){
+            it->Next();
+        }
+        this->last = last;
+    }catch(dex::gdb::Exception &e){
+        restart(NULL);
+        return -1;
+    }
+    return 1;
+}
+
+int MemberCursor::next(int max, vector<dex::gdb::oid_t> &page){
+    page.clear();
+    if (!members){
+        return -1;
+    }
+    try{
+        while ((static_cast<int>(page.size()) < max)&&((blockAt < block.size())||(fill()))){
+            size_t take = min(block.size() - blockAt, static_cast<size_t>(max) - page.size());
+            page.insert(page.end(), block.begin() + blockAt, block.begin() + blockAt + take);
+            blockAt += take;
+        }
+    }catch(dex::gdb::Exception &e){
+        page.clear();
+        return -1;
+    }
+    if (!page.empty()){
+        last = page.back();
+    }
+    return static_cast<int>(page.size());
+}
+
+int MemberCursor::next(int max, vector<MemberClass> &page){
+    vector<dex::gdb::oid_t> oids;
+    int found = next(max, oids);
+    page.clear();
+    if (found <= 0){
+        return found;
+    }
+    try{
+        page.resize(found);
+        for (int i = 0; i < found; i++){
+            schema->readMember(graph, oids[i], page[i]);
+        }
+    }catch(dex::gdb::Exception &e){
+        page.clear();
+        return -1;
+    }
+    return found;
+}
+
+dex::gdb::oid_t MemberCursor::getLast(){
+    return this->last;
+}
+
+void MemberCursor::restart(dex::gdb::ObjectsIterator *from){
+    delete it;
+    it = from;
+    block.clear();
+    blockAt = 0;
+}
+
+bool MemberCursor::fill(){
+    block.clear();
+    blockAt = 0;
+    if (!it){
+        return false;
+    }
+    while ((static_cast<int>(block.size()) < BlockSize)&&(it->HasNext())){
+        block.push_back(it->Next());
+    }
+    return !block.empty();
+}
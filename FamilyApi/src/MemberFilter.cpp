@@ -0,0 +1,187 @@
+#include "MemberFilter.h"
+#include "dex/gdb/Values.h"
+#include "dex/gdb/ValuesIterator.h"
+#include <algorithm>
+
+const int MemberFilter::SlotsPerBucket = 4;
+const int MemberFilter::MaxKicks = 500;
+
+MemberFilter::MemberFilter()
+{
+    graph=NULL;
+    schema=NULL;
+    built=false;
+    mask=0;
+    count=0;
+    minimum=1024;
+    random=2463534242u;
+}
+
+void MemberFilter::attach(dex::gdb::Graph *graph, DexSchema *schema){
+    this->graph = graph;
+    this->schema = schema;
+    minimum = 1024;
+    clear();
+}
+
+bool MemberFilter::isBuilt(){
+    return this->built;
+}
+
+void MemberFilter::clear(){
+    slots.clear();
+    mask = 0;
+    count = 0;
+    built = false;
+}
+
+int MemberFilter::build(){
+    if (built){
+        return 1;
+    }
+    if ((!graph)||(!schema)){
+        return -1;
+    }
+    dex::gdb::Values *values = NULL;
+    dex::gdb::ValuesIterator *it = NULL;
+    try{
+        values = graph->GetValues(schema->getIdAttr());
+        int ids = static_cast<int>(values->Count());
+        // half full, so members can be added for a while before it grows
+        resize(2 * ids);
+        built = true;
+        it = values->Iterator(dex::gdb::Ascendent);
+        while ((built)&&(it->HasNext())){
+            dex::gdb::Value *value = it->Next();
+            if (!value->IsNull()){
+                insert(static_cast<unsigned int>(value->GetLong()));
+            }
+            delete value;
+        }
+        delete it;
+        delete values;
+    }catch(dex::gdb::Exception &e){
+        delete it;
+        delete values;
+        clear();
+        return -1;
+    }
+    // an insert that found no room unset built and raised the minimum
+    return built ? 1 : build();
+}
+
+int MemberFilter::mayContain(unsigned int id){
+    if ((!built)&&(build() == -1)){
+        return -1;
+    }
+    unsigned long long bits = hash(id);
+    unsigned short fingerprint = fingerprintOf(bits);
+    size_t bucket = static_cast<size_t>(bits) & mask;
+    return (find(bucket, fingerprint)||find(alternate(bucket, fingerprint), fingerprint)) ? 1 : 0;
+}
+
+void MemberFilter::insert(unsigned int id){
+    if (!built){
+        return;
+    }
+    unsigned long long bits = hash(id);
+    unsigned short fingerprint = fingerprintOf(bits);
+    size_t bucket = static_cast<size_t>(bits) & mask;
+    if ((place(bucket, fingerprint))||(place(alternate(bucket, fingerprint), fingerprint))){
+        count++;
+        return;
+    }
+    // move a resident to its other bucket until one has room
+    for (int kick = 0; kick < MaxKicks; kick++){
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        unsigned short &slot = slots[bucket * SlotsPerBucket + random % SlotsPerBucket];
+        unsigned short evicted = slot;
+        slot = fingerprint;
+        fingerprint = evicted;
+        bucket = alternate(bucket, fingerprint);
+        if (place(bucket, fingerprint)){
+            count++;
+            return;
+        }
+    }
+    // the fingerprint in hand would be lost, the filter is filled again
+    minimum = 2 * static_cast<int>(slots.size());
+    clear();
+}
+
+void MemberFilter::remove(unsigned int id){
+    if (!built){
+        return;
+    }
+    unsigned long long bits = hash(id);
+    unsigned short fingerprint = fingerprintOf(bits);
+    size_t buckets[2];
+    buckets[0] = static_cast<size_t>(bits) & mask;
+    buckets[1] = alternate(buckets[0], fingerprint);
+    for (int b = 0; b < 2; b++){
+        for (int i = 0; i < SlotsPerBucket; i++){
+            if (slots[buckets[b] * SlotsPerBucket + i] == fingerprint){
+                slots[buckets[b] * SlotsPerBucket + i] = 0;
+                count--;
+                return;
+            }
+        }
+    }
+}
+
+int MemberFilter::size(){
+    return this->count;
+}
+
+void MemberFilter::resize(int ids){
+    size_t buckets = 1;
+    while (static_cast<int>(buckets) * SlotsPerBucket < max(ids, minimum)){
+        buckets *= 2;
+    }
+    slots.assign(buckets * SlotsPerBucket, 0);
+    mask = buckets - 1;
+    count = 0;
+}
+
+bool MemberFilter::place(size_t bucket, unsigned short fingerprint){
+    for (int i = 0; i < SlotsPerBucket; i++){
+        unsigned short &slot = slots[bucket * SlotsPerBucket + i];
+        if (slot == 0){
+            slot = fingerprint;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MemberFilter::find(size_t bucket, unsigned short fingerprint){
+    for (int i = 0; i < SlotsPerBucket; i++){
+        if (slots[bucket * SlotsPerBucket + i] == fingerprint){
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t MemberFilter::alternate(size_t bucket, unsigned short fingerprint){
+    // the same either way round, so a moved fingerprint finds its way back
+    return (bucket ^ static_cast<size_t>(fingerprint * 0x5bd1e995u)) & mask;
+}
+
+unsigned long long MemberFilter::hash(unsigned int id){
+    unsigned long long bits = id;
+    bits ^= bits >> 33;
+    bits *= 0xff51afd7ed558ccdULL;
+    bits ^= bits >> 33;
+    bits *= 0xc4ceb9fe1a85ec53ULL;
+    bits ^= bits >> 33;
+    return bits;
+}
+
+unsigned short MemberFilter::fingerprintOf(unsigned long long bits){
+    // 0 marks an empty slot
+    unsigned short fingerprint = static_cast<unsigned short>(bits >> 48);
+    return (fingerprint == 0) ? 1 : fingerprint;
+}
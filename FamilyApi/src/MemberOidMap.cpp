@@ -0,0 +1,129 @@
+#include "MemberOidMap.h"
+#include "dex/gdb/Objects.h"
+#include <algorithm>
+
+const int MemberOidMap::InitialSlots = 1024;
+
+MemberOidMap::MemberOidMap()
+{
+    mask=0;
+    shift=0;
+    count=0;
+}
+
+dex::gdb::oid_t MemberOidMap::find(unsigned int id){
+    if (slots.empty()){
+        return dex::gdb::Objects::InvalidOID;
+    }
+    size_t slot = home(id);
+    for (size_t probe = 0; ; probe++){
+        const Slot &current = slots[slot];
+        // a free slot, or an entry nearer its home than id would be here
+        if ((current.oid == dex::gdb::Objects::InvalidOID)||(distance(slot) < probe)){
+            return dex::gdb::Objects::InvalidOID;
+        }
+        if (current.id == id){
+            return current.oid;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+void MemberOidMap::put(unsigned int id, dex::gdb::oid_t oid){
+    if (oid == dex::gdb::Objects::InvalidOID){
+        return;
+    }
+    if ((slots.empty())||(4 * static_cast<size_t>(count + 1) > 3 * slots.size())){
+        resize(slots.empty() ? InitialSlots : 2 * slots.size());
+    }
+    Slot moving;
+    moving.id = id;
+    moving.oid = oid;
+    size_t slot = home(id);
+    for (size_t probe = 0; ; probe++){
+        Slot &current = slots[slot];
+        if (current.oid == dex::gdb::Objects::InvalidOID){
+            current = moving;
+            count++;
+            return;
+        }
+        // only the new entry can meet its own id, the ones it moves are unique
+        if (current.id == moving.id){
+            current.oid = moving.oid;
+            return;
+        }
+        size_t resident = distance(slot);
+        if (resident < probe){
+            swap(current, moving);
+            probe = resident;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+void MemberOidMap::erase(unsigned int id){
+    if (slots.empty()){
+        return;
+    }
+    size_t slot = home(id);
+    for (size_t probe = 0; ; probe++){
+        const Slot &current = slots[slot];
+        if ((current.oid == dex::gdb::Objects::InvalidOID)||(distance(slot) < probe)){
+            return;
+        }
+        if (current.id == id){
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    // pull the run behind it one slot back, until a free slot or an entry
+    // already at home
+    size_t next = (slot + 1) & mask;
+    while ((slots[next].oid != dex::gdb::Objects::InvalidOID)&&(distance(next) > 0)){
+        slots[slot] = slots[next];
+        slot = next;
+        next = (next + 1) & mask;
+    }
+    slots[slot].oid = dex::gdb::Objects::InvalidOID;
+    count--;
+}
+
+void MemberOidMap::clear(){
+    slots.clear();
+    mask = 0;
+    shift = 0;
+    count = 0;
+}
+
+int MemberOidMap::size(){
+    return this->count;
+}
+
+void MemberOidMap::resize(size_t size){
+    vector<Slot> old;
+    old.swap(slots);
+    Slot free;
+    free.id = 0;
+    free.oid = dex::gdb::Objects::InvalidOID;
+    slots.assign(size, free);
+    mask = size - 1;
+    shift = 64;
+    for (size_t bits = size; bits > 1; bits >>= 1){
+        shift--;
+    }
+    count = 0;
+    for (size_t i = 0; i < old.size(); i++){
+        if (old[i].oid != dex::gdb::Objects::InvalidOID){
+            put(old[i].id, old[i].oid);
+        }
+    }
+}
+
+size_t MemberOidMap::home(unsigned int id){
+    // Fibonacci hashing, the top bits spread consecutive ids apart
+    return static_cast<size_t>((id * 0x9e3779b97f4a7c15ULL) >> shift);
+}
+
+size_t MemberOidMap::distance(size_t slot){
+    return (slot - home(slots[slot].id)) & mask;
+}
@@ -0,0 +1,301 @@
+#include "MemberQuery.h"
+#include "Utf8Codec.h"
+#include "dex/gdb/Graph_data.h"
+#include "dex/gdb/Objects.h"
+#include "dex/gdb/ObjectsIterator.h"
+#include <algorithm>
+#include <cstdio>
+
+const double MemberQuery::IntersectCost = 0.25;
+const double MemberQuery::CheckCost = 1.0;
+
+MemberQuery::MemberQuery(DexDBWrapper &db)
+: db(db)
+{
+    executed=false;
+    changes=0;
+    db.registerListener(*this);
+}
+
+MemberQuery::~MemberQuery()
+{
+    db.unregisterListener(*this);
+}
+
+void MemberQuery::clear(){
+    conditions.clear();
+    plan.clear();
+    executed = false;
+}
+
+int MemberQuery::whereName(string name){
+    if (!db.getGraph()){
+        return -1;
+    }
+    Condition condition;
+    condition.lower.SetString(Utf8Codec::decode(name));
+    return add(condition, db.getSchema().getNameAttr(), false, "name = " + name);
+}
+
+int MemberQuery::whereSurname(string surname){
+    if (!db.getGraph()){
+        return -1;
+    }
+    Condition condition;
+    condition.lower.SetString(Utf8Codec::decode(surname));
+    return add(condition, db.getSchema().getSurnameAttr(), false, "surname = " + surname);
+}
+
+int MemberQuery::whereSex(Sex sex){
+    if ((!db.getGraph())||(sex == nn)){
+        return -1;
+    }
+    Condition condition;
+    condition.lower.SetInteger(sex);
+    return add(condition, db.getSchema().getSexAttr(), false, (sex == male) ? "sex = male" : "sex = female");
+}
+
+int MemberQuery::whereBornBetween(int firstYear, int lastYear){
+    return yearRange(db.getSchema().getBirthAttr(), firstYear, lastYear, "birth");
+}
+
+int MemberQuery::whereDiedBetween(int firstYear, int lastYear){
+    return yearRange(db.getSchema().getHeavenAttr(), firstYear, lastYear, "heaven");
+}
+
+int MemberQuery::yearRange(dex::gdb::attr_t attr, int firstYear, int lastYear, string text){
+    if ((!db.getGraph())||(firstYear > lastYear)){
+        return -1;
+    }
+    Condition condition;
+    condition.lower.SetTimestamp(DexSchema::timestampOf(firstYear, 1, 1));
+    // the last millisecond of the last year
+    condition.higher.SetTimestamp(DexSchema::timestampOf(lastYear + 1, 1, 1) - 1);
+    char years[32];
+    sprintf(years, " %d..%d", firstYear, lastYear);
+    return add(condition, attr, true, text + years);
+}
+
+int MemberQuery::add(Condition &condition, dex::gdb::attr_t attr, bool range, string text){
+    condition.attr = attr;
+    condition.range = range;
+    condition.text = text;
+    condition.estimate = 0.0;
+    conditions.push_back(condition);
+    plan.clear();
+    executed = false;
+    return 1;
+}
+
+int MemberQuery::count(){
+    dex::gdb::Objects *found = execute();
+    if (!found){
+        return -1;
+    }
+    int count = static_cast<int>(found->Count());
+    delete found;
+    return count;
+}
+
+int MemberQuery::open(MemberCursor &cursor){
+    cursor.close();
+    dex::gdb::Objects *found = execute();
+    if (!found){
+        return -1;
+    }
+    cursor.open(db.getGraph(), &db.getSchema(), found);
+    return static_cast<int>(cursor.count());
+}
+
+string MemberQuery::explain(){
+    if ((!executed)&&(!conditions.empty())){
+        try{
+            makePlan();
+        }catch(dex::gdb::Exception &e){
+            return "no plan\n";
+        }
+    }
+    if (plan.empty()){
+        return "no conditions\n";
+    }
+    string text;
+    char line[64];
+    for (size_t i = 0; i < plan.size(); i++){
+        Condition &condition = conditions[plan[i].condition];
+        text += (i == 0) ? "select    " : plan[i].check ? "check     " : "intersect ";
+        text += condition.text;
+        sprintf(line, "  (%.0f rows estimated", condition.estimate);
+        text += line;
+        if (i > 0){
+            sprintf(line, ", %.0f left", plan[i].rows);
+            text += line;
+        }
+        if (executed){
+            sprintf(line, ", %.0f actual", plan[i].actual);
+            text += line;
+        }
+        text += ")\n";
+    }
+    return text;
+}
+
+void MemberQuery::makePlan(){
+    for (size_t i = 0; i < conditions.size(); i++){
+        estimate(conditions[i]);
+    }
+    vector< pair<double, int> > order;
+    for (size_t i = 0; i < conditions.size(); i++){
+        order.push_back(make_pair(conditions[i].estimate, static_cast<int>(i)));
+    }
+    sort(order.begin(), order.end());
+    // the rows left after each step assume independent conditions
+    double members = max(1.0, statisticsOf(db.getSchema().getIdAttr()).total);
+    double rows = 0.0;
+    plan.clear();
+    for (size_t i = 0; i < order.size(); i++){
+        Step step;
+        step.condition = order[i].second;
+        step.check = (i > 0)&&(cheaperToCheck(rows, order[i].first));
+        step.rows = (i == 0) ? order[i].first : rows * order[i].first / members;
+        step.actual = 0.0;
+        rows = step.rows;
+        plan.push_back(step);
+    }
+    executed = false;
+}
+
+dex::gdb::Objects * MemberQuery::execute(){
+    dex::gdb::Graph *graph = db.getGraph();
+    if ((!graph)||(conditions.empty())){
+        return NULL;
+    }
+    dex::gdb::Objects *found = NULL;
+    dex::gdb::Objects *selected = NULL;
+    dex::gdb::Objects *kept = NULL;
+    dex::gdb::ObjectsIterator *it = NULL;
+    try{
+        makePlan();
+        found = select(conditions[plan[0].condition]);
+        plan[0].actual = static_cast<double>(found->Count());
+        for (size_t i = 1; i < plan.size(); i++){
+            Condition &condition = conditions[plan[i].condition];
+            // decided again on what the earlier steps really left
+            plan[i].check = cheaperToCheck(static_cast<double>(found->Count()), condition.estimate);
+            if (plan[i].check){
+                dex::gdb::Value value;
+                kept = db.getSession()->NewObjects();
+                it = found->Iterator();
+                while (it->HasNext()){
+                    dex::gdb::oid_t oid = it->Next();
+                    if (matches(oid, condition, value)){
+                        kept->Add(oid);
+                    }
+                }
+                delete it;
+                it = NULL;
+                delete found;
+                found = kept;
+                kept = NULL;
+            }else{
+                selected = select(condition);
+                kept = dex::gdb::Objects::CombineIntersection(found, selected);
+                delete selected;
+                selected = NULL;
+                delete found;
+                found = kept;
+                kept = NULL;
+            }
+            plan[i].actual = static_cast<double>(found->Count());
+        }
+    }catch(dex::gdb::Exception &e){
+        delete it;
+        delete kept;
+        delete selected;
+        delete found;
+        return NULL;
+    }
+    executed = true;
+    return found;
+}
+
+dex::gdb::Objects * MemberQuery::select(Condition &condition){
+    if (condition.range){
+        return db.getGraph()->Select(condition.attr, dex::gdb::Between, condition.lower, condition.higher);
+    }
+    return db.getGraph()->Select(condition.attr, dex::gdb::Equal, condition.lower);
+}
+
+bool MemberQuery::matches(dex::gdb::oid_t oid, Condition &condition, dex::gdb::Value &value){
+    db.getGraph()->GetAttribute(oid, condition.attr, value);
+    if (value.IsNull()){
+        return false;
+    }
+    if (condition.range){
+        return (value.Compare(condition.lower) >= 0)&&(value.Compare(condition.higher) <= 0);
+    }
+    return value.Equals(condition.lower);
+}
+
+void MemberQuery::estimate(Condition &condition){
+    Statistics &stats = statisticsOf(condition.attr);
+    if ((stats.total <= 0.0)||(stats.distinct <= 0.0)){
+        condition.estimate = 0.0;
+        return;
+    }
+    if (!condition.range){
+        condition.estimate = stats.total / stats.distinct;
+        return;
+    }
+    double lower = max(stats.min, static_cast<double>(condition.lower.GetTimestamp()));
+    double higher = min(stats.max, static_cast<double>(condition.higher.GetTimestamp()));
+    if (lower > higher){
+        condition.estimate = 0.0;
+    }else if (stats.max <= stats.min){
+        condition.estimate = stats.total;
+    }else{
+        condition.estimate = stats.total * (higher - lower) / (stats.max - stats.min);
+    }
+}
+
+MemberQuery::Statistics & MemberQuery::statisticsOf(dex::gdb::attr_t attr){
+    map<dex::gdb::attr_t, Statistics>::iterator found = statistics.find(attr);
+    if (found != statistics.end()){
+        return found->second;
+    }
+    dex::gdb::AttributeStatistics *read = db.getGraph()->GetAttributeStatistics(attr, true);
+    Statistics stats;
+    stats.total = static_cast<double>(read->GetTotal());
+    stats.distinct = static_cast<double>(read->GetDistinct());
+    stats.min = stats.max = 0.0;
+    if ((!read->GetMin().IsNull())&&(read->GetMin().GetDataType() == dex::gdb::Timestamp)){
+        stats.min = static_cast<double>(read->GetMin().GetTimestamp());
+        stats.max = static_cast<double>(read->GetMax().GetTimestamp());
+    }
+    delete read;
+    return statistics[attr] = stats;
+}
+
+bool MemberQuery::cheaperToCheck(double rows, double selected){
+    return rows * CheckCost < selected * IntersectCost;
+}
+
+void MemberQuery::memberAdded(dex::gdb::oid_t member, MemberClass &data){
+    // statistics drift slowly, they are read again once a tenth of the
+    // members changed
+    if (statistics.empty()){
+        return;
+    }
+    if (++changes * 10.0 > statisticsOf(db.getSchema().getIdAttr()).total){
+        reset();
+    }
+}
+
+void MemberQuery::memberDeleted(dex::gdb::oid_t member){
+    MemberClass none;
+    memberAdded(member, none);
+}
+
+void MemberQuery::reset(){
+    statistics.clear();
+    changes = 0;
+}
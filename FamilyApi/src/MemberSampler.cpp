@@ -0,0 +1,182 @@
+#include "MemberSampler.h"
+#include "dex/gdb/Objects.h"
+#include "dex/gdb/ObjectsIterator.h"
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+const int MemberSampler::DefaultWalkLimit;
+
+MemberSampler::MemberSampler(DexDBWrapper &db)
+: db(db)
+{
+    walkLimit = DefaultWalkLimit;
+}
+
+void MemberSampler::setWalkLimit(int members){
+    this->walkLimit = (members > 0) ? members : 0;
+}
+
+int MemberSampler::sampleByName(MemberClass member, int examples, SampleEstimate &total, vector<MemberClass> &found){
+    found.clear();
+    dex::gdb::Graph *graph = db.getGraph();
+    if (!graph){
+        return -1;
+    }
+    dex::gdb::Objects *matches = NULL;
+    dex::gdb::Objects *sample = NULL;
+    try{
+        matches = db.selectByName(member);
+        total.estimate = total.low = total.high = static_cast<double>(matches->Count());
+        total.exact = true;
+        if ((examples > 0)&&(matches->Count() > 0)){
+            sample = matches->Sample(NULL, min(static_cast<dex::gdb::int64_t>(examples), matches->Count()));
+            read(sample, examples, found);
+            delete sample;
+            sample = NULL;
+        }
+        delete matches;
+    }catch(dex::gdb::Exception &e){
+        delete sample;
+        delete matches;
+        found.clear();
+        return -1;
+    }
+    return static_cast<int>(found.size());
+}
+
+int MemberSampler::sampleDescendants(MemberClass member, int samples, int examples, SampleEstimate &total, vector<MemberClass> &found){
+    return sampleLine(member, true, samples, examples, total, found);
+}
+
+int MemberSampler::sampleAncestors(MemberClass member, int samples, int examples, SampleEstimate &total, vector<MemberClass> &found){
+    return sampleLine(member, false, samples, examples, total, found);
+}
+
+int MemberSampler::sampleLine(MemberClass &member, bool down, int samples, int examples, SampleEstimate &total, vector<MemberClass> &found){
+    found.clear();
+    dex::gdb::Graph *graph = db.getGraph();
+    if ((!graph)||(samples < 1)){
+        return -1;
+    }
+    dex::gdb::Objects *members = NULL;
+    dex::gdb::Objects *self = NULL;
+    dex::gdb::Objects *sample = NULL;
+    dex::gdb::Objects *hits = NULL;
+    dex::gdb::ObjectsIterator *it = NULL;
+    try{
+        dex::gdb::oid_t oid = db.oidOf(member.getId());
+        if (oid == dex::gdb::Objects::InvalidOID){
+            return -1;
+        }
+        members = graph->Select(db.getSchema().getMemberType());
+        self = db.getSession()->NewObjects();
+        self->Add(oid);
+        double population = static_cast<double>(members->Count() - 1);
+        dex::gdb::int64_t drawn = min(static_cast<dex::gdb::int64_t>(samples), members->Count() - 1);
+        sample = (drawn > 0) ? members->Sample(self, drawn) : db.getSession()->NewObjects();
+        ReachabilityIndex &ancestry = db.getAncestry();
+        // builds the index if needed, the checks below then stay cheap
+        if (ancestry.isAncestor(oid, oid) == -1){
+            delete sample;
+            delete self;
+            delete members;
+            return -1;
+        }
+        hits = db.getSession()->NewObjects();
+        it = sample->Iterator();
+        while (it->HasNext()){
+            dex::gdb::oid_t other = it->Next();
+            int related = down ? ancestry.isAncestor(oid, other) : ancestry.isAncestor(other, oid);
+            if (related == 1){
+                hits->Add(other);
+            }
+        }
+        delete it;
+        it = NULL;
+        bounds(static_cast<double>(hits->Count()), static_cast<double>(drawn), population, total);
+        if ((!total.exact)&&((hits->Count() < examples)||(total.high <= walkLimit))){
+            dex::gdb::Objects *line = walk(oid, down);
+            if (line){
+                total.estimate = total.low = total.high = static_cast<double>(line->Count());
+                total.exact = true;
+                delete hits;
+                hits = line;
+                if ((examples > 0)&&(line->Count() > examples)){
+                    hits = line->Sample(NULL, examples);
+                    delete line;
+                }
+            }
+        }
+        read(hits, examples, found);
+        delete hits;
+        delete sample;
+        delete self;
+        delete members;
+    }catch(dex::gdb::Exception &e){
+        delete it;
+        delete hits;
+        delete sample;
+        delete self;
+        delete members;
+        found.clear();
+        return -1;
+    }
+    return static_cast<int>(found.size());
+}
+
+dex::gdb::Objects * MemberSampler::walk(dex::gdb::oid_t oid, bool down){
+    // NULL once the closure turns out larger than walkLimit
+    ParentDag &dag = db.getParentDag();
+    int start = dag.indexOf(oid);
+    if (start == -1){
+        return NULL;
+    }
+    set<int> seen;
+    vector<int> open(1, start);
+    while (!open.empty()){
+        int node = open.back();
+        open.pop_back();
+        const vector<int> &next = down ? dag.getChildren(node) : dag.getParents(node);
+        for (size_t i = 0; i < next.size(); i++){
+            if (seen.insert(next[i]).second){
+                if (static_cast<int>(seen.size()) > walkLimit){
+                    return NULL;
+                }
+                open.push_back(next[i]);
+            }
+        }
+    }
+    dex::gdb::Objects *line = db.getSession()->NewObjects();
+    for (set<int>::iterator node = seen.begin(); node != seen.end(); node++){
+        line->Add(dag.oidOf(*node));
+    }
+    return line;
+}
+
+void MemberSampler::read(dex::gdb::Objects *members, int examples, vector<MemberClass> &found){
+    dex::gdb::ObjectsIterator *it = members->Iterator();
+    while ((static_cast<int>(found.size()) < examples)&&(it->HasNext())){
+        found.push_back(MemberClass());
+        db.getSchema().readMember(db.getGraph(), it->Next(), found.back());
+    }
+    delete it;
+}
+
+void MemberSampler::bounds(double hits, double drawn, double population, SampleEstimate &total){
+    total.exact = (drawn >= population);
+    if ((total.exact)||(drawn <= 0.0)){
+        total.estimate = total.low = total.high = hits;
+        return;
+    }
+    // Wilson score interval for the share, 95%
+    const double z = 1.96;
+    double share = hits / drawn;
+    double scale = 1.0 + z * z / drawn;
+    double center = (share + z * z / (2.0 * drawn)) / scale;
+    double spread = z * sqrt(share * (1.0 - share) / drawn + z * z / (4.0 * drawn * drawn)) / scale;
+    total.estimate = share * population;
+    // at least the members already found, at most all but the ones missed
+    total.low = max(hits, (center - spread) * population);
+    total.high = min(population - (drawn - hits), (center + spread) * population);
+}
@@ -0,0 +1,62 @@
+#include "MemberVisitor.h"
+#include "dex/gdb/Objects.h"
+
+const wstring MemberView::Empty;
+
+MemberView::MemberView(dex::gdb::Graph *graph, DexSchema *schema)
+{
+    this->graph=graph;
+    this->schema=schema;
+    oid=dex::gdb::Objects::InvalidOID;
+}
+
+void MemberView::moveTo(dex::gdb::oid_t oid){
+    this->oid = oid;
+}
+
+dex::gdb::oid_t MemberView::getOid(){
+    return this->oid;
+}
+
+unsigned int MemberView::getId(){
+    graph->GetAttribute(oid, schema->getIdAttr(), value);
+    return value.IsNull() ? 0 : static_cast<unsigned int>(value.GetLong());
+}
+
+const wstring & MemberView::getName(){
+    graph->GetAttribute(oid, schema->getNameAttr(), name);
+    return name.IsNull() ? Empty : name.GetString();
+}
+
+const wstring & MemberView::getSurname(){
+    graph->GetAttribute(oid, schema->getSurnameAttr(), surname);
+    return surname.IsNull() ? Empty : surname.GetString();
+}
+
+Sex MemberView::getSex(){
+    graph->GetAttribute(oid, schema->getSexAttr(), value);
+    return value.IsNull() ? nn : static_cast<Sex>(value.GetInteger());
+}
+
+int MemberView::getBirthYear(){
+    return yearOf(schema->getBirthAttr());
+}
+
+int MemberView::getHeavenYear(){
+    return yearOf(schema->getHeavenAttr());
+}
+
+unsigned int MemberView::getPartnerId(){
+    graph->GetAttribute(oid, schema->getPartnerIdAttr(), value);
+    return value.IsNull() ? 0 : static_cast<unsigned int>(value.GetLong());
+}
+
+void MemberView::read(MemberClass &member){
+    schema->readMember(graph, oid, member);
+}
+
+int MemberView::yearOf(dex::gdb::attr_t attr){
+    // 0 when the date is not known
+    graph->GetAttribute(oid, attr, value);
+    return value.IsNull() ? 0 : DexSchema::yearOf(value.GetTimestamp());
+}
@@ -0,0 +1,79 @@
+#include "NameSketches.h"
+#include "Utf8Codec.h"
+
+NameSketches::NameSketches(DexDBWrapper &db, int capacity)
+: db(db), surnames(capacity), names(capacity)
+{
+    built=false;
+    db.registerListener(*this);
+}
+
+NameSketches::~NameSketches()
+{
+    db.unregisterListener(*this);
+}
+
+int NameSketches::build(){
+    built = false;
+    surnames.clear();
+    names.clear();
+    if (db.forEachMember(*this) == -1){
+        surnames.clear();
+        names.clear();
+        return -1;
+    }
+    built = true;
+    return 1;
+}
+
+HeavyHitters & NameSketches::getSurnames(){
+    return this->surnames;
+}
+
+HeavyHitters & NameSketches::getNames(){
+    return this->names;
+}
+
+int NameSketches::topSurnames(int k, vector<HeavyHitter> &hitters){
+    hitters.clear();
+    if ((!built)&&(build() == -1)){
+        return -1;
+    }
+    return surnames.top(k, hitters);
+}
+
+int NameSketches::topNames(int k, vector<HeavyHitter> &hitters){
+    hitters.clear();
+    if ((!built)&&(build() == -1)){
+        return -1;
+    }
+    return names.top(k, hitters);
+}
+
+void NameSketches::count(const string &name, const string &surname){
+    if (!name.empty()){
+        names.add(name);
+    }
+    if (!surname.empty()){
+        surnames.add(surname);
+    }
+}
+
+bool NameSketches::operator()(MemberView &member){
+    count(Utf8Codec::encode(member.getName()), Utf8Codec::encode(member.getSurname()));
+    return true;
+}
+
+void NameSketches::memberAdded(dex::gdb::oid_t member, MemberClass &data){
+    if (built){
+        count(data.getName(), data.getSurname());
+    }
+}
+
+void NameSketches::memberDeleted(dex::gdb::oid_t member){
+    built = false;
+}
+
+void NameSketches::reset(){
+    built = false;
+}
@@ -0,0 +1,152 @@
+#include "ParentDag.h"
+#include "dex/gdb/Objects.h"
+#include "dex/gdb/ObjectsIterator.h"
+
+ParentDag::ParentDag()
+{
+    graph=NULL;
+    schema=NULL;
+    built=false;
+}
+
+void ParentDag::attach(dex::gdb::Graph *graph, DexSchema *schema){
+    this->graph = graph;
+    this->schema = schema;
+    clear();
+}
+
+bool ParentDag::isBuilt(){
+    return this->built;
+}
+
+void ParentDag::clear(){
+    index.clear();
+    oids.clear();
+    alive.clear();
+    parents.clear();
+    children.clear();
+    built = false;
+}
+
+dex::gdb::type_t ParentDag::getParentType(){
+    return schema ? schema->getParentType() : dex::gdb::Type::InvalidType;
+}
+
+int ParentDag::build(){
+    if (built){
+        return 1;
+    }
+    if ((!graph)||(!schema)){
+        return -1;
+    }
+    clear();
+    try{
+        dex::gdb::Objects *members = graph->Select(schema->getMemberType());
+        dex::gdb::ObjectsIterator *it = members->Iterator();
+        while (it->HasNext()){
+            addNode(it->Next());
+        }
+        delete it;
+        delete members;
+
+        int nodes = size();
+        for (int node = 0; node < nodes; node++){
+            dex::gdb::Objects *kids = graph->Neighbors(oids[node], schema->getParentType(), dex::gdb::Outgoing);
+            dex::gdb::ObjectsIterator *kid = kids->Iterator();
+            while (kid->HasNext()){
+                int child = indexOf(kid->Next());
+                if (child != -1){
+                    addEdge(node, child);
+                }
+            }
+            delete kid;
+            delete kids;
+        }
+    }catch(dex::gdb::Exception &e){
+        clear();
+        return -1;
+    }
+    built = true;
+    return 1;
+}
+
+int ParentDag::size(){
+    return static_cast<int>(oids.size());
+}
+
+int ParentDag::indexOf(dex::gdb::oid_t oid){
+    map<dex::gdb::oid_t, int>::iterator found = index.find(oid);
+    return (found == index.end()) ? -1 : found->second;
+}
+
+dex::gdb::oid_t ParentDag::oidOf(int node){
+    return oids[node];
+}
+
+bool ParentDag::isAlive(int node){
+    return (node >= 0)&&(node < size())&&(alive[node]);
+}
+
+const vector<int> & ParentDag::getParents(int node){
+    return parents[node];
+}
+
+const vector<int> & ParentDag::getChildren(int node){
+    return children[node];
+}
+
+int ParentDag::addNode(dex::gdb::oid_t oid){
+    int node = indexOf(oid);
+    if (node != -1){
+        return node;
+    }
+    node = size();
+    index[oid] = node;
+    oids.push_back(oid);
+    alive.push_back(true);
+    parents.push_back(vector<int>());
+    children.push_back(vector<int>());
+    return node;
+}
+
+void ParentDag::removeNode(int node){
+    if (!isAlive(node)){
+        return;
+    }
+    for (size_t i = 0; i < parents[node].size(); i++){
+        eraseOne(children[parents[node][i]], node);
+    }
+    for (size_t i = 0; i < children[node].size(); i++){
+        eraseOne(parents[children[node][i]], node);
+    }
+    parents[node].clear();
+    children[node].clear();
+    index.erase(oids[node]);
+    alive[node] = false;
+}
+
+void ParentDag::addEdge(int parent, int child){
+    if ((!isAlive(parent))||(!isAlive(child))){
+        return;
+    }
+    parents[child].push_back(parent);
+    children[parent].push_back(child);
+}
+
+void ParentDag::removeEdge(int parent, int child){
+    if ((!isAlive(parent))||(!isAlive(child))){
+        return;
+    }
+    eraseOne(parents[child], parent);
+    eraseOne(children[parent], child);
+}
+
+void ParentDag::eraseOne(vector<int> &nodes, int node){
+    for (size_t i = 0; i < nodes.size(); i++){
+        if (nodes[i] == node){
+            nodes[i] = nodes.back();
+            nodes.pop_back();
+            return;
+        }
+    }
+}
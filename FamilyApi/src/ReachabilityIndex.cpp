@@ -0,0 +1,252 @@
+#include "ReachabilityIndex.h"
+#include <algorithm>
+
+ReachabilityIndex::ReachabilityIndex(ParentDag &dag)
+: dag(dag)
+{
+    built=false;
+    dirty=false;
+    nextNumber=0;
+    insertsSinceBuild=0;
+    walk=0;
+}
+
+int ReachabilityIndex::build(){
+    if (dag.build() == -1){
+        return -1;
+    }
+    int nodes = dag.size();
+    number.assign(nodes, -1);
+    low.assign(nodes, -1);
+    treeParent.assign(nodes, -1);
+    labels.assign(nodes, Intervals());
+
+    vector<int> order;
+    vector< pair<int, size_t> > stack;
+    int counter = 0;
+    order.reserve(nodes);
+
+    // roots first so the spanning trees follow whole lineages, then
+    // whatever is left (members only reachable through a cycle)
+    for (int pass = 0; pass < 2; pass++){
+        for (int root = 0; root < nodes; root++){
+            if ((!dag.isAlive(root))||(number[root] != -1)||(low[root] != -1)){
+                continue;
+            }
+            if ((pass == 0)&&(!dag.getParents(root).empty())){
+                continue;
+            }
+            low[root] = counter;
+            stack.push_back(make_pair(root, static_cast<size_t>(0)));
+            while (!stack.empty()){
+                int node = stack.back().first;
+                const vector<int> &children = dag.getChildren(node);
+                if (stack.back().second < children.size()){
+                    int child = children[stack.back().second++];
+                    if (low[child] == -1){
+                        low[child] = counter;
+                        treeParent[child] = node;
+                        stack.push_back(make_pair(child, static_cast<size_t>(0)));
+                    }
+                }else{
+                    number[node] = counter++;
+                    order.push_back(node);
+                    stack.pop_back();
+                }
+            }
+        }
+    }
+
+    // postorder: every child is labelled before its parents
+    for (size_t i = 0; i < order.size(); i++){
+        label(order[i]);
+    }
+
+    nextNumber = counter;
+    insertsSinceBuild = 0;
+    built = true;
+    dirty = false;
+    return 1;
+}
+
+void ReachabilityIndex::label(int node){
+    Intervals &own = labels[node];
+    Interval tree;
+    tree.low = low[node];
+    tree.high = number[node];
+    own.assign(1, tree);
+
+    const vector<int> &children = dag.getChildren(node);
+    for (size_t i = 0; i < children.size(); i++){
+        if (!covers(own, labels[children[i]])){
+            merge(own, labels[children[i]]);
+        }
+    }
+}
+
+int ReachabilityIndex::isAncestor(dex::gdb::oid_t ancestor, dex::gdb::oid_t member){
+    if ((!built)||(dirty)){
+        if (build() == -1){
+            return -1;
+        }
+    }
+    int a = dag.indexOf(ancestor);
+    int b = dag.indexOf(member);
+    if ((a == -1)||(b == -1)){
+        return -1;
+    }
+    if (a == b){
+        return 0;
+    }
+    return contains(labels[a], number[b]) ? 1 : 0;
+}
+
+void ReachabilityIndex::memberAdded(dex::gdb::oid_t member, MemberClass &data){
+    if ((!built)||(dirty)){
+        return;
+    }
+    int node = dag.indexOf(member);
+    if (node == -1){
+        return;
+    }
+    if (node >= static_cast<int>(number.size())){
+        number.resize(node + 1, -1);
+        low.resize(node + 1, -1);
+        treeParent.resize(node + 1, -1);
+        labels.resize(node + 1);
+    }
+    number[node] = low[node] = nextNumber++;
+    label(node);
+}
+
+void ReachabilityIndex::memberDeleted(dex::gdb::oid_t member){
+    dirty = true;
+}
+
+void ReachabilityIndex::relationAdded(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head){
+    if ((relation != dag.getParentType())||(!built)||(dirty)){
+        return;
+    }
+    int parent = dag.indexOf(tail);
+    int child = dag.indexOf(head);
+    if ((parent == -1)||(child == -1)){
+        dirty = true;
+        return;
+    }
+
+    // fresh numbers fragment the labels, renumber once in a while
+    if (++insertsSinceBuild > max(1024, dag.size() / 2)){
+        dirty = true;
+        return;
+    }
+
+    Intervals added = labels[child];
+    vector<int> queue(1, parent);
+    for (size_t i = 0; i < queue.size(); i++){
+        int node = queue[i];
+        if (covers(labels[node], added)){
+            continue;
+        }
+        merge(labels[node], added);
+        const vector<int> &parents = dag.getParents(node);
+        queue.insert(queue.end(), parents.begin(), parents.end());
+    }
+}
+
+void ReachabilityIndex::relationDeleted(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head){
+    if ((relation != dag.getParentType())||(!built)||(dirty)){
+        return;
+    }
+    int parent = dag.indexOf(tail);
+    int child = dag.indexOf(head);
+    if ((parent == -1)||(child == -1)||(treeParent[child] == parent)){
+        dirty = true;
+        return;
+    }
+    recomputeAncestors(parent);
+}
+
+void ReachabilityIndex::reset(){
+    built = false;
+}
+
+void ReachabilityIndex::recomputeAncestors(int node){
+    // postorder of a DFS going up from node lists every ancestor before its
+    // descendants, so walk it backwards
+    vector<int> order;
+    vector< pair<int, size_t> > stack;
+    // members seen by this walk carry its number, so nothing is allocated
+    // or cleared per deletion
+    if (seen.size() < static_cast<size_t>(dag.size())){
+        seen.resize(dag.size(), 0);
+    }
+    if (++walk == 0){
+        seen.assign(seen.size(), 0);
+        walk = 1;
+    }
+    seen[node] = walk;
+    stack.push_back(make_pair(node, static_cast<size_t>(0)));
+    while (!stack.empty()){
+        int current = stack.back().first;
+        const vector<int> &parents = dag.getParents(current);
+        if (stack.back().second < parents.size()){
+            int parent = parents[stack.back().second++];
+            if (seen[parent] != walk){
+                seen[parent] = walk;
+                stack.push_back(make_pair(parent, static_cast<size_t>(0)));
+            }
+        }else{
+            order.push_back(current);
+            stack.pop_back();
+        }
+    }
+    for (size_t i = order.size(); i > 0; i--){
+        label(order[i - 1]);
+    }
+}
+
+bool ReachabilityIndex::contains(const Intervals &intervals, int value){
+    size_t first = 0, last = intervals.size();
+    while (first < last){
+        size_t middle = (first + last) / 2;
+        if (intervals[middle].high < value){
+            first = middle + 1;
+        }else{
+            last = middle;
+        }
+    }
+    return (first < intervals.size())&&(intervals[first].low <= value);
+}
+
+bool ReachabilityIndex::covers(const Intervals &outer, const Intervals &inner){
+    size_t o = 0;
+    for (size_t i = 0; i < inner.size(); i++){
+        while ((o < outer.size())&&(outer[o].high < inner[i].high)){
+            o++;
+        }
+        if ((o == outer.size())||(outer[o].low > inner[i].low)){
+            return false;
+        }
+    }
+    return true;
+}
+
+void ReachabilityIndex::merge(Intervals &target, const Intervals &source){
+    Intervals merged;
+    merged.reserve(target.size() + source.size());
+    size_t t = 0, s = 0;
+    while ((t < target.size())||(s < source.size())){
+        Interval next;
+        if ((s == source.size())||((t < target.size())&&(target[t].low <= source[s].low))){
+            next = target[t++];
+        }else{
+            next = source[s++];
+        }
+        if ((!merged.empty())&&(next.low <= merged.back().high + 1)){
+            merged.back().high = max(merged.back().high, next.high);
+        }else{
+            merged.push_back(next);
+        }
+    }
+    target.swap(merged);
+}
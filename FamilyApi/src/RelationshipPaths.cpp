@@ -0,0 +1,184 @@
+#include "RelationshipPaths.h"
+#include "dex/gdb/Objects.h"
+#include <algorithm>
+
+RelationshipPaths::RelationshipPaths(DexDBWrapper &db)
+: db(db)
+{
+    maxLength=12;
+    maxResults=1000;
+    timeBudget=0.0;
+    dag=NULL;
+    sink=NULL;
+    apex=-1;
+    target=-1;
+    found=0;
+    steps=0;
+    stopped=false;
+    started=0;
+}
+
+void RelationshipPaths::setMaxLength(int edges){
+    this->maxLength = edges;
+}
+
+void RelationshipPaths::setMaxResults(int results){
+    this->maxResults = results;
+}
+
+void RelationshipPaths::setTimeBudget(double seconds){
+    this->timeBudget = seconds;
+}
+
+bool RelationshipPaths::isComplete(){
+    return !this->stopped;
+}
+
+int RelationshipPaths::enumerate(MemberClass member_1, MemberClass member_2, RelationshipPathSink &sink){
+    found = 0;
+    steps = 0;
+    stopped = false;
+    started = clock();
+    dex::gdb::Graph *graph = db.getGraph();
+    if (!graph){
+        return -1;
+    }
+    int node_1, node_2;
+    try{
+        dex::gdb::oid_t oid_1 = db.oidOf(member_1.getId());
+        dex::gdb::oid_t oid_2 = db.oidOf(member_2.getId());
+        dag = &db.getParentDag();
+        if ((oid_1 == dex::gdb::Objects::InvalidOID)||(oid_2 == dex::gdb::Objects::InvalidOID)||(!dag->isBuilt())){
+            return -1;
+        }
+        node_1 = dag->indexOf(oid_1);
+        node_2 = dag->indexOf(oid_2);
+    }catch(dex::gdb::Exception &e){
+        return -1;
+    }
+    this->sink = &sink;
+    search(node_1, node_2);
+    this->sink = NULL;
+    return found;
+}
+
+void RelationshipPaths::search(int node_1, int node_2){
+    if (node_1 == node_2){
+        return;
+    }
+    target = node_2;
+    ancestors(node_1, distance_1);
+    ancestors(node_2, distance_2);
+
+    // common ancestors, nearest relationship first
+    vector< pair<int, int> > apexes;
+    for (map<int, int>::iterator it = distance_1.begin(); it != distance_1.end(); it++){
+        map<int, int>::iterator other = distance_2.find(it->first);
+        if ((other != distance_2.end())&&(it->second + other->second <= maxLength)){
+            apexes.push_back(make_pair(it->second + other->second, it->first));
+        }
+    }
+    sort(apexes.begin(), apexes.end());
+    onChain.assign(dag->size(), 0);
+    for (size_t i = 0; (i < apexes.size())&&(!stopped); i++){
+        apex = apexes[i].second;
+        chain_1.assign(1, apex);
+        descend(apex, node_1, distance_1, maxLength - distance_2[apex], chain_1, true);
+    }
+}
+
+void RelationshipPaths::ancestors(int node, map<int, int> &distance){
+    distance.clear();
+    distance[node] = 0;
+    vector<int> queue(1, node);
+    for (size_t i = 0; i < queue.size(); i++){
+        int depth = distance[queue[i]];
+        if (depth == maxLength){
+            continue;
+        }
+        const vector<int> &parents = dag->getParents(queue[i]);
+        for (size_t p = 0; p < parents.size(); p++){
+            if (distance.insert(make_pair(parents[p], depth + 1)).second){
+                queue.push_back(parents[p]);
+            }
+        }
+    }
+}
+
+void RelationshipPaths::descend(int node, int end, const map<int, int> &distance, int budget, vector<int> &chain, bool first){
+    if (node == end){
+        if (first){
+            // the first half is fixed, the second may use what is left
+            chain_2.assign(1, apex);
+            descend(apex, target, distance_2, maxLength - static_cast<int>(chain_1.size()) + 1, chain_2, false);
+        }else{
+            emit();
+        }
+        return;
+    }
+    if ((++steps % 1024 == 0)&&(outOfTime())){
+        stopped = true;
+        return;
+    }
+    const vector<int> &children = dag->getChildren(node);
+    for (size_t c = 0; (c < children.size())&&(!stopped); c++){
+        int child = children[c];
+        map<int, int>::const_iterator left = distance.find(child);
+        if ((left == distance.end())||(static_cast<int>(chain.size()) + left->second > budget)){
+            continue;
+        }
+        if ((!first)&&(onChain[child])){
+            continue;
+        }
+        chain.push_back(child);
+        if (first){
+            onChain[child] = 1;
+        }
+        descend(child, end, distance, budget, chain, first);
+        if (first){
+            onChain[child] = 0;
+        }
+        chain.pop_back();
+    }
+}
+
+void RelationshipPaths::emit(){
+    RelationshipPath path;
+    if ((chain_1.size() > 1)&&(chain_2.size() > 1)){
+        // a couple over the two halves is one relationship, reported by
+        // the parent with the lowest number
+        const vector<int> &left = dag->getParents(chain_1[1]);
+        const vector<int> &right = dag->getParents(chain_2[1]);
+        vector<int> shared;
+        for (size_t i = 0; i < left.size(); i++){
+            if (find(right.begin(), right.end(), left[i]) != right.end()){
+                shared.push_back(left[i]);
+            }
+        }
+        sort(shared.begin(), shared.end());
+        if (shared[0] != apex){
+            return;
+        }
+        for (size_t i = 0; i < shared.size(); i++){
+            path.apexes.push_back(dag->oidOf(shared[i]));
+        }
+    }else{
+        path.apexes.push_back(dag->oidOf(apex));
+    }
+    for (size_t i = chain_1.size(); i > 0; i--){
+        path.members.push_back(dag->oidOf(chain_1[i - 1]));
+    }
+    for (size_t i = 1; i < chain_2.size(); i++){
+        path.members.push_back(dag->oidOf(chain_2[i]));
+    }
+    path.up = static_cast<int>(chain_1.size()) - 1;
+    path.down = static_cast<int>(chain_2.size()) - 1;
+    found++;
+    if ((!sink->pathFound(path))||((maxResults > 0)&&(found >= maxResults))){
+        stopped = true;
+    }
+}
+
+bool RelationshipPaths::outOfTime(){
+    return (timeBudget > 0.0)&&(static_cast<double>(clock() - started) / CLOCKS_PER_SEC > timeBudget);
+}
@@ -0,0 +1,139 @@
+#include "SeekableCSVReader.h"
+#include "Utf8Codec.h"
+#include "dex/gdb/Graph_data.h"
+
+const size_t SeekableCSVReader::BufferSize;
+
+static int seekFile(FILE *file, dex::gdb::int64_t offset){
+#ifdef _WIN32
+    return _fseeki64(file, offset, SEEK_SET);
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET);
+#endif
+}
+
+SeekableCSVReader::SeekableCSVReader()
+{
+    file=NULL;
+    separator=',';
+    quote='"';
+    offset=0;
+    row=0;
+}
+
+SeekableCSVReader::~SeekableCSVReader()
+{
+    if (file){
+        fclose(file);
+    }
+}
+
+void SeekableCSVReader::setSeparator(char separator){
+    this->separator = separator;
+}
+
+void SeekableCSVReader::setQuote(char quote){
+    this->quote = quote;
+}
+
+int SeekableCSVReader::open(string path){
+    if (file){
+        fclose(file);
+    }
+    file = fopen(path.c_str(), "rb");
+    if (!file){
+        return -1;
+    }
+    setvbuf(file, NULL, _IOFBF, BufferSize);
+    offset = 0;
+    row = 0;
+    return 1;
+}
+
+int SeekableCSVReader::seek(dex::gdb::int64_t offset, dex::gdb::int32_t row){
+    if ((!file)||(seekFile(file, offset) != 0)){
+        return -1;
+    }
+    this->offset = offset;
+    this->row = row;
+    return 1;
+}
+
+dex::gdb::int64_t SeekableCSVReader::getOffset(){
+    return this->offset;
+}
+
+dex::gdb::bool_t SeekableCSVReader::Reset()
+throw(dex::gdb::IOException){
+    if (seek(0, 0) == -1){
+        throw dex::gdb::IOException("Cannot rewind CSV file");
+    }
+    return true;
+}
+
+void SeekableCSVReader::addField(dex::gdb::StringList &row){
+    decoded.clear();
+    Utf8Codec::decode(field.data(), field.size(), decoded);
+    row.Add(decoded);
+    field.clear();
+}
+
+dex::gdb::bool_t SeekableCSVReader::Read(dex::gdb::StringList &row)
+throw(dex::gdb::IOException){
+    if (!file){
+        throw dex::gdb::IOException("CSV file is not open");
+    }
+
+    int c = getc(file);
+    if (c == EOF){
+        return false;
+    }
+
+    bool quoted = false;
+    field.clear();
+    while (c != EOF){
+        offset++;
+        if (quoted){
+            if (c == quote){
+                int next = getc(file);
+                if (next == quote){
+                    offset++;
+                    field += static_cast<char>(c);
+                }else{
+                    quoted = false;
+                    ungetc(next, file);
+                }
+            }else{
+                field += static_cast<char>(c);
+            }
+        }else if ((c == quote)&&(field.empty())){
+            quoted = true;
+        }else if (c == separator){
+            addField(row);
+        }else if (c == '\n'){
+            break;
+        }else if (c != '\r'){
+            field += static_cast<char>(c);
+        }
+        c = getc(file);
+    }
+    if (ferror(file)){
+        throw dex::gdb::IOException("Cannot read CSV file");
+    }
+    addField(row);
+    this->row++;
+    return true;
+}
+
+dex::gdb::int32_t SeekableCSVReader::GetRow()
+throw(dex::gdb::IOException){
+    return this->row;
+}
+
+void SeekableCSVReader::Close()
+throw(dex::gdb::IOException){
+    if (file){
+        fclose(file);
+        file = NULL;
+    }
+}
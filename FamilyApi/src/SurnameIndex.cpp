@@ -0,0 +1,151 @@
+#include "SurnameIndex.h"
+#include "Utf8Codec.h"
+#include "dex/gdb/Value.h"
+#include "dex/gdb/Values.h"
+#include "dex/gdb/ValuesIterator.h"
+#include <algorithm>
+
+SurnameIndex::SurnameIndex(DexDBWrapper &db)
+: db(db)
+{
+    built=false;
+    begin=0;
+    end=0;
+    db.registerListener(*this);
+}
+
+SurnameIndex::~SurnameIndex()
+{
+    db.unregisterListener(*this);
+}
+
+int SurnameIndex::build(){
+    built = false;
+    surnames.clear();
+    begin = end = 0;
+    dex::gdb::Graph *graph = db.getGraph();
+    if (!graph){
+        return -1;
+    }
+    dex::gdb::Values *values = NULL;
+    dex::gdb::ValuesIterator *it = NULL;
+    try{
+        values = graph->GetValues(db.getSchema().getSurnameAttr());
+        surnames.reserve(static_cast<size_t>(values->Count()));
+        it = values->Iterator(dex::gdb::Ascendent);
+        while (it->HasNext()){
+            dex::gdb::Value *value = it->Next();
+            if ((!value->IsNull())&&(!value->GetString().empty())){
+                surnames.push_back(value->GetString());
+            }
+            delete value;
+        }
+        delete it;
+        delete values;
+    }catch(dex::gdb::Exception &e){
+        delete it;
+        delete values;
+        surnames.clear();
+        return -1;
+    }
+    // seek() searches by code point, whatever collation the index used
+    sort(surnames.begin(), surnames.end());
+    built = true;
+    return 1;
+}
+
+int SurnameIndex::size(){
+    if ((!built)&&(build() == -1)){
+        return -1;
+    }
+    return static_cast<int>(surnames.size());
+}
+
+int SurnameIndex::seek(string prefix){
+    if ((!built)&&(build() == -1)){
+        return -1;
+    }
+    wstring start = Utf8Codec::decode(prefix);
+    begin = end = static_cast<int>(lower_bound(surnames.begin(), surnames.end(), start) - surnames.begin());
+    return ((end < size())&&(surnames[end].compare(0, start.size(), start) == 0)) ? 1 : 0;
+}
+
+int SurnameIndex::next(int max, vector<SurnameCount> &page){
+    page.clear();
+    if ((!built)&&(build() == -1)){
+        return -1;
+    }
+    try{
+        int at = end;
+        for (; (at < size())&&(static_cast<int>(page.size()) < max); at++){
+            int members = count(surnames[at]);
+            if (members > 0){
+                SurnameCount entry;
+                entry.surname = Utf8Codec::encode(surnames[at]);
+                entry.members = members;
+                page.push_back(entry);
+            }
+        }
+        begin = end;
+        end = at;
+    }catch(dex::gdb::Exception &e){
+        page.clear();
+        return -1;
+    }
+    return static_cast<int>(page.size());
+}
+
+int SurnameIndex::previous(int max, vector<SurnameCount> &page){
+    page.clear();
+    if ((!built)&&(build() == -1)){
+        return -1;
+    }
+    try{
+        int at = begin;
+        for (; (at > 0)&&(static_cast<int>(page.size()) < max); at--){
+            int members = count(surnames[at - 1]);
+            if (members > 0){
+                SurnameCount entry;
+                entry.surname = Utf8Codec::encode(surnames[at - 1]);
+                entry.members = members;
+                page.push_back(entry);
+            }
+        }
+        reverse(page.begin(), page.end());
+        end = begin;
+        begin = at;
+    }catch(dex::gdb::Exception &e){
+        page.clear();
+        return -1;
+    }
+    return static_cast<int>(page.size());
+}
+
+int SurnameIndex::count(const wstring &surname){
+    dex::gdb::Value value;
+    value.SetString(surname);
+    return static_cast<int>(db.getGraph()->GetAttributeIntervalCount(db.getSchema().getSurnameAttr(), value, true, value, true));
+}
+
+void SurnameIndex::memberAdded(dex::gdb::oid_t member, MemberClass &data){
+    if ((!built)||(data.getSurname().empty())){
+        return;
+    }
+    wstring surname = Utf8Codec::decode(data.getSurname());
+    vector<wstring>::iterator at = lower_bound(surnames.begin(), surnames.end(), surname);
+    if ((at == surnames.end())||(*at != surname)){
+        int position = static_cast<int>(at - surnames.begin());
+        surnames.insert(at, surname);
+        // keep the current page where it was
+        if (position < begin){
+            begin++;
+        }
+        if (position < end){
+            end++;
+        }
+    }
+}
+
+void SurnameIndex::reset(){
+    built = false;
+}
@@ -0,0 +1,194 @@
+#include "TopologicalOrder.h"
+#include <algorithm>
+
+TopologicalOrder::TopologicalOrder(ParentDag &dag)
+: dag(dag)
+{
+    built=false;
+}
+
+int TopologicalOrder::build(){
+    if (dag.build() == -1){
+        return -1;
+    }
+    int nodes = dag.size();
+    position.assign(nodes, -1);
+    nodeAt.clear();
+    nodeAt.reserve(nodes);
+    visited.assign(nodes, 0);
+
+    // Kahn: a member is placed once all of its parents are
+    vector<int> waiting(nodes, 0);
+    for (int node = 0; node < nodes; node++){
+        if (!dag.isAlive(node)){
+            continue;
+        }
+        waiting[node] = static_cast<int>(dag.getParents(node).size());
+        if (waiting[node] == 0){
+            position[node] = static_cast<int>(nodeAt.size());
+            nodeAt.push_back(node);
+        }
+    }
+    for (size_t i = 0; i < nodeAt.size(); i++){
+        const vector<int> &children = dag.getChildren(nodeAt[i]);
+        for (size_t c = 0; c < children.size(); c++){
+            if (--waiting[children[c]] == 0){
+                position[children[c]] = static_cast<int>(nodeAt.size());
+                nodeAt.push_back(children[c]);
+            }
+        }
+    }
+
+    // dead members keep a position too, they have no edges left
+    for (int node = 0; node < nodes; node++){
+        if (position[node] == -1){
+            if (dag.isAlive(node)){
+                // the image already holds a cycle
+                position.clear();
+                nodeAt.clear();
+                return -1;
+            }
+            position[node] = static_cast<int>(nodeAt.size());
+            nodeAt.push_back(node);
+        }
+    }
+    built = true;
+    return 1;
+}
+
+int TopologicalOrder::insertEdge(dex::gdb::oid_t tail, dex::gdb::oid_t head){
+    if ((!built)&&(build() == -1)){
+        return -1;
+    }
+    grow();
+    int parent = dag.indexOf(tail);
+    int child = dag.indexOf(head);
+    if ((parent == -1)||(child == -1)){
+        return -1;
+    }
+    if (parent == child){
+        return 0;
+    }
+    int lower = position[child];
+    int upper = position[parent];
+    if (upper < lower){
+        return 1;
+    }
+
+    vector<int> forward;
+    vector<int> backward;
+    bool cycle = searchForward(child, upper, forward);
+    if (!cycle){
+        searchBackward(parent, lower, backward);
+    }
+    for (size_t i = 0; i < forward.size(); i++){
+        visited[forward[i]] = 0;
+    }
+    for (size_t i = 0; i < backward.size(); i++){
+        visited[backward[i]] = 0;
+    }
+    if (cycle){
+        return 0;
+    }
+    reorder(forward, backward);
+    return 1;
+}
+
+int TopologicalOrder::positionOf(int node){
+    // read only once built and grown, so workers may call it while the
+    // wrapper does not write
+    if ((!built)&&(build() == -1)){
+        return -1;
+    }
+    grow();
+    return ((node >= 0)&&(node < static_cast<int>(position.size()))) ? position[node] : -1;
+}
+
+bool TopologicalOrder::searchForward(int child, int upper, vector<int> &found){
+    vector<int> stack(1, child);
+    visited[child] = 1;
+    found.push_back(child);
+    while (!stack.empty()){
+        int node = stack.back();
+        stack.pop_back();
+        const vector<int> &children = dag.getChildren(node);
+        for (size_t i = 0; i < children.size(); i++){
+            int next = children[i];
+            if (position[next] == upper){
+                return true;
+            }
+            if ((!visited[next])&&(position[next] < upper)){
+                visited[next] = 1;
+                found.push_back(next);
+                stack.push_back(next);
+            }
+        }
+    }
+    return false;
+}
+
+void TopologicalOrder::searchBackward(int parent, int lower, vector<int> &found){
+    vector<int> stack(1, parent);
+    visited[parent] = 1;
+    found.push_back(parent);
+    while (!stack.empty()){
+        int node = stack.back();
+        stack.pop_back();
+        const vector<int> &parents = dag.getParents(node);
+        for (size_t i = 0; i < parents.size(); i++){
+            int next = parents[i];
+            if ((!visited[next])&&(position[next] > lower)){
+                visited[next] = 1;
+                found.push_back(next);
+                stack.push_back(next);
+            }
+        }
+    }
+}
+
+void TopologicalOrder::reorder(vector<int> &forward, vector<int> &backward){
+    // the ancestors of parent take the lowest of the freed positions, the
+    // descendants of child the rest, each group keeping its relative order
+    vector< pair<int, int> > moved;
+    moved.reserve(backward.size() + forward.size());
+    for (size_t i = 0; i < backward.size(); i++){
+        moved.push_back(make_pair(position[backward[i]], backward[i]));
+    }
+    sort(moved.begin(), moved.end());
+    size_t split = moved.size();
+    for (size_t i = 0; i < forward.size(); i++){
+        moved.push_back(make_pair(position[forward[i]], forward[i]));
+    }
+    sort(moved.begin() + split, moved.end());
+
+    vector<int> slots;
+    slots.reserve(moved.size());
+    for (size_t i = 0; i < moved.size(); i++){
+        slots.push_back(moved[i].first);
+    }
+    sort(slots.begin(), slots.end());
+    for (size_t i = 0; i < moved.size(); i++){
+        position[moved[i].second] = slots[i];
+        nodeAt[slots[i]] = moved[i].second;
+    }
+}
+
+void TopologicalOrder::grow(){
+    // members added since the last call have no edges yet, any position
+    // works, so they go to the end
+    for (int node = static_cast<int>(position.size()); node < dag.size(); node++){
+        position.push_back(static_cast<int>(nodeAt.size()));
+        nodeAt.push_back(node);
+        visited.push_back(0);
+    }
+}
+
+void TopologicalOrder::memberAdded(dex::gdb::oid_t member, MemberClass &data){
+    if (built){
+        grow();
+    }
+}
+
+void TopologicalOrder::reset(){
+    built = false;
+}
@@ -0,0 +1,229 @@
+#include "TreeLayout.h"
+#include <pthread.h>
+
+// below this many nodes starting threads costs more than it saves
+static const int ParallelNodes = 20000;
+// tasks per thread wanted on the level that is split between workers
+static const int TasksPerThread = 8;
+
+TreeLayout::TreeLayout()
+{
+    gap=1.0;
+    threads=4;
+    nextTask=0;
+    lastTask=0;
+}
+
+void TreeLayout::setGap(double gap){
+    this->gap = gap;
+}
+
+void TreeLayout::setThreads(int threads){
+    this->threads = (threads < 1) ? 1 : threads;
+}
+
+int TreeLayout::size(){
+    return static_cast<int>(parent.size());
+}
+
+double TreeLayout::getX(int node){
+    return x[node];
+}
+
+int TreeLayout::getDepth(int node){
+    return depth[node];
+}
+
+void TreeLayout::layout(const vector<int> &parent, const vector<double> &width){
+    int nodes = static_cast<int>(parent.size());
+    this->parent = parent;
+    this->width = width;
+    depth.assign(nodes, 0);
+    firstChild.assign(nodes, -1);
+    childCount.assign(nodes, 0);
+    prelim.assign(nodes, 0.0);
+    mod.assign(nodes, 0.0);
+    shift.assign(nodes, 0.0);
+    change.assign(nodes, 0.0);
+    thread.assign(nodes, -1);
+    ancestor.resize(nodes);
+    x.assign(nodes, 0.0);
+
+    vector<int> levelStart(1, 0);
+    for (int node = 0; node < nodes; node++){
+        ancestor[node] = node;
+        int up = parent[node];
+        if (up == -1){
+            continue;
+        }
+        depth[node] = depth[up] + 1;
+        if (firstChild[up] == -1){
+            firstChild[up] = node;
+        }
+        childCount[up]++;
+        if (depth[node] == static_cast<int>(levelStart.size())){
+            levelStart.push_back(node);
+        }
+    }
+    levelStart.push_back(nodes);
+
+    // first walk: bottom up. The subtrees hanging from one wide level are
+    // independent, workers take them one at a time.
+    int split = nodes;
+    if ((threads > 1)&&(nodes >= ParallelNodes)){
+        for (size_t level = 1; level + 1 < levelStart.size(); level++){
+            if (levelStart[level + 1] - levelStart[level] >= threads * TasksPerThread){
+                split = levelStart[level];
+                nextTask = split;
+                lastTask = levelStart[level + 1];
+                break;
+            }
+        }
+    }
+    if (split < nodes){
+        vector<pthread_t> workers(threads - 1);
+        int started = 0;
+        for (int i = 0; i < threads - 1; i++){
+            if (pthread_create(&workers[started], NULL, worker, this) == 0){
+                started++;
+            }
+        }
+        // the calling thread takes tasks too, alone if no thread started
+        worker(this);
+        for (int i = 0; i < started; i++){
+            pthread_join(workers[i], NULL);
+        }
+    }
+    for (int node = split - 1; node >= 0; node--){
+        place(node);
+    }
+
+    // second walk: top down, a node is moved by the mods of its ancestors
+    vector<double> sum(nodes);
+    for (int node = 0; node < nodes; node++){
+        int up = parent[node];
+        sum[node] = (up == -1) ? 0.0 : sum[up] + mod[up];
+        x[node] = prelim[node] + sum[node];
+    }
+}
+
+void * TreeLayout::worker(void *layout){
+    TreeLayout *self = static_cast<TreeLayout *>(layout);
+    vector<int> nodes;
+    for (;;){
+        int root = __sync_fetch_and_add(&self->nextTask, 1);
+        if (root >= self->lastTask){
+            break;
+        }
+        self->placeSubtree(root, nodes);
+    }
+    return NULL;
+}
+
+void TreeLayout::placeSubtree(int root, vector<int> &nodes){
+    // preorder has every node before its descendants
+    nodes.assign(1, root);
+    for (size_t i = 0; i < nodes.size(); i++){
+        int first = firstChild[nodes[i]];
+        for (int child = first; child < first + childCount[nodes[i]]; child++){
+            nodes.push_back(child);
+        }
+    }
+    for (size_t i = nodes.size(); i > 0; i--){
+        place(nodes[i - 1]);
+    }
+}
+
+void TreeLayout::place(int node){
+    int first = firstChild[node];
+    int count = childCount[node];
+    if (count == 0){
+        return;
+    }
+    int defaultAncestor = first;
+    for (int child = first; child < first + count; child++){
+        if (child > first){
+            double position = prelim[child - 1] + distance(child - 1, child);
+            mod[child] += position - prelim[child];
+            prelim[child] = position;
+        }
+        defaultAncestor = apportion(child, defaultAncestor);
+    }
+    executeShifts(node);
+    prelim[node] = (prelim[first] + prelim[first + count - 1]) / 2.0;
+    mod[node] = 0.0;
+}
+
+int TreeLayout::apportion(int node, int defaultAncestor){
+    int first = firstChild[parent[node]];
+    if (node == first){
+        return defaultAncestor;
+    }
+    // inner and outer contours on the right (p) and left (m) side
+    int innerP = node, outerP = node;
+    int innerM = node - 1, outerM = first;
+    double sumInnerP = mod[innerP], sumOuterP = mod[outerP];
+    double sumInnerM = mod[innerM], sumOuterM = mod[outerM];
+
+    while ((nextRight(innerM) != -1)&&(nextLeft(innerP) != -1)){
+        innerM = nextRight(innerM);
+        innerP = nextLeft(innerP);
+        outerM = nextLeft(outerM);
+        outerP = nextRight(outerP);
+        ancestor[outerP] = node;
+        double overlap = (prelim[innerM] + sumInnerM) - (prelim[innerP] + sumInnerP) + distance(innerM, innerP);
+        if (overlap > 0){
+            int left = (parent[ancestor[innerM]] == parent[node]) ? ancestor[innerM] : defaultAncestor;
+            moveSubtree(left, node, overlap);
+            sumInnerP += overlap;
+            sumOuterP += overlap;
+        }
+        sumInnerM += mod[innerM];
+        sumInnerP += mod[innerP];
+        sumOuterM += mod[outerM];
+        sumOuterP += mod[outerP];
+    }
+    if ((nextRight(innerM) != -1)&&(nextRight(outerP) == -1)){
+        thread[outerP] = nextRight(innerM);
+        mod[outerP] += sumInnerM - sumOuterP;
+    }
+    if ((nextLeft(innerP) != -1)&&(nextLeft(outerM) == -1)){
+        thread[outerM] = nextLeft(innerP);
+        mod[outerM] += sumInnerP - sumOuterM;
+        defaultAncestor = node;
+    }
+    return defaultAncestor;
+}
+
+void TreeLayout::moveSubtree(int left, int right, double distance){
+    // siblings are consecutive, their distance in the list is right - left
+    double subtrees = right - left;
+    change[right] -= distance / subtrees;
+    shift[right] += distance;
+    change[left] += distance / subtrees;
+    prelim[right] += distance;
+    mod[right] += distance;
+}
+
+void TreeLayout::executeShifts(int node){
+    double moved = 0.0, rate = 0.0;
+    int first = firstChild[node];
+    for (int child = first + childCount[node] - 1; child >= first; child--){
+        prelim[child] += moved;
+        mod[child] += moved;
+        rate += change[child];
+        moved += shift[child] + rate;
+    }
+}
+
+int TreeLayout::nextLeft(int node){
+    return (childCount[node] > 0) ? firstChild[node] : thread[node];
+}
+
+int TreeLayout::nextRight(int node){
+    return (childCount[node] > 0) ? firstChild[node] + childCount[node] - 1 : thread[node];
+}
+
+double TreeLayout::distance(int left, int right){
+    return (width[left] + width[right]) / 2.0 + gap;
+}
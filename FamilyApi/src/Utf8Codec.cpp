@@ -0,0 +1,105 @@
+#include "Utf8Codec.h"
+
+wstring Utf8Codec::decode(const string &text){
+    wstring out;
+    decode(text.data(), text.size(), out);
+    return out;
+}
+
+void Utf8Codec::decode(const char *text, size_t length, wstring &out){
+    const unsigned char *in = reinterpret_cast<const unsigned char *>(text);
+    size_t i = 0;
+
+    out.reserve(out.size() + length);
+    while (i < length){
+        unsigned int c = in[i];
+        unsigned int code;
+        size_t extra;
+
+        if (c < 0x80){
+            out += static_cast<wchar_t>(c);
+            i++;
+            continue;
+        }else if ((c & 0xE0) == 0xC0){
+            code = c & 0x1F;
+            extra = 1;
+        }else if ((c & 0xF0) == 0xE0){
+            code = c & 0x0F;
+            extra = 2;
+        }else if ((c & 0xF8) == 0xF0){
+            code = c & 0x07;
+            extra = 3;
+        }else{
+            // stray continuation byte, keep it as Latin-1
+            out += static_cast<wchar_t>(c);
+            i++;
+            continue;
+        }
+
+        if (i + extra >= length){
+            out += static_cast<wchar_t>(c);
+            i++;
+            continue;
+        }
+        size_t j;
+        for (j = 1; j <= extra; j++){
+            if ((in[i + j] & 0xC0) != 0x80){
+                break;
+            }
+            code = (code << 6) | (in[i + j] & 0x3F);
+        }
+        if (j <= extra){
+            out += static_cast<wchar_t>(c);
+            i++;
+            continue;
+        }
+
+        if ((sizeof(wchar_t) == 2) && (code > 0xFFFF)){
+            code -= 0x10000;
+            out += static_cast<wchar_t>(0xD800 + (code >> 10));
+            out += static_cast<wchar_t>(0xDC00 + (code & 0x3FF));
+        }else{
+            out += static_cast<wchar_t>(code);
+        }
+        i += extra + 1;
+    }
+}
+
+string Utf8Codec::encode(const wstring &text){
+    string out;
+    encode(text, out);
+    return out;
+}
+
+void Utf8Codec::encode(const wstring &text, string &out){
+    size_t length = text.size();
+
+    out.reserve(out.size() + length);
+    for (size_t i = 0; i < length; i++){
+        unsigned long code = static_cast<unsigned long>(text[i]);
+
+        if ((code >= 0xD800) && (code < 0xDC00) && (i + 1 < length)){
+            unsigned long low = static_cast<unsigned long>(text[i + 1]);
+            if ((low >= 0xDC00) && (low < 0xE000)){
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                i++;
+            }
+        }
+
+        if (code < 0x80){
+            out += static_cast<char>(code);
+        }else if (code < 0x800){
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }else if (code < 0x10000){
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }else{
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+}
@@ -0,0 +1,300 @@
+#include "WeightedRelationSearch.h"
+#include "Utf8Codec.h"
+#include "dex/gdb/Objects.h"
+#include "dex/gdb/ObjectsIterator.h"
+#include <algorithm>
+
+const int WeightedRelationSearch::MaxCost = 255;
+
+WeightedRelationSearch::WeightedRelationSearch(DexDBWrapper &db)
+: db(db)
+{
+    built=false;
+    query=0;
+    db.registerListener(*this);
+}
+
+WeightedRelationSearch::~WeightedRelationSearch()
+{
+    db.unregisterListener(*this);
+}
+
+int WeightedRelationSearch::setCost(string relation, dex::gdb::EdgesDirection direction, int cost){
+    if ((!db.getGraph())||(cost < 0)||(cost > MaxCost)){
+        return -1;
+    }
+    EdgeCost edgeCost;
+    try{
+        edgeCost.type = db.getSchema().findRelation(db.getGraph(), Utf8Codec::decode(relation));
+    }catch(dex::gdb::Exception &e){
+        return -1;
+    }
+    if (edgeCost.type == dex::gdb::Type::InvalidType){
+        return -1;
+    }
+    edgeCost.direction = direction;
+    edgeCost.cost = cost;
+    costs.push_back(edgeCost);
+    built = false;
+    return 1;
+}
+
+void WeightedRelationSearch::clearCosts(){
+    costs.clear();
+    built = false;
+}
+
+int WeightedRelationSearch::build(){
+    built = false;
+    dex::gdb::Graph *graph = db.getGraph();
+    ParentDag &dag = db.getParentDag();
+    if ((!graph)||(!dag.isBuilt())){
+        return -1;
+    }
+    arcs.assign(dag.size(), vector<Arc>());
+    vector<dex::gdb::type_t> types;
+    for (size_t i = 0; i < costs.size(); i++){
+        if (find(types.begin(), types.end(), costs[i].type) == types.end()){
+            types.push_back(costs[i].type);
+        }
+    }
+    dex::gdb::Objects *edges = NULL;
+    dex::gdb::ObjectsIterator *it = NULL;
+    try{
+        for (size_t t = 0; t < types.size(); t++){
+            edges = graph->Select(types[t]);
+            it = edges->Iterator();
+            while (it->HasNext()){
+                dex::gdb::EdgeData *data = graph->GetEdgeData(it->Next());
+                int tail = dag.indexOf(data->GetTail());
+                int head = dag.indexOf(data->GetHead());
+                delete data;
+                if ((tail != -1)&&(head != -1)){
+                    addArcs(types[t], tail, head);
+                }
+            }
+            delete it;
+            delete edges;
+            it = NULL;
+            edges = NULL;
+        }
+    }catch(dex::gdb::Exception &e){
+        delete it;
+        delete edges;
+        arcs.clear();
+        return -1;
+    }
+    grow();
+    built = true;
+    return 1;
+}
+
+int WeightedRelationSearch::findPath(MemberClass member_1, MemberClass member_2, int &cost, vector<dex::gdb::oid_t> &path){
+    path.clear();
+    int source = nodeOf(member_1);
+    int destination = nodeOf(member_2);
+    if ((source == -1)||(destination == -1)){
+        return -1;
+    }
+    cost = run(source, destination, -1);
+    if (cost == -1){
+        return 0;
+    }
+    ParentDag &dag = db.getParentDag();
+    for (int node = destination; node != -1; node = previous[node]){
+        path.push_back(dag.oidOf(node));
+    }
+    reverse(path.begin(), path.end());
+    return 1;
+}
+
+int WeightedRelationSearch::findWithin(MemberClass member, int limit, vector< pair<dex::gdb::oid_t, int> > &reached){
+    reached.clear();
+    int source = nodeOf(member);
+    if ((source == -1)||(limit < 0)){
+        return -1;
+    }
+    run(source, -1, limit);
+    ParentDag &dag = db.getParentDag();
+    // settled nearest first, the member itself comes first at cost 0
+    for (size_t i = 1; i < settled.size(); i++){
+        reached.push_back(make_pair(dag.oidOf(settled[i]), distance[settled[i]]));
+    }
+    return static_cast<int>(reached.size());
+}
+
+int WeightedRelationSearch::nodeOf(MemberClass &member){
+    if ((!db.getGraph())||((!built)&&(build() == -1))){
+        return -1;
+    }
+    try{
+        dex::gdb::oid_t oid = db.oidOf(member.getId());
+        if (oid == dex::gdb::Objects::InvalidOID){
+            return -1;
+        }
+        return db.getParentDag().indexOf(oid);
+    }catch(dex::gdb::Exception &e){
+        return -1;
+    }
+}
+
+int WeightedRelationSearch::run(int source, int destination, int limit){
+    if (++query == 0){
+        stamp.assign(stamp.size(), 0);
+        query = 1;
+    }
+    int ring = 1;
+    for (size_t i = 0; i < costs.size(); i++){
+        ring = max(ring, costs[i].cost + 1);
+    }
+    if (static_cast<int>(buckets.size()) < ring){
+        buckets.resize(ring);
+    }
+    settled.clear();
+    stamp[source] = query;
+    distance[source] = 0;
+    previous[source] = -1;
+    buckets[0].push_back(source);
+    int open = 1;
+    int found = -1;
+    for (int current = 0; open > 0; current++){
+        vector<int> &bucket = buckets[current % ring];
+        while (!bucket.empty()){
+            int node = bucket.back();
+            bucket.pop_back();
+            open--;
+            // a node is queued again each time its distance drops, the
+            // older entries are left behind and skipped here
+            if (distance[node] != current){
+                continue;
+            }
+            settled.push_back(node);
+            if (node == destination){
+                found = current;
+                break;
+            }
+            const vector<Arc> &out = arcs[node];
+            for (size_t a = 0; a < out.size(); a++){
+                int next = out[a].node;
+                int reach = current + out[a].cost;
+                if ((limit >= 0)&&(reach > limit)){
+                    continue;
+                }
+                if ((stamp[next] != query)||(reach < distance[next])){
+                    stamp[next] = query;
+                    distance[next] = reach;
+                    previous[next] = node;
+                    buckets[reach % ring].push_back(next);
+                    open++;
+                }
+            }
+        }
+        if (found != -1){
+            break;
+        }
+    }
+    if (open > 0){
+        for (int i = 0; i < ring; i++){
+            buckets[i].clear();
+        }
+    }
+    return found;
+}
+
+void WeightedRelationSearch::grow(){
+    size_t size = static_cast<size_t>(db.getParentDag().size());
+    if (arcs.size() < size){
+        arcs.resize(size);
+    }
+    if (stamp.size() < size){
+        distance.resize(size, 0);
+        previous.resize(size, -1);
+        stamp.resize(size, 0);
+    }
+}
+
+void WeightedRelationSearch::addArcs(dex::gdb::type_t type, int tail, int head){
+    for (size_t i = 0; i < costs.size(); i++){
+        if (costs[i].type != type){
+            continue;
+        }
+        Arc arc;
+        arc.cost = costs[i].cost;
+        if (costs[i].direction != dex::gdb::Ingoing){
+            arc.node = head;
+            arcs[tail].push_back(arc);
+        }
+        if (costs[i].direction != dex::gdb::Outgoing){
+            arc.node = tail;
+            arcs[head].push_back(arc);
+        }
+    }
+}
+
+void WeightedRelationSearch::removeArcs(dex::gdb::type_t type, int tail, int head){
+    for (size_t i = 0; i < costs.size(); i++){
+        if (costs[i].type != type){
+            continue;
+        }
+        if (costs[i].direction != dex::gdb::Ingoing){
+            eraseOne(arcs[tail], head, costs[i].cost);
+        }
+        if (costs[i].direction != dex::gdb::Outgoing){
+            eraseOne(arcs[head], tail, costs[i].cost);
+        }
+    }
+}
+
+void WeightedRelationSearch::eraseOne(vector<Arc> &list, int node, int cost){
+    for (size_t i = 0; i < list.size(); i++){
+        if ((list[i].node == node)&&(list[i].cost == cost)){
+            list[i] = list.back();
+            list.pop_back();
+            return;
+        }
+    }
+}
+
+void WeightedRelationSearch::memberAdded(dex::gdb::oid_t member, MemberClass &data){
+    if (built){
+        grow();
+    }
+}
+
+void WeightedRelationSearch::memberDeleted(dex::gdb::oid_t member){
+    // DEX drops the member's edges without telling, the arcs are rebuilt
+    built = false;
+}
+
+void WeightedRelationSearch::relationAdded(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head){
+    if (!built){
+        return;
+    }
+    ParentDag &dag = db.getParentDag();
+    grow();
+    int from = dag.indexOf(tail);
+    int to = dag.indexOf(head);
+    if ((from == -1)||(to == -1)){
+        built = false;
+        return;
+    }
+    addArcs(relation, from, to);
+}
+
+void WeightedRelationSearch::relationDeleted(dex::gdb::type_t relation, dex::gdb::oid_t tail, dex::gdb::oid_t head){
+    if (!built){
+        return;
+    }
+    ParentDag &dag = db.getParentDag();
+    int from = dag.indexOf(tail);
+    int to = dag.indexOf(head);
+    if ((from == -1)||(to == -1)){
+        built = false;
+        return;
+    }
+    removeArcs(relation, from, to);
+}
+
+void WeightedRelationSearch::reset(){
+    built = false;
+}
@@ -0,0 +1,21 @@
+#ifndef BENCHCLOCK_H
+#define BENCHCLOCK_H
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+// wall clock seconds for the benchmarks to time their runs with
+inline double now(){
+#ifdef _WIN32
+    return GetTickCount() / 1000.0;
+#else
+    timeval time;
+    gettimeofday(&time, NULL);
+    return time.tv_sec + time.tv_usec / 1000000.0;
+#endif
+}
+
+#endif // BENCHCLOCK_H
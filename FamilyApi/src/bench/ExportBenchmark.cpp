@@ -0,0 +1,117 @@
+/*
+ * Compares the stock CSVWriter with BufferedRowWriter on the members of an
+ * existing family database:
+ *
+ *     exportBenchmark <database image> <output directory>
+ */
+
+#include "DexDBWrapper.h"
+#include "FamilyExporter.h"
+#include "BufferedRowWriter.h"
+#include "Utf8Codec.h"
+#include "dex/io/CSVWriter.h"
+#include "dex/io/NodeTypeExporter.h"
+#include "BenchClock.h"
+#include <cstdio>
+
+static long long fileSize(string path){
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file){
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    long long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+static void report(const char *name, double seconds, string path){
+    double megabytes = fileSize(path) / (1024.0 * 1024.0);
+    printf("%-40s %8.3f s %10.1f MB %10.1f MB/s\n", name, seconds, megabytes,
+           (seconds > 0) ? megabytes / seconds : 0.0);
+}
+
+static void nodeTypeExport(DexDBWrapper &db, dex::io::RowWriter &writer){
+    dex::gdb::Graph *graph = db.getGraph();
+    dex::gdb::type_t members = db.getSchema().getMemberType();
+    dex::gdb::AttributeList *attributes = graph->FindAttributes(members);
+    dex::io::NodeTypeExporter exporter(writer, *graph, members, *attributes);
+    exporter.Run();
+    delete attributes;
+}
+
+int main(int argc, char **argv){
+    if (argc < 3){
+        printf("usage: %s <database image> <output directory>\n", argv[0]);
+        return 1;
+    }
+    DBConnectionInf inf;
+    inf.setDbName(argv[1]);
+    string out = argv[2];
+
+    DexDBWrapper db;
+    if ((db.Connect(inf) == -1)||(db.Initiate() == -1)){
+        printf("cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    try{
+        double start = now();
+        dex::io::CSVWriter csv;
+        csv.Open(Utf8Codec::decode(out + "/members_stock.csv"));
+        nodeTypeExport(db, csv);
+        csv.Close();
+        report("NodeTypeExporter + CSVWriter", now() - start, out + "/members_stock.csv");
+
+        start = now();
+        BufferedRowWriter rows;
+        if (rows.open(out + "/members_rows.csv") == -1){
+            printf("cannot write %s\n", (out + "/members_rows.csv").c_str());
+            return 1;
+        }
+        nodeTypeExport(db, rows);
+        rows.Close();
+        report("NodeTypeExporter + BufferedRowWriter", now() - start, out + "/members_rows.csv");
+    }catch(dex::gdb::Exception &e){
+        printf("export failed: %s\n", e.Message().c_str());
+        return 1;
+    }
+
+    FamilyExporter exporter(db);
+
+    double start = now();
+    BufferedRowWriter csvMembers;
+    if ((csvMembers.open(out + "/members.csv") == -1)||(exporter.exportMembers(csvMembers) == -1)){
+        printf("cannot export %s\n", (out + "/members.csv").c_str());
+        return 1;
+    }
+    report("FamilyExporter members csv", now() - start, out + "/members.csv");
+
+    start = now();
+    BufferedRowWriter binaryMembers;
+    binaryMembers.setFormat(binaryFormat);
+    if ((binaryMembers.open(out + "/members.bin") == -1)||(exporter.exportMembers(binaryMembers) == -1)){
+        printf("cannot export %s\n", (out + "/members.bin").c_str());
+        return 1;
+    }
+    report("FamilyExporter members binary", now() - start, out + "/members.bin");
+
+    start = now();
+    BufferedRowWriter csvRelations;
+    if ((csvRelations.open(out + "/relations.csv") == -1)||(exporter.exportRelations(csvRelations) == -1)){
+        printf("cannot export %s\n", (out + "/relations.csv").c_str());
+        return 1;
+    }
+    report("FamilyExporter relations csv", now() - start, out + "/relations.csv");
+
+    start = now();
+    BufferedRowWriter binaryRelations;
+    binaryRelations.setFormat(binaryFormat);
+    if ((binaryRelations.open(out + "/relations.bin") == -1)||(exporter.exportRelations(binaryRelations) == -1)){
+        printf("cannot export %s\n", (out + "/relations.bin").c_str());
+        return 1;
+    }
+    report("FamilyExporter relations binary", now() - start, out + "/relations.bin");
+
+    return 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * Times TreeLayout on generated family trees of 100k and 1M members, then
+ * single edits on a ContourLayout of the same trees and, given a
+ * database, FamilyLayout charts around one member:
+ *
+ *     layoutBenchmark [threads] [<database image> <member id>]
+ */
+
+#include "FamilyLayout.h"
+#include "BenchClock.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+
+// descendants in breadth first order, 0 to 4 children, a partner for half
+static void generate(int members, vector<int> &parent, vector<double> &width){
+    parent.assign(1, -1);
+    width.assign(1, 2.0);
+    for (int node = 0; static_cast<int>(parent.size()) < members; node++){
+        int children = rand() % 5;
+        if (node + 1 == static_cast<int>(parent.size())){
+            children = max(children, 1);
+        }
+        for (int i = 0; (i < children)&&(static_cast<int>(parent.size()) < members); i++){
+            parent.push_back(node);
+            width.push_back(1.0 + rand() % 2);
+        }
+    }
+}
+
+int main(int argc, char **argv){
+    int threads = (argc > 1) ? atoi(argv[1]) : 4;
+
+    srand(2012);
+    for (int members = 100000; members <= 1000000; members *= 10){
+        vector<int> parent;
+        vector<double> width;
+        generate(members, parent, width);
+        for (int pass = 0; pass < 2; pass++){
+            TreeLayout tree;
+            tree.setThreads((pass == 0) ? 1 : threads);
+            double start = now();
+            tree.layout(parent, width);
+            printf("TreeLayout %7d members, %d threads: %.3f s\n", members, (pass == 0) ? 1 : threads, now() - start);
+        }
+
+        ContourLayout contours;
+        double start = now();
+        contours.build(parent, width);
+        printf("ContourLayout %7d members, build: %.3f s\n", members, now() - start);
+        const int edits = 1000;
+        start = now();
+        for (int edit = 0; edit < edits; edit++){
+            int node = rand() % contours.size();
+            if (edit % 2 == 0){
+                contours.addNode(node, 0, 1.0);
+            }else{
+                contours.setWidth(node, 1.0 + rand() % 2);
+            }
+            contours.update();
+        }
+        printf("ContourLayout %7d members, one edit: %.1f us\n", members, (now() - start) * 1000000.0 / edits);
+    }
+
+    if (argc < 4){
+        return 0;
+    }
+    DBConnectionInf inf;
+    inf.setDbName(argv[2]);
+    DexDBWrapper db;
+    if ((db.Connect(inf) == -1)||(db.Initiate() == -1)){
+        printf("cannot open %s\n", argv[2]);
+        return 1;
+    }
+    MemberClass root;
+    root.setId(atoi(argv[3]));
+
+    FamilyLayout layout(db);
+    layout.setThreads(threads);
+    double start = now();
+    db.getParentDag();
+    printf("ParentDag load: %.3f s\n", now() - start);
+
+    static const char *names[] = {"descendants", "ancestors"};
+    for (int direction = descendantChart; direction <= ancestorChart; direction++){
+        // the first call also loads the partners
+        for (int pass = 0; pass < 2; pass++){
+            start = now();
+            int boxes = layout.layout(root, static_cast<ChartDirection>(direction));
+            printf("FamilyLayout %s: %d boxes in %.3f s\n", names[direction], boxes, now() - start);
+        }
+    }
+    return 0;
+}
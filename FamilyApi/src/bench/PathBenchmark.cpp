@@ -0,0 +1,98 @@
+/*
+ * Builds a deep family tree in a new database image, generations of the
+ * given width where every member has two parents in the generation
+ * before, then times SinglePairShortestPathBFS against
+ * BidirectionalPathBFS on random pairs of members far apart:
+ *
+ *     pathBenchmark <new database image> [generations] [width] [pairs]
+ */
+
+#include "DexDBWrapper.h"
+#include "BidirectionalPathBFS.h"
+#include "dex/algorithms/SinglePairShortestPathBFS.h"
+#include "BenchClock.h"
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+
+static MemberClass member(int id){
+    MemberClass data;
+    data.setId(id);
+    data.setName("name");
+    data.setSurname("surname");
+    return data;
+}
+
+int main(int argc, char **argv){
+    if (argc < 2){
+        printf("usage: %s <new database image> [generations] [width] [pairs]\n", argv[0]);
+        return 1;
+    }
+    int generations = (argc > 2) ? atoi(argv[2]) : 30;
+    int width = (argc > 3) ? atoi(argv[3]) : 200;
+    int pairs = (argc > 4) ? atoi(argv[4]) : 100;
+    remove(argv[1]);
+    DBConnectionInf inf;
+    inf.setDbName(argv[1]);
+    DexDBWrapper db;
+    if ((db.Connect(inf) == -1)||(db.Initiate() == -1)){
+        printf("cannot create %s\n", argv[1]);
+        return 1;
+    }
+
+    srand(2012);
+    double start = now();
+    int members = generations * width;
+    for (int id = 1; id <= members; id++){
+        db.addMember(member(id));
+    }
+    for (int id = width + 1; id <= members; id++){
+        int first = ((id - 1) / width - 1) * width + 1;
+        int father = first + rand() % width;
+        int mother = first + rand() % width;
+        db.addRelationTo("parent", member(father), member(id));
+        if (mother != father){
+            db.addRelationTo("parent", member(mother), member(id));
+        }
+    }
+    printf("%d members in %d generations: %.3f s\n", members, generations, now() - start);
+
+    // one end in the oldest quarter, the other in the youngest
+    DexSchema &schema = db.getSchema();
+    vector< pair<dex::gdb::oid_t, dex::gdb::oid_t> > sample;
+    int quarter = max(1, members / 4);
+    for (int i = 0; i < pairs; i++){
+        sample.push_back(make_pair(schema.findMember(db.getGraph(), 1 + rand() % quarter),
+                                   schema.findMember(db.getGraph(), members - rand() % quarter)));
+    }
+
+    vector<double> costs(pairs);
+    start = now();
+    for (int i = 0; i < pairs; i++){
+        dex::algorithms::SinglePairShortestPathBFS bfs(*db.getSession(), sample[i].first, sample[i].second);
+        bfs.AddAllEdgeTypes(dex::gdb::Any);
+        bfs.AddNodeType(schema.getMemberType());
+        bfs.Run();
+        costs[i] = bfs.Exists() ? bfs.GetCost() : -1.0;
+    }
+    double single = now() - start;
+
+    int mismatches = 0;
+    dex::gdb::int64_t visited = 0;
+    start = now();
+    for (int i = 0; i < pairs; i++){
+        BidirectionalPathBFS bfs(*db.getSession(), sample[i].first, sample[i].second);
+        bfs.AddAllEdgeTypes(dex::gdb::Any);
+        bfs.AddNodeType(schema.getMemberType());
+        bfs.Run();
+        visited += bfs.GetVisited();
+        mismatches += ((bfs.Exists() ? bfs.GetCost() : -1.0) != costs[i]) ? 1 : 0;
+    }
+    double both = now() - start;
+
+    printf("SinglePairShortestPathBFS: %10.6f s for %d pairs\n", single, pairs);
+    printf("BidirectionalPathBFS:      %10.6f s for %d pairs, %.0f nodes visited per pair\n", both, pairs, static_cast<double>(visited) / pairs);
+    printf("mismatches: %d\n", mismatches);
+    return (mismatches == 0) ? 0 : 2;
+}
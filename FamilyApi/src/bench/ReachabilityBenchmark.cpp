@@ -0,0 +1,88 @@
+/*
+ * Checks ReachabilityIndex against a TraversalBFS from the ancestor on
+ * random member pairs of an existing family database and times both:
+ *
+ *     reachabilityBenchmark <database image> [pairs]
+ */
+
+#include "DexDBWrapper.h"
+#include "dex/gdb/Objects.h"
+#include "dex/algorithms/TraversalBFS.h"
+#include "BenchClock.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static bool traversalIsAncestor(DexDBWrapper &db, dex::gdb::oid_t ancestor, dex::gdb::oid_t member){
+    dex::algorithms::TraversalBFS bfs(*db.getSession(), ancestor);
+    bfs.AddEdgeType(db.getSchema().getParentType(), dex::gdb::Outgoing);
+    bfs.AddNodeType(db.getSchema().getMemberType());
+    while (bfs.HasNext()){
+        if ((bfs.Next() == member)&&(member != ancestor)){
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char **argv){
+    if (argc < 2){
+        printf("usage: %s <database image> [pairs]\n", argv[0]);
+        return 1;
+    }
+    int pairs = (argc > 2) ? atoi(argv[2]) : 1000;
+    DBConnectionInf inf;
+    inf.setDbName(argv[1]);
+
+    DexDBWrapper db;
+    if ((db.Connect(inf) == -1)||(db.Initiate() == -1)){
+        printf("cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    ParentDag &dag = db.getParentDag();
+    ReachabilityIndex index(dag);
+    double start = now();
+    index.build();
+    printf("index build: %.3f s for %d members\n", now() - start, dag.size());
+
+    // half of the pairs are real ancestor/descendant pairs
+    srand(2012);
+    vector< pair<dex::gdb::oid_t, dex::gdb::oid_t> > sample;
+    while (static_cast<int>(sample.size()) < pairs){
+        int member = rand() % dag.size();
+        int ancestor = rand() % dag.size();
+        if ((!dag.isAlive(member))||(!dag.isAlive(ancestor))){
+            continue;
+        }
+        if (sample.size() % 2 == 0){
+            ancestor = member;
+            for (int steps = rand() % 8 + 1; (steps > 0)&&(!dag.getParents(ancestor).empty()); steps--){
+                const vector<int> &parents = dag.getParents(ancestor);
+                ancestor = parents[rand() % parents.size()];
+            }
+        }
+        sample.push_back(make_pair(dag.oidOf(ancestor), dag.oidOf(member)));
+    }
+
+    vector<bool> expected(sample.size());
+    start = now();
+    for (size_t i = 0; i < sample.size(); i++){
+        expected[i] = traversalIsAncestor(db, sample[i].first, sample[i].second);
+    }
+    double traversal = now() - start;
+
+    int positives = 0, mismatches = 0;
+    start = now();
+    for (size_t i = 0; i < sample.size(); i++){
+        bool found = (index.isAncestor(sample[i].first, sample[i].second) == 1);
+        positives += found ? 1 : 0;
+        mismatches += (found != expected[i]) ? 1 : 0;
+    }
+    double labels = now() - start;
+
+    printf("TraversalBFS:      %10.6f s for %d queries\n", traversal, pairs);
+    printf("ReachabilityIndex: %10.6f s for %d queries (%d ancestors)\n", labels, pairs, positives);
+    printf("mismatches: %d\n", mismatches);
+    return (mismatches == 0) ? 0 : 2;
+}
@@ -0,0 +1,69 @@
+/*
+ * Times TopologicalOrder::insertEdge on random parent edges over the
+ * members of an existing family database. Accepted edges only go to the
+ * in-memory ParentDag, the image is not written:
+ *
+ *     topologicalOrderBenchmark <database image> [edges]
+ */
+
+#include "DexDBWrapper.h"
+#include "BenchClock.h"
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char **argv){
+    if (argc < 2){
+        printf("usage: %s <database image> [edges]\n", argv[0]);
+        return 1;
+    }
+    int edges = (argc > 2) ? atoi(argv[2]) : 100000;
+    DBConnectionInf inf;
+    inf.setDbName(argv[1]);
+
+    DexDBWrapper db;
+    if ((db.Connect(inf) == -1)||(db.Initiate() == -1)){
+        printf("cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    ParentDag &dag = db.getParentDag();
+    TopologicalOrder &order = db.getOrder();
+    double start = now();
+    if (order.build() == -1){
+        printf("the image holds a parent cycle\n");
+        return 1;
+    }
+    printf("order build: %.3f s for %d members\n", now() - start, dag.size());
+    if (dag.size() < 2){
+        return 0;
+    }
+
+    // mostly short hops, the way a tree grows, and some across the family
+    srand(2029);
+    vector< pair<int, int> > sample;
+    while (static_cast<int>(sample.size()) < edges){
+        int parent = rand() % dag.size();
+        int child = (sample.size() % 4 == 0) ? rand() % dag.size()
+                                             : (parent + 1 + rand() % 64) % dag.size();
+        if ((dag.isAlive(parent))&&(dag.isAlive(child))&&(parent != child)){
+            sample.push_back(make_pair(parent, child));
+        }
+    }
+
+    int accepted = 0, cycles = 0;
+    start = now();
+    for (size_t i = 0; i < sample.size(); i++){
+        int inserted = order.insertEdge(dag.oidOf(sample[i].first), dag.oidOf(sample[i].second));
+        if (inserted == 1){
+            dag.addEdge(sample[i].first, sample[i].second);
+            accepted++;
+        }else if (inserted == 0){
+            cycles++;
+        }
+    }
+    double seconds = now() - start;
+
+    printf("insertEdge: %10.6f s for %d edges, %.2f us each (%d accepted, %d cycles)\n",
+           seconds, edges, seconds * 1000000.0 / edges, accepted, cycles);
+    return 0;
+}
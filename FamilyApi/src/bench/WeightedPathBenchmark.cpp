@@ -0,0 +1,130 @@
+/*
+ * Builds a family tree in a new database image, generations of the given
+ * width where every member has two parents in the generation before and
+ * the parents are partners, a few children being adopted as well. Parent,
+ * partner and adoption edges cost 1, 2 and 3. Times DEX's
+ * SinglePairShortestPathDijkstra against WeightedRelationSearch on random
+ * pairs of members:
+ *
+ *     weightedPathBenchmark <new database image> [generations] [width] [pairs]
+ */
+
+#include "DexDBWrapper.h"
+#include "WeightedRelationSearch.h"
+#include "Utf8Codec.h"
+#include "dex/algorithms/SinglePairShortestPathDijkstra.h"
+#include "dex/gdb/Objects.h"
+#include "dex/gdb/ObjectsIterator.h"
+#include "dex/gdb/Value.h"
+#include "BenchClock.h"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static MemberClass member(int id){
+    MemberClass data;
+    data.setId(id);
+    data.setName("name");
+    data.setSurname("surname");
+    return data;
+}
+
+static dex::gdb::attr_t costAttribute(dex::gdb::Graph *graph, dex::gdb::type_t type, double cost){
+    dex::gdb::attr_t attr = graph->NewAttribute(type, L"cost", dex::gdb::Double, dex::gdb::Basic);
+    dex::gdb::Value value;
+    value.SetDouble(cost);
+    dex::gdb::Objects *edges = graph->Select(type);
+    dex::gdb::ObjectsIterator *it = edges->Iterator();
+    while (it->HasNext()){
+        graph->SetAttribute(it->Next(), attr, value);
+    }
+    delete it;
+    delete edges;
+    return attr;
+}
+
+int main(int argc, char **argv){
+    if (argc < 2){
+        printf("usage: %s <new database image> [generations] [width] [pairs]\n", argv[0]);
+        return 1;
+    }
+    int generations = (argc > 2) ? atoi(argv[2]) : 20;
+    int width = (argc > 3) ? atoi(argv[3]) : 500;
+    int pairs = (argc > 4) ? atoi(argv[4]) : 100;
+    remove(argv[1]);
+    DBConnectionInf inf;
+    inf.setDbName(argv[1]);
+    DexDBWrapper db;
+    if ((db.Connect(inf) == -1)||(db.Initiate() == -1)||(db.addRelation("adoption") == -1)){
+        printf("cannot create %s\n", argv[1]);
+        return 1;
+    }
+
+    srand(2012);
+    double start = now();
+    int members = generations * width;
+    for (int id = 1; id <= members; id++){
+        db.addMember(member(id));
+    }
+    for (int id = width + 1; id <= members; id++){
+        int first = ((id - 1) / width - 1) * width + 1;
+        int father = first + rand() % width;
+        int mother = first + rand() % width;
+        db.addRelationTo("parent", member(father), member(id));
+        if (mother != father){
+            db.addRelationTo("parent", member(mother), member(id));
+            db.addRelationTo("partner", member(father), member(mother));
+        }
+        if (rand() % 20 == 0){
+            db.addRelationTo("adoption", member(first + rand() % width), member(id));
+        }
+    }
+    dex::gdb::Graph *graph = db.getGraph();
+    DexSchema &schema = db.getSchema();
+    dex::gdb::type_t adoption = schema.findRelation(graph, L"adoption");
+    dex::gdb::attr_t parentCost = costAttribute(graph, schema.getParentType(), 1);
+    dex::gdb::attr_t partnerCost = costAttribute(graph, schema.getPartnerType(), 2);
+    dex::gdb::attr_t adoptionCost = costAttribute(graph, adoption, 3);
+    printf("%d members in %d generations: %.3f s\n", members, generations, now() - start);
+
+    vector< pair<int, int> > sample;
+    for (int i = 0; i < pairs; i++){
+        sample.push_back(make_pair(1 + rand() % members, 1 + rand() % members));
+    }
+
+    vector<double> costs(pairs);
+    start = now();
+    for (int i = 0; i < pairs; i++){
+        dex::algorithms::SinglePairShortestPathDijkstra dijkstra(*db.getSession(),
+            schema.findMember(graph, sample[i].first), schema.findMember(graph, sample[i].second));
+        dijkstra.AddWeightedEdgeType(schema.getParentType(), dex::gdb::Any, parentCost);
+        dijkstra.AddWeightedEdgeType(schema.getPartnerType(), dex::gdb::Any, partnerCost);
+        dijkstra.AddWeightedEdgeType(adoption, dex::gdb::Any, adoptionCost);
+        dijkstra.Run();
+        costs[i] = dijkstra.Exists() ? dijkstra.GetCost() : -1.0;
+    }
+    double heap = now() - start;
+
+    WeightedRelationSearch search(db);
+    search.setCost("parent", dex::gdb::Any, 1);
+    search.setCost("partner", dex::gdb::Any, 2);
+    search.setCost("adoption", dex::gdb::Any, 3);
+    start = now();
+    search.build();
+    double snapshot = now() - start;
+
+    int mismatches = 0;
+    vector<dex::gdb::oid_t> path;
+    start = now();
+    for (int i = 0; i < pairs; i++){
+        int cost = -1;
+        int found = search.findPath(member(sample[i].first), member(sample[i].second), cost, path);
+        mismatches += (((found == 1) ? cost : -1.0) != costs[i]) ? 1 : 0;
+    }
+    double dial = now() - start;
+
+    printf("SinglePairShortestPathDijkstra: %10.6f s for %d pairs\n", heap, pairs);
+    printf("WeightedRelationSearch:         %10.6f s for %d pairs, %.3f s to copy the relations\n", dial, pairs, snapshot);
+    printf("mismatches: %d\n", mismatches);
+    return (mismatches == 0) ? 0 : 2;
+}
@@ -0,0 +1,110 @@
+#include "DexImageTest.h"
+#include "AhnentafelPedigree.h"
+#include "dex/gdb/Objects.h"
+
+
+class AhnentafelPedigreeTest: public DexImageTest {
+protected:
+	static const char * IMAGE;
+
+	AhnentafelPedigree* testedObject;
+	vector<MemberClass> pedigree;
+
+	AhnentafelPedigreeTest()
+	: DexImageTest(IMAGE){
+		testedObject = NULL;
+	}
+
+	virtual void SetUp() {
+		ASSERT_NO_FATAL_FAILURE(DexImageTest::SetUp());
+		testedObject = new AhnentafelPedigree(*wrapper);
+	}
+
+	virtual void TearDown() {
+		delete testedObject;
+		DexImageTest::TearDown();
+	}
+
+	void addMember(int id, Sex sex){
+		MemberClass data = member(id);
+		data.setSex(sex);
+		ASSERT_EQ(1, wrapper->addMember(data));
+	}
+
+	void addParent(int parent, int child){
+		ASSERT_EQ(1, wrapper->addRelationTo("parent", member(parent), member(child)));
+	}
+
+	// full binary pedigree, member n is the Ahnentafel number n of member 1
+	void fullPedigree(int generations){
+		for (int id = 1; id < (1 << generations); id++){
+			addMember(id, (id % 2 == 0) ? male : female);
+		}
+		for (int id = 2; id < (1 << generations); id++){
+			addParent(id, id / 2);
+		}
+	}
+};
+
+const char * AhnentafelPedigreeTest::IMAGE = "ahnentafelPedigreeTest.dex";
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(AhnentafelPedigreeTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(AhnentafelPedigreeTest, UnknownRootFails){
+	EXPECT_EQ(-1, testedObject->fetch(member(1), 3, pedigree));
+}
+
+TEST_F(AhnentafelPedigreeTest, TenGenerationsInNineRoundTrips){
+	fullPedigree(10);
+	ASSERT_EQ(1023, testedObject->fetch(member(1), 10, pedigree));
+	EXPECT_EQ(9, testedObject->getRoundTrips());
+	ASSERT_EQ((unsigned int)1024, pedigree.size());
+	for (unsigned int number = 1; number < 1024; number++){
+		ASSERT_EQ(number, pedigree[number].getId())<<"Wrong member at "<<number;
+	}
+	EXPECT_EQ("name", pedigree[777].getName());
+}
+
+TEST_F(AhnentafelPedigreeTest, StopsAtLimitAndAtFounders){
+	fullPedigree(4);
+	EXPECT_EQ(7, testedObject->fetch(member(1), 3, pedigree));
+	EXPECT_EQ((unsigned int)8, pedigree.size());
+
+	EXPECT_EQ(15, testedObject->fetch(member(1), 6, pedigree));
+	EXPECT_EQ(4, testedObject->getRoundTrips());
+	EXPECT_EQ((unsigned int)0, pedigree[16].getId());
+	EXPECT_EQ(dex::gdb::Objects::InvalidOID, testedObject->getOids()[16]);
+}
+
+TEST_F(AhnentafelPedigreeTest, MotherKeepsOddNumber){
+	addMember(1, nn);
+	addMember(2, female);
+	addMember(3, male);
+	addParent(2, 1);
+	addParent(3, 1);
+	ASSERT_EQ(3, testedObject->fetch(member(1), 2, pedigree));
+	EXPECT_EQ((unsigned int)3, pedigree[2].getId());
+	EXPECT_EQ((unsigned int)2, pedigree[3].getId());
+}
+
+TEST_F(AhnentafelPedigreeTest, CollapsedAncestorGetsEveryNumber){
+	// 2 and 3 are half siblings through 4
+	addMember(1, nn);
+	addMember(2, male);
+	addMember(3, female);
+	addMember(4, male);
+	addParent(2, 1);
+	addParent(3, 1);
+	addParent(4, 2);
+	addParent(4, 3);
+	ASSERT_EQ(5, testedObject->fetch(member(1), 3, pedigree));
+	EXPECT_EQ((unsigned int)4, pedigree[4].getId());
+	EXPECT_EQ((unsigned int)4, pedigree[6].getId());
+	EXPECT_EQ(testedObject->getOids()[4], testedObject->getOids()[6]);
+}
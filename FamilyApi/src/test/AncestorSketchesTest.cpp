@@ -0,0 +1,139 @@
+#include "DexImageTest.h"
+#include "AncestorSketches.h"
+#include <cstdlib>
+
+
+class AncestorSketchesTest: public DexImageTest {
+protected:
+	static const char * IMAGE;
+	static const int MEMBERS = 400;
+
+	AncestorSketches* testedObject;
+
+	AncestorSketchesTest()
+	: DexImageTest(IMAGE){
+		testedObject = NULL;
+	}
+
+	virtual void SetUp() {
+		ASSERT_NO_FATAL_FAILURE(DexImageTest::SetUp());
+		for (int id = 1; id <= MEMBERS; id++){
+			ASSERT_EQ(1, wrapper->addMember(member(id)));
+		}
+		testedObject = new AncestorSketches(*wrapper);
+	}
+
+	virtual void TearDown() {
+		delete testedObject;
+		DexImageTest::TearDown();
+	}
+
+	void addParents(int child, int father, int mother){
+		ASSERT_EQ(1, wrapper->addRelationTo("parent", member(father), member(child)));
+		ASSERT_EQ(1, wrapper->addRelationTo("parent", member(mother), member(child)));
+	}
+
+	double count(int id){
+		double ancestors = -1.0;
+		EXPECT_EQ(1, testedObject->countAncestors(member(id), ancestors));
+		return ancestors;
+	}
+
+	// parents always have lower ids, half of the members get two
+	void randomPedigree(vector< vector<int> > &parents){
+		parents.assign(MEMBERS + 1, vector<int>());
+		for (int id = 21; id <= MEMBERS; id++){
+			int father = id - 1 - rand() % 20;
+			ASSERT_EQ(1, wrapper->addRelationTo("parent", member(father), member(id)));
+			parents[id].push_back(father);
+			int mother = id - 1 - rand() % 20;
+			if ((rand() % 2 == 0)&&(mother != father)){
+				ASSERT_EQ(1, wrapper->addRelationTo("parent", member(mother), member(id)));
+				parents[id].push_back(mother);
+			}
+		}
+	}
+
+	int exactCount(const vector< vector<int> > &parents, int id){
+		vector<bool> seen(MEMBERS + 1, false);
+		vector<int> stack(1, id);
+		int ancestors = 0;
+		while (!stack.empty()){
+			int next = stack.back();
+			stack.pop_back();
+			for (size_t p = 0; p < parents[next].size(); p++){
+				if (!seen[parents[next][p]]){
+					seen[parents[next][p]] = true;
+					ancestors++;
+					stack.push_back(parents[next][p]);
+				}
+			}
+		}
+		return ancestors;
+	}
+};
+
+const char * AncestorSketchesTest::IMAGE = "ancestorSketchesTest.dex";
+const int AncestorSketchesTest::MEMBERS;
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(AncestorSketchesTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(AncestorSketchesTest, FounderHasNoAncestors){
+	double ratio = -1.0;
+	EXPECT_DOUBLE_EQ(0.0, count(1));
+	EXPECT_EQ(1, testedObject->collapseRatio(member(1), ratio));
+	EXPECT_DOUBLE_EQ(0.0, ratio);
+}
+
+TEST_F(AncestorSketchesTest, CollapseOfSiblingsChild){
+	testedObject->setExact(true);
+	addParents(3, 1, 2);
+	addParents(4, 1, 2);
+	addParents(5, 3, 4);
+	double ratio = -1.0;
+	EXPECT_DOUBLE_EQ(4.0, count(5));
+	EXPECT_EQ(1, testedObject->collapseRatio(member(5), ratio));
+	EXPECT_NEAR(1.0 / 3.0, ratio, 1e-12);
+	EXPECT_EQ(1, testedObject->collapseRatio(member(3), ratio));
+	EXPECT_DOUBLE_EQ(0.0, ratio);
+}
+
+TEST_F(AncestorSketchesTest, NewParentReachesDescendants){
+	addParents(3, 1, 2);
+	addParents(5, 3, 4);
+	EXPECT_NEAR(4.0, count(5), 0.1);
+	ASSERT_EQ(1, wrapper->addRelationTo("parent", member(6), member(1)));
+	EXPECT_NEAR(5.0, count(5), 0.1);
+	EXPECT_NEAR(1.0, count(1), 0.1);
+
+	ASSERT_EQ(1, wrapper->delRelationTo("parent", member(6), member(1)));
+	EXPECT_NEAR(4.0, count(5), 0.1);
+}
+
+TEST_F(AncestorSketchesTest, ExactModeMatchesTraversal){
+	srand(34);
+	vector< vector<int> > parents;
+	randomPedigree(parents);
+	testedObject->setExact(true);
+	for (int id = 1; id <= MEMBERS; id++){
+		ASSERT_DOUBLE_EQ(exactCount(parents, id), count(id))<<"Member "<<id;
+	}
+}
+
+TEST_F(AncestorSketchesTest, SketchesStayNearExact){
+	srand(35);
+	vector< vector<int> > parents;
+	randomPedigree(parents);
+	testedObject->setPrecision(10);
+	for (int id = 1; id <= MEMBERS; id++){
+		double exact = exactCount(parents, id);
+		// four standard errors of a 1024 register sketch
+		ASSERT_NEAR(exact, count(id), 0.13 * exact + 1.0)<<"Member "<<id;
+	}
+}
@@ -0,0 +1,112 @@
+#include "DexImageTest.h"
+#include "BidirectionalPathBFS.h"
+#include "dex/algorithms/SinglePairShortestPathBFS.h"
+#include <cstdlib>
+
+
+class BidirectionalPathBFSTest: public DexImageTest {
+protected:
+	static const char * IMAGE;
+	static const int MEMBERS = 200;
+
+	BidirectionalPathBFSTest()
+	: DexImageTest(IMAGE){
+	}
+
+	virtual void SetUp() {
+		ASSERT_NO_FATAL_FAILURE(DexImageTest::SetUp());
+		for (int id = 1; id <= MEMBERS; id++){
+			ASSERT_EQ(1, wrapper->addMember(member(id)));
+		}
+	}
+
+	dex::gdb::oid_t oid(int id){
+		return wrapper->getSchema().findMember(wrapper->getGraph(), id);
+	}
+
+	// every step of the path has to be an edge the search may use
+	void expectValidPath(BidirectionalPathBFS &bfs, dex::gdb::type_t type, dex::gdb::EdgesDirection direction){
+		const vector<dex::gdb::oid_t> &path = bfs.GetPathAsNodes();
+		ASSERT_EQ(bfs.GetCost() + 1, path.size());
+		dex::gdb::Graph *graph = wrapper->getGraph();
+		for (size_t i = 0; i + 1 < path.size(); i++){
+			dex::gdb::Objects *next = graph->Neighbors(path[i], type, direction);
+			EXPECT_TRUE(next->Exists(path[i + 1]))<<"No edge at step "<<i;
+			delete next;
+		}
+	}
+};
+
+const char * BidirectionalPathBFSTest::IMAGE = "bidirectionalPathBFSTest.dex";
+const int BidirectionalPathBFSTest::MEMBERS;
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(BidirectionalPathBFSTest, isNotNull){
+	EXPECT_TRUE(wrapper != NULL)<< "Not initiated";
+}
+
+TEST_F(BidirectionalPathBFSTest, DirectionAndHopsAreHonoured){
+	for (int id = 1; id < 6; id++){
+		ASSERT_EQ(1, wrapper->addRelationTo("parent", member(id), member(id + 1)));
+	}
+	dex::gdb::type_t parent = wrapper->getSchema().getParentType();
+
+	BidirectionalPathBFS down(*wrapper->getSession(), oid(1), oid(6));
+	down.AddEdgeType(parent, dex::gdb::Outgoing);
+	down.Run();
+	ASSERT_TRUE(down.Exists());
+	EXPECT_DOUBLE_EQ(5.0, down.GetCost());
+	expectValidPath(down, parent, dex::gdb::Outgoing);
+
+	BidirectionalPathBFS up(*wrapper->getSession(), oid(6), oid(1));
+	up.AddEdgeType(parent, dex::gdb::Outgoing);
+	up.Run();
+	EXPECT_FALSE(up.Exists());
+
+	BidirectionalPathBFS limited(*wrapper->getSession(), oid(1), oid(6));
+	limited.AddEdgeType(parent, dex::gdb::Any);
+	limited.SetMaximumHops(4);
+	limited.Run();
+	EXPECT_FALSE(limited.Exists());
+}
+
+TEST_F(BidirectionalPathBFSTest, SameCostAsSinglePairBFS){
+	srand(37);
+	ASSERT_EQ(1, wrapper->addRelation("friend"));
+	static const char *relations[] = {"parent", "partner", "friend"};
+	for (int i = 0; i < 250; i++){
+		wrapper->addRelationTo(relations[rand() % 3], member(rand() % MEMBERS + 1), member(rand() % MEMBERS + 1));
+	}
+	dex::gdb::type_t parent = wrapper->getSchema().getParentType();
+	for (int query = 0; query < 200; query++){
+		dex::gdb::oid_t source = oid(rand() % MEMBERS + 1);
+		dex::gdb::oid_t destination = oid(rand() % MEMBERS + 1);
+		dex::gdb::EdgesDirection direction = (query % 2 == 0) ? dex::gdb::Any : dex::gdb::Outgoing;
+
+		dex::algorithms::SinglePairShortestPathBFS single(*wrapper->getSession(), source, destination);
+		single.AddEdgeType(parent, direction);
+		single.AddNodeType(wrapper->getSchema().getMemberType());
+		single.Run();
+
+		BidirectionalPathBFS both(*wrapper->getSession(), source, destination);
+		both.AddEdgeType(parent, direction);
+		both.AddNodeType(wrapper->getSchema().getMemberType());
+		both.Run();
+
+		ASSERT_EQ(single.Exists(), both.Exists())<<"Query "<<query;
+		if (both.Exists()){
+			EXPECT_DOUBLE_EQ(single.GetCost(), both.GetCost())<<"Query "<<query;
+			expectValidPath(both, parent, direction);
+		}
+	}
+}
+
+TEST_F(BidirectionalPathBFSTest, FindRelationUsesAllTypes){
+	ASSERT_EQ(1, wrapper->addRelationTo("parent", member(1), member(2)));
+	ASSERT_EQ(1, wrapper->addRelationTo("partner", member(3), member(2)));
+	EXPECT_EQ(2, wrapper->findRealation(member(1), member(3)));
+	EXPECT_EQ(0, wrapper->findRealation(member(1), member(4)));
+}
@@ -0,0 +1,154 @@
+#include "gtest/gtest.h"
+#include "BufferedRowWriter.h"
+#include "DexSchema.h"
+#include <cstdio>
+#include <cstring>
+
+
+class BufferedRowWriterTest: public testing::Test {
+protected:
+	static const char * PATH;
+
+	BufferedRowWriter* testedObject;
+
+	BufferedRowWriterTest(){
+		testedObject = NULL;
+	}
+
+	virtual void SetUp() {
+		remove(PATH);
+		testedObject = new BufferedRowWriter();
+	}
+
+	virtual void TearDown() {
+		delete testedObject;
+		remove(PATH);
+	}
+
+	// what Close() left in the file
+	string written(){
+		string bytes;
+		FILE *file = fopen(PATH, "rb");
+		if (!file){
+			return bytes;
+		}
+		int c;
+		while ((c = fgetc(file)) != EOF){
+			bytes.push_back(static_cast<char>(c));
+		}
+		fclose(file);
+		return bytes;
+	}
+
+	void addUtf8(const char *text){
+		testedObject->addUtf8(text, strlen(text));
+	}
+};
+
+const char * BufferedRowWriterTest::PATH = "bufferedRowWriterTest.out";
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(BufferedRowWriterTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(BufferedRowWriterTest, QuotesOnlyWhatNeedsIt){
+	ASSERT_EQ(1, testedObject->open(PATH));
+	testedObject->beginRow(5);
+	addUtf8("plain");
+	addUtf8("Nowak, Jan");
+	addUtf8("say \"hi\"");
+	addUtf8("two\nlines");
+	addUtf8("");
+	testedObject->endRow();
+	testedObject->beginRow(4);
+	testedObject->addInteger(-42);
+	testedObject->addNull();
+	testedObject->addDate(DexSchema::timestampOf(1987, 3, 9));
+	testedObject->addDate(DexSchema::timestampOf(812, 12, 31));
+	testedObject->endRow();
+	testedObject->Close();
+
+	EXPECT_EQ(string("plain,\"Nowak, Jan\",\"say \"\"hi\"\"\",\"two\nlines\",\n-42,,1987-03-09,0812-12-31\n"), written());
+}
+
+TEST_F(BufferedRowWriterTest, SeparatorIsQuotedToo){
+	testedObject->setSeparator(';');
+	ASSERT_EQ(1, testedObject->open(PATH));
+	testedObject->beginRow(2);
+	addUtf8("a;b");
+	addUtf8("a,b");
+	testedObject->endRow();
+	testedObject->Close();
+
+	EXPECT_EQ(string("\"a;b\";a,b\n"), written());
+}
+
+TEST_F(BufferedRowWriterTest, BinaryRows){
+	testedObject->setFormat(binaryFormat);
+	ASSERT_EQ(1, testedObject->open(PATH));
+	testedObject->beginRow(4);
+	addUtf8("Zo\xC3\xAB");
+	testedObject->addInteger(-3);
+	testedObject->addInteger(300);
+	testedObject->addNull();
+	testedObject->endRow();
+	testedObject->Close();
+
+	// count, then tag + length + bytes, tag + zigzag varints, tag alone
+	const char expected[] = {4, stringField, 4, 'Z', 'o', '\xC3', '\xAB', integerField, 5,
+	                         integerField, '\xD8', 4, nullField};
+	EXPECT_EQ(string(expected, sizeof(expected)), written());
+	EXPECT_EQ(static_cast<dex::gdb::int64_t>(sizeof(expected)), testedObject->getWritten());
+}
+
+TEST_F(BufferedRowWriterTest, RowsOutgrowTheBuffer){
+	testedObject->setBufferSize(BufferedRowWriter::BufferAlignment);
+	ASSERT_EQ(1, testedObject->open(PATH));
+	string expected;
+	for (int row = 0; row < 5000; row++){
+		testedObject->beginRow(2);
+		testedObject->addInteger(row);
+		addUtf8("Kowalski");
+		testedObject->endRow();
+		char line[32];
+		sprintf(line, "%d,Kowalski\n", row);
+		expected += line;
+	}
+	testedObject->Close();
+
+	EXPECT_EQ(static_cast<dex::gdb::int64_t>(expected.size()), testedObject->getWritten());
+	EXPECT_TRUE(expected == written());
+}
+
+TEST_F(BufferedRowWriterTest, NothingIsWrittenWithoutAFile){
+	EXPECT_EQ(-1, testedObject->open("no/such/directory/rows.csv"));
+	bool refused = false;
+	try{
+		testedObject->beginRow(1);
+	}catch(dex::gdb::IOException &e){
+		refused = true;
+	}
+	EXPECT_TRUE(refused);
+
+	refused = false;
+	try{
+		addUtf8("Nowak");
+	}catch(dex::gdb::IOException &e){
+		refused = true;
+	}
+	EXPECT_TRUE(refused);
+
+	ASSERT_EQ(1, testedObject->open(PATH));
+	testedObject->Close();
+	refused = false;
+	try{
+		testedObject->addInteger(1);
+	}catch(dex::gdb::IOException &e){
+		refused = true;
+	}
+	EXPECT_TRUE(refused);
+}
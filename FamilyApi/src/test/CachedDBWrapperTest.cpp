@@ -0,0 +1,192 @@
+#include "gtest/gtest.h"
+#include "DexDBWrapper.h"
+#include "CachedDBWrapper.h"
+#include <cstdio>
+
+
+class CachedDBWrapperTest: public testing::Test {
+protected:
+	static const char * IMAGE;
+
+	DexDBWrapper* wrapper;
+	CachedDBWrapper* testedObject;
+
+	CachedDBWrapperTest(){
+		wrapper = NULL;
+		testedObject = NULL;
+	}
+
+	// 1 + 2 -> 3, 4; 5 -> 6
+	virtual void SetUp() {
+		remove(IMAGE);
+		DBConnectionInf connection;
+		connection.setDbName(IMAGE);
+		wrapper = new DexDBWrapper();
+		testedObject = new CachedDBWrapper(*wrapper, 64);
+		ASSERT_EQ(1, testedObject->Connect(connection));
+		ASSERT_EQ(1, testedObject->Initiate());
+		for (int id = 1; id <= 6; id++){
+			ASSERT_EQ(1, testedObject->addMember(member(id, (id < 5) ? "Jan" : "Piotr")));
+		}
+		ASSERT_EQ(1, testedObject->addRelationTo("parent", member(1), member(3)));
+		ASSERT_EQ(1, testedObject->addRelationTo("parent", member(2), member(3)));
+		ASSERT_EQ(1, testedObject->addRelationTo("parent", member(1), member(4)));
+		ASSERT_EQ(1, testedObject->addRelationTo("parent", member(2), member(4)));
+		ASSERT_EQ(1, testedObject->addRelationTo("parent", member(5), member(6)));
+	}
+
+	virtual void TearDown() {
+		delete testedObject;
+		delete wrapper;
+		remove(IMAGE);
+	}
+
+	MemberClass member(int id, string name = "Jan"){
+		MemberClass data;
+		data.setId(id);
+		data.setName(name);
+		data.setSurname("Nowak");
+		return data;
+	}
+
+	CacheStats stats(){
+		CacheStats stats;
+		testedObject->getStats(stats);
+		return stats;
+	}
+};
+
+const char * CachedDBWrapperTest::IMAGE = "cachedDBWrapperTest.dex";
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(CachedDBWrapperTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(CachedDBWrapperTest, RepeatedQueriesHit){
+	EXPECT_EQ(2, testedObject->findChildren(member(1)));
+	EXPECT_EQ(2, testedObject->findChildren(member(1)));
+	EXPECT_EQ(1, testedObject->findSiblings(member(3)));
+	EXPECT_EQ(1, testedObject->findSiblings(member(3)));
+	EXPECT_EQ(4, testedObject->findByName(member(1)));
+	EXPECT_EQ(4, testedObject->findByName(member(1)));
+	CacheStats now = stats();
+	EXPECT_EQ(3u, now.hits);
+	EXPECT_EQ(3u, now.misses);
+	EXPECT_EQ(3u, now.entries);
+	EXPECT_GT(now.bytes, 0u);
+}
+
+TEST_F(CachedDBWrapperTest, WritesDropOnlyWhatTheyTouch){
+	EXPECT_EQ(2, testedObject->findChildren(member(1)));
+	EXPECT_EQ(1, testedObject->findChildren(member(5)));
+	EXPECT_EQ(1, testedObject->findSiblings(member(3)));
+	EXPECT_EQ(2, testedObject->findByName(member(5, "Piotr")));
+
+	ASSERT_EQ(1, testedObject->addMember(member(7)));
+	ASSERT_EQ(1, testedObject->addRelationTo("parent", member(1), member(7)));
+
+	EXPECT_EQ(3, testedObject->findChildren(member(1)));
+	EXPECT_EQ(1, testedObject->findSiblings(member(3)));
+	EXPECT_EQ(1, testedObject->findChildren(member(5)));
+	EXPECT_EQ(2, testedObject->findByName(member(5, "Piotr")));
+	CacheStats now = stats();
+	EXPECT_EQ(2u, now.stale);
+	EXPECT_EQ(2u, now.hits);
+}
+
+TEST_F(CachedDBWrapperTest, WritesBehindTheCacheAreSeen){
+	EXPECT_EQ(4, testedObject->findByName(member(1)));
+	EXPECT_EQ(0, testedObject->isAncestor(member(5), member(3)));
+	ASSERT_EQ(1, wrapper->addMember(member(7)));
+	ASSERT_EQ(1, wrapper->addRelationTo("parent", member(5), member(1)));
+	EXPECT_EQ(5, testedObject->findByName(member(1)));
+	EXPECT_EQ(1, testedObject->isAncestor(member(5), member(3)));
+}
+
+TEST_F(CachedDBWrapperTest, DeletedMembersDropTheirNeighbours){
+	EXPECT_EQ(2, testedObject->findChildren(member(1)));
+	EXPECT_EQ(1, testedObject->findSiblings(member(3)));
+	EXPECT_EQ(1, testedObject->findChildren(member(5)));
+	ASSERT_EQ(1, testedObject->delMember(member(4)));
+	EXPECT_EQ(1, testedObject->findChildren(member(1)));
+	EXPECT_EQ(0, testedObject->findSiblings(member(3)));
+	EXPECT_EQ(1, testedObject->findChildren(member(5)));
+	EXPECT_EQ(1u, stats().hits);
+}
+
+TEST_F(CachedDBWrapperTest, FailuresAreNotKept){
+	EXPECT_EQ(-1, testedObject->findChildren(member(9)));
+	ASSERT_EQ(1, testedObject->addMember(member(9)));
+	EXPECT_EQ(0, testedObject->findChildren(member(9)));
+	EXPECT_EQ(0u, stats().hits);
+}
+
+TEST_F(CachedDBWrapperTest, CapacityIsBounded){
+	for (int round = 0; round < 2; round++){
+		for (int i = 1; i <= 6; i++){
+			for (int j = 1; j <= 6; j++){
+				testedObject->findRealation(member(i), member(j));
+				testedObject->isSameFamily(member(i), member(j));
+			}
+		}
+	}
+	CacheStats now = stats();
+	EXPECT_LE(now.entries, 64u);
+	EXPECT_GT(now.evictions, 0u);
+	EXPECT_EQ(144u, now.hits + now.misses);
+	testedObject->clear();
+	EXPECT_EQ(0u, stats().entries);
+}
+
+TEST_F(CachedDBWrapperTest, ClosuresFollowTheirFamilies){
+	EXPECT_EQ(4, testedObject->findFamilySize(member(1)));
+	EXPECT_EQ(2, testedObject->findFamilySize(member(5)));
+	EXPECT_EQ(1, testedObject->isAncestor(member(1), member(3)));
+	EXPECT_EQ(0, testedObject->isSameFamily(member(3), member(6)));
+
+	// grows the family of 1 only
+	ASSERT_EQ(1, testedObject->addMember(member(7)));
+	ASSERT_EQ(1, testedObject->addRelationTo("parent", member(1), member(7)));
+	EXPECT_EQ(2, testedObject->findFamilySize(member(5)));
+	EXPECT_EQ(5, testedObject->findFamilySize(member(1)));
+	EXPECT_EQ(1, testedObject->isAncestor(member(1), member(3)));
+	EXPECT_EQ(0, testedObject->isSameFamily(member(3), member(6)));
+	EXPECT_EQ(2u, stats().hits);
+
+	// joins both
+	ASSERT_EQ(1, testedObject->addRelationTo("parent", member(6), member(7)));
+	EXPECT_EQ(7, testedObject->findFamilySize(member(5)));
+	EXPECT_EQ(7, testedObject->findFamilySize(member(1)));
+	EXPECT_EQ(1, testedObject->isSameFamily(member(3), member(6)));
+
+	// and splits them again
+	ASSERT_EQ(1, testedObject->delRelationTo("parent", member(6), member(7)));
+	EXPECT_EQ(2, testedObject->findFamilySize(member(5)));
+	EXPECT_EQ(5, testedObject->findFamilySize(member(1)));
+	EXPECT_EQ(0, testedObject->isSameFamily(member(3), member(6)));
+}
+
+TEST_F(CachedDBWrapperTest, DeletedMembersSplitTheirFamily){
+	EXPECT_EQ(4, testedObject->findFamilySize(member(3)));
+	EXPECT_EQ(2, testedObject->findFamilySize(member(6)));
+	ASSERT_EQ(1, testedObject->delMember(member(5)));
+	EXPECT_EQ(4, testedObject->findFamilySize(member(3)));
+	EXPECT_EQ(1, testedObject->findFamilySize(member(6)));
+}
+
+TEST_F(CachedDBWrapperTest, StepRelativesFollowPartnersInOtherFamilies){
+	MemberClass partner = member(8);
+	partner.setPartnerId(5);
+	ASSERT_EQ(1, testedObject->addMember(partner));
+	EXPECT_EQ(1, testedObject->findStepRelatives(member(8)));
+
+	ASSERT_EQ(1, testedObject->addMember(member(9)));
+	ASSERT_EQ(1, testedObject->addRelationTo("parent", member(5), member(9)));
+	EXPECT_EQ(2, testedObject->findStepRelatives(member(8)));
+	EXPECT_EQ(2, testedObject->findStepRelatives(member(8)));
+	EXPECT_EQ(1u, stats().hits);
+}
@@ -0,0 +1,126 @@
+#include "gtest/gtest.h"
+#include "ContourLayout.h"
+#include "TreeLayout.h"
+#include <cstdlib>
+
+
+class ContourLayoutTest: public testing::Test {
+protected:
+	ContourLayout* testedObject;
+	vector<int> parent;
+	vector<double> width;
+
+	ContourLayoutTest(){
+		testedObject = NULL;
+	}
+
+	virtual void SetUp() {
+		testedObject = new ContourLayout();
+	}
+
+	virtual void TearDown() {
+		delete testedObject;
+	}
+
+	void randomTree(int nodes, int maxChildren){
+		parent.assign(1, -1);
+		width.assign(1, 1.0);
+		for (int node = 0; (node < static_cast<int>(parent.size()))&&(static_cast<int>(parent.size()) < nodes); node++){
+			int children = rand() % (maxChildren + 1);
+			if (node + 1 == static_cast<int>(parent.size())){
+				children = max(children, 1);
+			}
+			for (int i = 0; (i < children)&&(static_cast<int>(parent.size()) < nodes); i++){
+				parent.push_back(node);
+				width.push_back(1.0 + rand() % 3);
+			}
+		}
+	}
+
+	// lays the current tree out again from scratch with TreeLayout and
+	// compares every position relative to the root
+	void expectSameAsFullLayout(){
+		vector<int> order(1, 0);
+		vector<int> parents(1, -1);
+		vector<double> widths(1, width[0]);
+		for (size_t i = 0; i < order.size(); i++){
+			const vector<int> &kids = testedObject->getChildren(order[i]);
+			for (size_t k = 0; k < kids.size(); k++){
+				order.push_back(kids[k]);
+				parents.push_back(static_cast<int>(i));
+				widths.push_back(width[kids[k]]);
+			}
+		}
+		TreeLayout full;
+		full.setThreads(1);
+		full.layout(parents, widths);
+		for (size_t i = 0; i < order.size(); i++){
+			ASSERT_NEAR(full.getX(i) - full.getX(0), testedObject->getX(order[i]), 1e-6)<<"Node "<<order[i];
+		}
+	}
+};
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(ContourLayoutTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(ContourLayoutTest, BuildMatchesTreeLayout){
+	srand(41);
+	for (int round = 0; round < 100; round++){
+		randomTree(2 + rand() % 300, 1 + rand() % 5);
+		testedObject->build(parent, width);
+		expectSameAsFullLayout();
+	}
+}
+
+TEST_F(ContourLayoutTest, AddedChildMovesSiblings){
+	int tree[] = {-1, 0, 0};
+	parent.assign(tree, tree + 3);
+	width.assign(3, 1.0);
+	testedObject->build(parent, width);
+	EXPECT_DOUBLE_EQ(-1.0, testedObject->getOffset(1));
+
+	width.push_back(1.0);
+	int added = testedObject->addNode(0, 2, 1.0);
+	testedObject->update();
+	EXPECT_DOUBLE_EQ(-2.0, testedObject->getOffset(1));
+	EXPECT_DOUBLE_EQ(2.0, testedObject->getX(added));
+	EXPECT_EQ((unsigned int)3, testedObject->getMoved().size());
+}
+
+TEST_F(ContourLayoutTest, EditsMatchTreeLayout){
+	srand(42);
+	for (int round = 0; round < 50; round++){
+		randomTree(2 + rand() % 200, 1 + rand() % 4);
+		testedObject->build(parent, width);
+		for (int edit = 0; edit < 30; edit++){
+			int node = rand() % testedObject->size();
+			if (!testedObject->isAlive(node)){
+				continue;
+			}
+			switch (rand() % 3){
+			case 0:
+				width.push_back(1.0 + rand() % 3);
+				testedObject->addNode(node, rand() % (testedObject->getChildren(node).size() + 1), width.back());
+				break;
+			case 1:
+				if (node != 0){
+					testedObject->removeSubtree(node);
+				}
+				break;
+			default:
+				width[node] = 1.0 + rand() % 3;
+				testedObject->setWidth(node, width[node]);
+			}
+			// edits may also be batched before an update
+			if (rand() % 3 != 0){
+				testedObject->update();
+				expectSameAsFullLayout();
+			}
+		}
+	}
+}
@@ -0,0 +1,105 @@
+#include "DexImageTest.h"
+
+
+class DexDBWrapperTest: public DexImageTest {
+protected:
+	static const char * IMAGE;
+
+	DexDBWrapper* testedObject;
+
+	DexDBWrapperTest()
+	: DexImageTest(IMAGE){
+		testedObject = NULL;
+	}
+
+	// 1 + 2 have 5 and 6, 2 and 3 (partners) have 7,
+	// 1 names 4 as partner by partnerId, 4 has 8 with someone unknown
+	virtual void SetUp() {
+		ASSERT_NO_FATAL_FAILURE(DexImageTest::SetUp());
+		testedObject = wrapper;
+		for (int id = 1; id <= 9; id++){
+			MemberClass data = member(id);
+			if (id == 1){
+				data.setPartnerId(4);
+			}
+			ASSERT_EQ(1, testedObject->addMember(data));
+		}
+		ASSERT_EQ(1, testedObject->addRelationTo("parent", member(1), member(5)));
+		ASSERT_EQ(1, testedObject->addRelationTo("parent", member(2), member(5)));
+		ASSERT_EQ(1, testedObject->addRelationTo("parent", member(1), member(6)));
+		ASSERT_EQ(1, testedObject->addRelationTo("parent", member(2), member(6)));
+		ASSERT_EQ(1, testedObject->addRelationTo("parent", member(2), member(7)));
+		ASSERT_EQ(1, testedObject->addRelationTo("parent", member(3), member(7)));
+		ASSERT_EQ(1, testedObject->addRelationTo("partner", member(2), member(3)));
+		ASSERT_EQ(1, testedObject->addRelationTo("parent", member(4), member(8)));
+	}
+
+	static bool contains(vector<MemberClass> &members, unsigned int id){
+		for (size_t i = 0; i < members.size(); i++){
+			if (members[i].getId() == id){
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+const char * DexDBWrapperTest::IMAGE = "dexDBWrapperTest.dex";
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(DexDBWrapperTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(DexDBWrapperTest, Siblings){
+	vector<MemberClass> siblings;
+	ASSERT_EQ(1, testedObject->findSiblings(member(5), siblings));
+	EXPECT_EQ(6u, siblings[0].getId());
+	EXPECT_EQ(0, testedObject->findSiblings(member(7)));
+	EXPECT_EQ(0, testedObject->findSiblings(member(1)));
+	EXPECT_EQ(-1, testedObject->findSiblings(member(10)));
+}
+
+TEST_F(DexDBWrapperTest, HalfSiblings){
+	vector<MemberClass> siblings;
+	ASSERT_EQ(2, testedObject->findHalfSiblings(member(7), siblings));
+	EXPECT_TRUE(contains(siblings, 5));
+	EXPECT_TRUE(contains(siblings, 6));
+	ASSERT_EQ(1, testedObject->findHalfSiblings(member(5), siblings));
+	EXPECT_EQ(7u, siblings[0].getId());
+}
+
+TEST_F(DexDBWrapperTest, StepRelatives){
+	vector<MemberClass> relatives;
+	// 3 is the partner of a parent, 7 the child of that partner is a
+	// half sibling already; 4 and 8 come in through partnerId
+	ASSERT_EQ(3, testedObject->findStepRelatives(member(5), relatives));
+	EXPECT_TRUE(contains(relatives, 3));
+	EXPECT_TRUE(contains(relatives, 4));
+	EXPECT_TRUE(contains(relatives, 8));
+	// children of the member's partners are step-children
+	ASSERT_EQ(2, testedObject->findStepRelatives(member(3), relatives));
+	EXPECT_TRUE(contains(relatives, 5));
+	EXPECT_TRUE(contains(relatives, 6));
+	ASSERT_EQ(1, testedObject->findStepRelatives(member(1), relatives));
+	EXPECT_EQ(8u, relatives[0].getId());
+}
+
+TEST_F(DexDBWrapperTest, OidOfFollowsMembers){
+	DexSchema &schema = testedObject->getSchema();
+	for (unsigned int id = 1; id <= 9; id++){
+		EXPECT_EQ(schema.findMember(testedObject->getGraph(), id), testedObject->oidOf(id))<<"Member "<<id;
+	}
+	EXPECT_EQ(dex::gdb::Objects::InvalidOID, testedObject->oidOf(10));
+	ASSERT_EQ(1, testedObject->delMember(member(9)));
+	EXPECT_EQ(dex::gdb::Objects::InvalidOID, testedObject->oidOf(9));
+	ASSERT_EQ(1, testedObject->addMember(member(10)));
+	EXPECT_EQ(schema.findMember(testedObject->getGraph(), 10), testedObject->oidOf(10));
+	// the index is rebuilt from the image
+	testedObject->resetIndexes();
+	EXPECT_EQ(schema.findMember(testedObject->getGraph(), 10), testedObject->oidOf(10));
+	EXPECT_EQ(dex::gdb::Objects::InvalidOID, testedObject->oidOf(9));
+}
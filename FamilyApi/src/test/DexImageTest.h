@@ -0,0 +1,49 @@
+#ifndef DEXIMAGETEST_H
+#define DEXIMAGETEST_H
+
+#include "gtest/gtest.h"
+#include "DexDBWrapper.h"
+#include <cstdio>
+
+
+// Base fixture of the tests that need a family database: a wrapper on an
+// empty image of the test's own, removed before and after every test.
+// A fixture adds its members in SetUp() after DexImageTest::SetUp() and
+// frees what it made in TearDown() before DexImageTest::TearDown().
+class DexImageTest: public testing::Test {
+protected:
+	DexDBWrapper* wrapper;
+
+	DexImageTest(const char *image){
+		this->image = image;
+		wrapper = NULL;
+	}
+
+	virtual void SetUp() {
+		remove(image);
+		DBConnectionInf connection;
+		connection.setDbName(image);
+		wrapper = new DexDBWrapper();
+		ASSERT_EQ(1, wrapper->Connect(connection));
+		ASSERT_EQ(1, wrapper->Initiate());
+	}
+
+	virtual void TearDown() {
+		delete wrapper;
+		wrapper = NULL;
+		remove(image);
+	}
+
+	MemberClass member(int id){
+		MemberClass data;
+		data.setId(id);
+		data.setName("name");
+		data.setSurname("surname");
+		return data;
+	}
+
+private:
+	const char * image;
+};
+
+#endif // DEXIMAGETEST_H
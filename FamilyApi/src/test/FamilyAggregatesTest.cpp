@@ -0,0 +1,131 @@
+#include "DexImageTest.h"
+#include "FamilyAggregates.h"
+
+
+class FamilyAggregatesTest: public DexImageTest {
+protected:
+	static const char * IMAGE;
+
+	FamilyAggregates* testedObject;
+
+	FamilyAggregatesTest()
+	: DexImageTest(IMAGE){
+		testedObject = NULL;
+	}
+
+	// 1 (1801-1871) + 2 (1805-1865) -> 3 (1832-1902) -> 4 (1860), 5 (1857)
+	virtual void SetUp() {
+		ASSERT_NO_FATAL_FAILURE(DexImageTest::SetUp());
+		ASSERT_EQ(1, wrapper->addMember(member(1, "Nowak", 1801, 1871)));
+		ASSERT_EQ(1, wrapper->addMember(member(2, "Lis", 1805, 1865)));
+		ASSERT_EQ(1, wrapper->addMember(member(3, "Nowak", 1832, 1902)));
+		ASSERT_EQ(1, wrapper->addRelationTo("parent", member(1, "", -1, -1), member(3, "", -1, -1)));
+		ASSERT_EQ(1, wrapper->addRelationTo("parent", member(2, "", -1, -1), member(3, "", -1, -1)));
+		testedObject = new FamilyAggregates(*wrapper);
+		ASSERT_EQ(1, testedObject->build());
+		ASSERT_EQ(1, wrapper->addMember(member(4, "Nowak", 1860, -1)));
+		ASSERT_EQ(1, wrapper->addMember(member(5, "Kot", 1857, -1)));
+		ASSERT_EQ(1, wrapper->addRelationTo("parent", member(3, "", -1, -1), member(4, "", -1, -1)));
+	}
+
+	virtual void TearDown() {
+		delete testedObject;
+		DexImageTest::TearDown();
+	}
+
+	MemberClass member(int id, string surname, int birth, int heaven){
+		MemberClass data;
+		data.setId(id);
+		data.setName("name");
+		data.setSurname(surname);
+		data.setBirthDate(date(birth));
+		data.setHeavenDate(date(heaven));
+		return data;
+	}
+
+	DateClass date(int year){
+		DateClass date;
+		if (year != -1){
+			tm time = {};
+			time.tm_year = year;
+			time.tm_mday = 1;
+			string cause;
+			date.setDate(time, cause);
+		}
+		return date;
+	}
+};
+
+const char * FamilyAggregatesTest::IMAGE = "familyAggregatesTest.dex";
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(FamilyAggregatesTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(FamilyAggregatesTest, SurnamesAndDecades){
+	EXPECT_EQ(3, testedObject->countSurname("Nowak"));
+	EXPECT_EQ(1, testedObject->countSurname("Kot"));
+	EXPECT_EQ(0, testedObject->countSurname("Zielinski"));
+	EXPECT_EQ(2, testedObject->countDecade(1800));
+	EXPECT_EQ(1, testedObject->countDecade(1830));
+	EXPECT_EQ(1, testedObject->countDecade(1850));
+	EXPECT_EQ(1, testedObject->countDecade(1860));
+	EXPECT_EQ(0, testedObject->countDecade(1870));
+	EXPECT_EQ(3u, testedObject->getSurnames().size());
+}
+
+TEST_F(FamilyAggregatesTest, Generations){
+	EXPECT_EQ(3, testedObject->generations());
+	EXPECT_EQ(3, testedObject->countGeneration(0));
+	EXPECT_EQ(1, testedObject->countGeneration(1));
+	EXPECT_EQ(1, testedObject->countGeneration(2));
+	double years = 0.0;
+	ASSERT_EQ(1, testedObject->averageLifespan(0, years));
+	EXPECT_DOUBLE_EQ(65.0, years);
+	ASSERT_EQ(1, testedObject->averageLifespan(1, years));
+	EXPECT_DOUBLE_EQ(70.0, years);
+	EXPECT_EQ(0, testedObject->averageLifespan(2, years));
+
+	// 5 becomes the parent of 1: everybody below moves down one
+	ASSERT_EQ(1, wrapper->addRelationTo("parent", member(5, "", -1, -1), member(1, "", -1, -1)));
+	EXPECT_EQ(4, testedObject->generations());
+	EXPECT_EQ(2, testedObject->countGeneration(0));
+	EXPECT_EQ(1, testedObject->countGeneration(1));
+	EXPECT_EQ(1, testedObject->countGeneration(3));
+
+	ASSERT_EQ(1, wrapper->delRelationTo("parent", member(5, "", -1, -1), member(1, "", -1, -1)));
+	EXPECT_EQ(3, testedObject->generations());
+	EXPECT_EQ(3, testedObject->countGeneration(0));
+}
+
+TEST_F(FamilyAggregatesTest, DeletedMembers){
+	ASSERT_EQ(1, wrapper->delMember(member(3, "", -1, -1)));
+	EXPECT_EQ(2, testedObject->countSurname("Nowak"));
+	EXPECT_EQ(0, testedObject->countDecade(1830));
+	EXPECT_EQ(1, testedObject->generations());
+	EXPECT_EQ(4, testedObject->countGeneration(0));
+}
+
+TEST_F(FamilyAggregatesTest, DeletedParentLiftsOnlyItsLine){
+	// 5 -> 1 moves the whole line down, deleting 5 lifts it back
+	ASSERT_EQ(1, wrapper->addRelationTo("parent", member(5, "", -1, -1), member(1, "", -1, -1)));
+	ASSERT_EQ(4, testedObject->generations());
+	ASSERT_EQ(1, wrapper->delMember(member(5, "", -1, -1)));
+	EXPECT_EQ(3, testedObject->generations());
+	EXPECT_EQ(2, testedObject->countGeneration(0));
+	EXPECT_EQ(1, testedObject->countGeneration(1));
+	EXPECT_EQ(1, testedObject->countGeneration(2));
+	EXPECT_EQ(0, testedObject->countDecade(1850));
+
+	// 3 keeps 2 as a parent, so nothing moves without 1
+	ASSERT_EQ(1, wrapper->delMember(member(1, "", -1, -1)));
+	EXPECT_EQ(3, testedObject->generations());
+	EXPECT_EQ(1, testedObject->countGeneration(0));
+	double years = 0.0;
+	ASSERT_EQ(1, testedObject->averageLifespan(0, years));
+	EXPECT_DOUBLE_EQ(60.0, years);
+}
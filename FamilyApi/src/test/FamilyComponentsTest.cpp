@@ -0,0 +1,127 @@
+#include "DexImageTest.h"
+#include "FamilyComponents.h"
+#include "dex/algorithms/WeakConnectivityDFS.h"
+#include <cstdlib>
+
+
+class FamilyComponentsTest: public DexImageTest {
+protected:
+	static const char * IMAGE;
+	static const int MEMBERS = 300;
+
+	DexDBWrapper* testedObject;
+
+	FamilyComponentsTest()
+	: DexImageTest(IMAGE){
+		testedObject = NULL;
+	}
+
+	virtual void SetUp() {
+		ASSERT_NO_FATAL_FAILURE(DexImageTest::SetUp());
+		testedObject = wrapper;
+		ASSERT_EQ(1, testedObject->addRelation("friend"));
+		for (int id = 1; id <= MEMBERS; id++){
+			ASSERT_EQ(1, testedObject->addMember(member(id)));
+		}
+	}
+
+	void addRandomRelations(int count){
+		static const char *relations[] = {"parent", "partner", "friend"};
+		for (int i = 0; i < count; i++){
+			// a parent edge may be refused as a cycle, that is fine here
+			testedObject->addRelationTo(relations[rand() % 3], member(rand() % MEMBERS + 1), member(rand() % MEMBERS + 1));
+		}
+	}
+
+	// compares every pair and every size with a fresh WeakConnectivityDFS
+	void expectSameAsDex(){
+		DexSchema &schema = testedObject->getSchema();
+		dex::algorithms::WeakConnectivityDFS dfs(*testedObject->getSession());
+		dfs.AddAllEdgeTypes();
+		dfs.AddNodeType(schema.getMemberType());
+		dfs.Run();
+		dex::algorithms::ConnectedComponents *components = dfs.GetConnectedComponents();
+
+		FamilyComponents &families = testedObject->getFamilyComponents();
+		EXPECT_EQ(components->GetCount(), families.countFamilies())<<"Number of families is not correct";
+
+		vector<dex::gdb::oid_t> oids;
+		for (int id = 1; id <= MEMBERS; id++){
+			oids.push_back(schema.findMember(testedObject->getGraph(), id));
+		}
+		for (int i = 0; i < MEMBERS; i++){
+			dex::gdb::int64_t component = components->GetConnectedComponent(oids[i]);
+			EXPECT_EQ(components->GetSize(component), families.familySize(oids[i]))<<"Wrong size for member "<<i + 1;
+			for (int j = i + 1; j < MEMBERS; j++){
+				int same = (component == components->GetConnectedComponent(oids[j])) ? 1 : 0;
+				ASSERT_EQ(same, families.sameFamily(oids[i], oids[j]))<<"Members "<<i + 1<<" and "<<j + 1;
+			}
+		}
+		delete components;
+	}
+};
+
+const char * FamilyComponentsTest::IMAGE = "familyComponentsTest.dex";
+const int FamilyComponentsTest::MEMBERS;
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(FamilyComponentsTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(FamilyComponentsTest, EveryMemberAloneAtStart){
+	EXPECT_EQ(MEMBERS, testedObject->getFamilyComponents().countFamilies());
+	EXPECT_EQ(0, testedObject->isSameFamily(member(1), member(2)));
+	EXPECT_EQ(1, testedObject->findFamilySize(member(1)));
+}
+
+TEST_F(FamilyComponentsTest, RelationJoinsFamilies){
+	ASSERT_EQ(1, testedObject->addRelationTo("parent", member(1), member(2)));
+	ASSERT_EQ(1, testedObject->addRelationTo("partner", member(3), member(1)));
+
+	EXPECT_EQ(1, testedObject->isSameFamily(member(2), member(3)));
+	EXPECT_EQ(3, testedObject->findFamilySize(member(2)));
+	EXPECT_EQ(0, testedObject->isSameFamily(member(2), member(4)));
+	EXPECT_EQ(MEMBERS - 2, testedObject->getFamilyComponents().countFamilies());
+}
+
+TEST_F(FamilyComponentsTest, DeleteSplitsFamily){
+	ASSERT_EQ(1, testedObject->addRelationTo("parent", member(1), member(2)));
+	ASSERT_EQ(1, testedObject->addRelationTo("parent", member(2), member(3)));
+	EXPECT_EQ(3, testedObject->findFamilySize(member(1)));
+
+	ASSERT_EQ(1, testedObject->delRelationTo("parent", member(2), member(3)));
+	EXPECT_EQ(0, testedObject->isSameFamily(member(1), member(3)));
+	EXPECT_EQ(2, testedObject->findFamilySize(member(1)));
+
+	ASSERT_EQ(1, testedObject->delMember(member(2)));
+	EXPECT_EQ(1, testedObject->findFamilySize(member(1)));
+	EXPECT_EQ(-1, testedObject->findFamilySize(member(2)));
+}
+
+TEST_F(FamilyComponentsTest, AgreesWithWeakConnectivityWhileGrowing){
+	srand(30);
+	for (int round = 0; round < 5; round++){
+		addRandomRelations(40);
+		expectSameAsDex();
+	}
+}
+
+TEST_F(FamilyComponentsTest, AgreesWithWeakConnectivityAfterDeletes){
+	srand(31);
+	addRandomRelations(200);
+	expectSameAsDex();
+
+	for (int id = 1; id <= MEMBERS; id += 7){
+		testedObject->delRelationTo("parent", member(id), member(id + 1));
+		testedObject->delRelationTo("friend", member(id + 2), member(id));
+	}
+	ASSERT_EQ(1, testedObject->delRelation("friend"));
+	expectSameAsDex();
+
+	addRandomRelations(100);
+	expectSameAsDex();
+}
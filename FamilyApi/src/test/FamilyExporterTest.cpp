@@ -0,0 +1,175 @@
+#include "gtest/gtest.h"
+#include "DexDBWrapper.h"
+#include "FamilyExporter.h"
+#include "FamilyImporter.h"
+#include "ImportCheckpoint.h"
+#include "SeekableCSVReader.h"
+#include <cstdio>
+
+
+class FamilyExporterTest: public testing::Test {
+protected:
+	static const char * IMAGE;
+	static const char * COPY;
+	static const char * CHECKPOINT;
+	static const char * MEMBERS;
+	static const char * RELATIONS;
+	static const int MEMBERS_COUNT = 12;
+
+	DexDBWrapper* wrapper;
+	FamilyExporter* testedObject;
+
+	FamilyExporterTest(){
+		wrapper = NULL;
+		testedObject = NULL;
+	}
+
+	// a line of parents and children, names that need quoting, partners
+	virtual void SetUp() {
+		remove(IMAGE);
+		remove(COPY);
+		ImportCheckpoint(CHECKPOINT).clear();
+		open(IMAGE);
+		static const char *names[] = {"Jan", "Anna, \"Ania\"", "Zo\xC3\xAB", "Piotr\nJan"};
+		for (unsigned int id = 1; id <= MEMBERS_COUNT; id++){
+			MemberClass data = member(id);
+			data.setName(names[id % 4]);
+			data.setSurname((id % 3 == 0) ? "Nowak" : "Kowalski-Lis");
+			data.setSex((id % 2 == 0) ? female : male);
+			if (id % 5 != 0){
+				DateClass birth;
+				tm time;
+				time.tm_year = 1700 + 10 * id;
+				time.tm_mon = static_cast<int>(id % 12);
+				time.tm_mday = 1 + static_cast<int>(id);
+				time.tm_hour = time.tm_min = time.tm_sec = 0;
+				time.tm_wday = time.tm_yday = time.tm_isdst = 0;
+				string cause;
+				ASSERT_EQ(1, birth.setDate(time, cause));
+				data.setBirthDate(birth);
+			}
+			if (id % 4 == 1){
+				data.setPartnerId(id + 1);
+			}
+			ASSERT_EQ(1, wrapper->addMember(data));
+		}
+		for (unsigned int id = 3; id <= MEMBERS_COUNT; id++){
+			ASSERT_EQ(1, wrapper->addRelationTo("parent", member(id - 2), member(id)));
+		}
+		ASSERT_EQ(1, wrapper->addRelationTo("partner", member(1), member(2)));
+	}
+
+	virtual void TearDown() {
+		close();
+		remove(IMAGE);
+		remove(COPY);
+		remove(MEMBERS);
+		remove(RELATIONS);
+		ImportCheckpoint(CHECKPOINT).clear();
+	}
+
+	void open(const char *image){
+		close();
+		DBConnectionInf connection;
+		connection.setDbName(image);
+		wrapper = new DexDBWrapper();
+		ASSERT_EQ(1, wrapper->Connect(connection));
+		ASSERT_EQ(1, wrapper->Initiate());
+		testedObject = new FamilyExporter(*wrapper);
+	}
+
+	void close(){
+		delete testedObject;
+		delete wrapper;
+		testedObject = NULL;
+		wrapper = NULL;
+	}
+
+	MemberClass member(unsigned int id){
+		MemberClass data;
+		data.setId(id);
+		return data;
+	}
+
+	// every stored attribute of every member, and the children and partners
+	vector<string> contents(){
+		vector<string> lines;
+		DexSchema &schema = wrapper->getSchema();
+		for (unsigned int id = 1; id <= MEMBERS_COUNT; id++){
+			MemberClass data;
+			schema.readMember(wrapper->getGraph(), wrapper->oidOf(id), data);
+			char line[64];
+			sprintf(line, "%u %d %d-%d-%d %u %d %d", data.getId(), data.getSex(),
+			        data.getBirthDate().getYear(), data.getBirthDate().getMon(), data.getBirthDate().getMday(),
+			        data.getPartnerId(), wrapper->findChildren(member(id)), wrapper->findStepRelatives(member(id)));
+			lines.push_back(line + (" " + data.getName()) + "|" + data.getSurname());
+		}
+		return lines;
+	}
+
+	// exports the image as CSV, then imports the files into a new one
+	void exportAndImport(){
+		BufferedRowWriter members, relations;
+		ASSERT_EQ(1, members.open(MEMBERS));
+		ASSERT_EQ(1, relations.open(RELATIONS));
+		ASSERT_EQ(MEMBERS_COUNT, testedObject->exportMembers(members));
+		ASSERT_EQ(MEMBERS_COUNT - 2 + 1, testedObject->exportRelations(relations));
+
+		open(COPY);
+		ImportCheckpoint checkpoint(CHECKPOINT);
+		FamilyImporter importer(*wrapper, checkpoint);
+		SeekableCSVReader membersReader, relationsReader;
+		ASSERT_EQ(1, membersReader.open(MEMBERS));
+		ASSERT_EQ(1, relationsReader.open(RELATIONS));
+		ASSERT_EQ(1, importer.run(membersReader, relationsReader));
+		EXPECT_EQ(MEMBERS_COUNT + MEMBERS_COUNT - 2 + 1, importer.getImported());
+		EXPECT_EQ(0, importer.getRejected());
+	}
+};
+
+const char * FamilyExporterTest::IMAGE = "familyExporterTest.dex";
+const char * FamilyExporterTest::COPY = "familyExporterCopy.dex";
+const char * FamilyExporterTest::CHECKPOINT = "familyExporterTest.ckpt";
+const char * FamilyExporterTest::MEMBERS = "familyExporterTest.members.csv";
+const char * FamilyExporterTest::RELATIONS = "familyExporterTest.relations.csv";
+const int FamilyExporterTest::MEMBERS_COUNT;
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(FamilyExporterTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(FamilyExporterTest, CsvImportsBackTheSame){
+	vector<string> exported = contents();
+	exportAndImport();
+	vector<string> imported = contents();
+	ASSERT_EQ(exported.size(), imported.size());
+	for (size_t i = 0; i < exported.size(); i++){
+		EXPECT_EQ(exported[i], imported[i]);
+	}
+}
+
+TEST_F(FamilyExporterTest, HeaderRowIsFirst){
+	testedObject->setHeader(true);
+	BufferedRowWriter relations;
+	ASSERT_EQ(1, relations.open(RELATIONS));
+	ASSERT_EQ(MEMBERS_COUNT - 2 + 1, testedObject->exportRelations(relations));
+	SeekableCSVReader reader;
+	ASSERT_EQ(1, reader.open(RELATIONS));
+	dex::gdb::StringList row;
+	ASSERT_TRUE(reader.Read(row));
+	dex::gdb::StringListIterator *it = row.Iterator();
+	EXPECT_TRUE(it->Next() == L"relation");
+	EXPECT_TRUE(it->Next() == L"id_1");
+	EXPECT_TRUE(it->Next() == L"id_2");
+	delete it;
+}
+
+TEST_F(FamilyExporterTest, ClosedWriterFailsTheExport){
+	BufferedRowWriter members;
+	EXPECT_EQ(-1, members.open("no/such/directory/members.csv"));
+	EXPECT_EQ(-1, testedObject->exportMembers(members));
+}
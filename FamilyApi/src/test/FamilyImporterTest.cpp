@@ -0,0 +1,310 @@
+#include "gtest/gtest.h"
+#include "DexDBWrapper.h"
+#include "FamilyImporter.h"
+#include "ImportCheckpoint.h"
+#include "SeekableCSVReader.h"
+#include <cstdio>
+
+
+// Gives up after a number of rows, the way a crash or a full disk would
+// stop an import in the middle of a batch.
+class FailingCSVReader : public SeekableCSVReader
+{
+public:
+    FailingCSVReader(int rows){
+        this->rows = rows;
+    }
+
+    dex::gdb::bool_t Read(dex::gdb::StringList &row)
+    throw(dex::gdb::IOException){
+        if (rows-- == 0){
+            throw dex::gdb::IOException("Import interrupted");
+        }
+        return SeekableCSVReader::Read(row);
+    }
+
+private:
+    int rows;
+};
+
+class FamilyImporterTest: public testing::Test {
+protected:
+	static const char * IMAGE;
+	static const char * REFERENCE;
+	static const char * CHECKPOINT;
+	static const char * MEMBERS;
+	static const char * RELATIONS;
+	static const int BATCH = 4;
+
+	DexDBWrapper* wrapper;
+	ImportCheckpoint* checkpoint;
+	FamilyImporter* testedObject;
+
+	FamilyImporterTest(){
+		wrapper = NULL;
+		checkpoint = NULL;
+		testedObject = NULL;
+	}
+
+	// 30 members (one with a bad id), 20 parent edges (one to nobody)
+	virtual void SetUp() {
+		remove(IMAGE);
+		remove(REFERENCE);
+		ImportCheckpoint(CHECKPOINT).clear();
+		FILE *members = fopen(MEMBERS, "wb");
+		ASSERT_TRUE(members != NULL);
+		for (int id = 1; id <= 30; id++){
+			if (id == 17){
+				fprintf(members, "x17,Bad,Row,m,1800,,0\n");
+			}else{
+				fprintf(members, "%d,%s,Nowak,%s,%d-03-01,,0\n", id, (id % 3 == 0) ? "Ewa" : "Jan", (id % 2 == 0) ? "f" : "m", 1700 + id);
+			}
+		}
+		fclose(members);
+		FILE *relations = fopen(RELATIONS, "wb");
+		ASSERT_TRUE(relations != NULL);
+		for (int id = 2; id <= 20; id++){
+			fprintf(relations, "parent,%d,%d\n", id / 2, id);
+		}
+		fprintf(relations, "parent,1,99\n");
+		fclose(relations);
+		open(IMAGE);
+	}
+
+	virtual void TearDown() {
+		close();
+		remove(IMAGE);
+		remove(REFERENCE);
+		remove(MEMBERS);
+		remove(RELATIONS);
+		ImportCheckpoint(CHECKPOINT).clear();
+	}
+
+	// a fresh wrapper, checkpoint and importer, as after a restart
+	void open(const char *image, string checkpointPath = CHECKPOINT){
+		close();
+		DBConnectionInf connection;
+		connection.setDbName(image);
+		wrapper = new DexDBWrapper();
+		ASSERT_EQ(1, wrapper->Connect(connection));
+		ASSERT_EQ(1, wrapper->Initiate());
+		checkpoint = new ImportCheckpoint(checkpointPath);
+		testedObject = new FamilyImporter(*wrapper, *checkpoint);
+		testedObject->setBatchSize(BATCH);
+	}
+
+	void close(){
+		delete testedObject;
+		delete checkpoint;
+		delete wrapper;
+		testedObject = NULL;
+		checkpoint = NULL;
+		wrapper = NULL;
+	}
+
+	void appendMembers(const char *rows){
+		FILE *members = fopen(MEMBERS, "ab");
+		ASSERT_TRUE(members != NULL);
+		fputs(rows, members);
+		fclose(members);
+	}
+
+	void appendRelations(const char *rows){
+		FILE *relations = fopen(RELATIONS, "ab");
+		ASSERT_TRUE(relations != NULL);
+		fputs(rows, relations);
+		fclose(relations);
+	}
+
+	int run(SeekableCSVReader &members, SeekableCSVReader &relations){
+		EXPECT_EQ(1, members.open(MEMBERS));
+		EXPECT_EQ(1, relations.open(RELATIONS));
+		return testedObject->run(members, relations);
+	}
+
+	struct Outcome{
+		dex::gdb::int64_t nodes;
+		dex::gdb::int64_t edges;
+		dex::gdb::int64_t imported;
+		dex::gdb::int64_t rejected;
+		vector<int> children;
+	};
+
+	Outcome outcome(){
+		Outcome outcome;
+		outcome.nodes = wrapper->getGraph()->CountNodes();
+		outcome.edges = wrapper->getGraph()->CountEdges();
+		outcome.imported = testedObject->getImported();
+		outcome.rejected = testedObject->getRejected();
+		for (unsigned int id = 1; id <= 30; id++){
+			MemberClass member;
+			member.setId(id);
+			outcome.children.push_back(wrapper->findChildren(member));
+		}
+		return outcome;
+	}
+
+	// the same files imported in one go into another image
+	Outcome reference(){
+		open(REFERENCE, CHECKPOINT + string(".reference"));
+		checkpoint->clear();
+		SeekableCSVReader members, relations;
+		EXPECT_EQ(1, run(members, relations));
+		Outcome outcome = this->outcome();
+		checkpoint->clear();
+		return outcome;
+	}
+
+	void expectSame(const Outcome &expected, const Outcome &actual){
+		EXPECT_EQ(expected.nodes, actual.nodes);
+		EXPECT_EQ(expected.edges, actual.edges);
+		EXPECT_EQ(expected.imported, actual.imported);
+		EXPECT_EQ(expected.rejected, actual.rejected);
+		EXPECT_TRUE(expected.children == actual.children);
+	}
+};
+
+const char * FamilyImporterTest::IMAGE = "familyImporterTest.dex";
+const char * FamilyImporterTest::REFERENCE = "familyImporterReference.dex";
+const char * FamilyImporterTest::CHECKPOINT = "familyImporterTest.ckpt";
+const char * FamilyImporterTest::MEMBERS = "familyImporterTest.members.csv";
+const char * FamilyImporterTest::RELATIONS = "familyImporterTest.relations.csv";
+const int FamilyImporterTest::BATCH;
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(FamilyImporterTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(FamilyImporterTest, ImportsInOneGo){
+	SeekableCSVReader members, relations;
+	ASSERT_EQ(1, run(members, relations));
+	Outcome done = outcome();
+	EXPECT_EQ(29, done.nodes);
+	EXPECT_EQ(19, done.edges);
+	EXPECT_EQ(29 + 19, done.imported);
+	EXPECT_EQ(2, done.rejected);
+	EXPECT_EQ(2, done.children[0]);
+	EXPECT_EQ(-1, done.children[16]);
+}
+
+TEST_F(FamilyImporterTest, ResumesAfterFailingInMembers){
+	FailingCSVReader failing(10);
+	SeekableCSVReader relations;
+	ASSERT_EQ(-1, run(failing, relations));
+	// the half batch went in, the checkpoint points at its start
+	EXPECT_EQ(10, wrapper->getGraph()->CountNodes());
+	EXPECT_EQ(8, testedObject->getImported());
+
+	open(IMAGE);
+	SeekableCSVReader members, relations_2;
+	ASSERT_EQ(1, run(members, relations_2));
+	Outcome resumed = outcome();
+	close();
+	expectSame(reference(), resumed);
+}
+
+TEST_F(FamilyImporterTest, ResumesAfterFailingInRelations){
+	SeekableCSVReader members;
+	FailingCSVReader failing(6);
+	ASSERT_EQ(-1, run(members, failing));
+	EXPECT_EQ(29, wrapper->getGraph()->CountNodes());
+
+	open(IMAGE);
+	SeekableCSVReader members_2, relations;
+	ASSERT_EQ(1, run(members_2, relations));
+	Outcome resumed = outcome();
+	close();
+	expectSame(reference(), resumed);
+}
+
+TEST_F(FamilyImporterTest, ResumesTwice){
+	FailingCSVReader failing(3);
+	SeekableCSVReader relations;
+	ASSERT_EQ(-1, run(failing, relations));
+	open(IMAGE);
+	SeekableCSVReader members;
+	FailingCSVReader failingRelations(13);
+	ASSERT_EQ(-1, run(members, failingRelations));
+	open(IMAGE);
+	SeekableCSVReader members_2, relations_2;
+	ASSERT_EQ(1, run(members_2, relations_2));
+	Outcome resumed = outcome();
+	close();
+	expectSame(reference(), resumed);
+}
+
+TEST_F(FamilyImporterTest, FinishedImportIsNotRepeated){
+	SeekableCSVReader members, relations;
+	ASSERT_EQ(1, run(members, relations));
+	open(IMAGE);
+	SeekableCSVReader members_2, relations_2;
+	EXPECT_EQ(0, run(members_2, relations_2));
+	EXPECT_EQ(29, wrapper->getGraph()->CountNodes());
+	EXPECT_EQ(29 + 19, testedObject->getImported());
+	EXPECT_EQ(2, testedObject->getRejected());
+
+	// imported again, every member is in the tree already
+	checkpoint->clear();
+	SeekableCSVReader members_3, relations_3;
+	EXPECT_EQ(1, run(members_3, relations_3));
+	EXPECT_EQ(29, wrapper->getGraph()->CountNodes());
+	EXPECT_EQ(30 + 1, testedObject->getRejected());
+}
+
+TEST_F(FamilyImporterTest, DuplicateIdsAreRejected){
+	MemberClass present;
+	present.setId(40);
+	present.setName("Ola");
+	ASSERT_EQ(1, wrapper->addMember(present));
+	appendMembers("5,Twice,Nowak,m,1705,,0\n40,Present,Nowak,f,1740,,0\n31,Last,Nowak,f,1731,,0\n");
+
+	SeekableCSVReader members, relations;
+	ASSERT_EQ(1, run(members, relations));
+	EXPECT_EQ(29 + 1 + 1, wrapper->getGraph()->CountNodes());
+	EXPECT_EQ(29 + 1 + 19, testedObject->getImported());
+	EXPECT_EQ(2 + 2, testedObject->getRejected());
+	MemberClass first;
+	first.setId(5);
+	ASSERT_EQ(1, wrapper->findMember(first));
+	MemberClass kept;
+	wrapper->getSchema().readMember(wrapper->getGraph(), wrapper->oidOf(40), kept);
+	EXPECT_EQ(string("Ola"), kept.getName());
+}
+
+TEST_F(FamilyImporterTest, ResumeRejectsTheSameDuplicates){
+	// rows 29 to 32 are one batch and it fails after storing 32
+	appendMembers("32,Next,Nowak,f,1732,,0\n5,Twice,Nowak,m,1705,,0\n32,Again,Nowak,f,1732,,0\n");
+	FailingCSVReader failing(31);
+	SeekableCSVReader relations;
+	ASSERT_EQ(-1, run(failing, relations));
+
+	open(IMAGE);
+	SeekableCSVReader members, relations_2;
+	ASSERT_EQ(1, run(members, relations_2));
+	Outcome resumed = outcome();
+	close();
+	Outcome expected = reference();
+	expectSame(expected, resumed);
+	EXPECT_EQ(2 + 2, expected.rejected);
+}
+
+TEST_F(FamilyImporterTest, ParentCyclesAreRejected){
+	// 1 and 2 are ancestors of 20 and 10
+	appendRelations("parent,20,1\nparent,10,2\nparent,3,2\n");
+	SeekableCSVReader members, relations;
+	ASSERT_EQ(1, run(members, relations));
+	EXPECT_EQ(19 + 1, wrapper->getGraph()->CountEdges());
+	EXPECT_EQ(2 + 2, testedObject->getRejected());
+
+	MemberClass parent, child;
+	parent.setId(20);
+	child.setId(21);
+	EXPECT_EQ(1, wrapper->addRelationTo("parent", parent, child));
+	parent.setId(21);
+	child.setId(1);
+	EXPECT_EQ(-1, wrapper->addRelationTo("parent", parent, child));
+}
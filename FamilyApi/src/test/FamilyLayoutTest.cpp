@@ -0,0 +1,234 @@
+#include "DexImageTest.h"
+#include "FamilyLayout.h"
+#include <cstdlib>
+#include <algorithm>
+#include <map>
+
+
+class FamilyLayoutTest: public DexImageTest {
+protected:
+	static const char * IMAGE;
+
+	FamilyLayout* testedObject;
+	// what the image should hold, as (tail, head) ids
+	vector< pair<int, int> > parentEdges;
+	vector< pair<int, int> > partnerEdges;
+	int nextId;
+
+	FamilyLayoutTest()
+	: DexImageTest(IMAGE){
+		testedObject = NULL;
+	}
+
+	// 1 -> 2, 3; 2 -> 4, 5; 3 -> 6; 2 and 7 are partners
+	virtual void SetUp() {
+		ASSERT_NO_FATAL_FAILURE(DexImageTest::SetUp());
+		nextId = 1;
+		for (int id = 1; id <= 7; id++){
+			addMember();
+		}
+		addParent(1, 2);
+		addParent(1, 3);
+		addParent(2, 4);
+		addParent(2, 5);
+		addParent(3, 6);
+		addPartner(2, 7);
+		testedObject = new FamilyLayout(*wrapper);
+		testedObject->setThreads(1);
+	}
+
+	virtual void TearDown() {
+		delete testedObject;
+		DexImageTest::TearDown();
+	}
+
+	int addMember(){
+		EXPECT_EQ(1, wrapper->addMember(member(nextId)));
+		return nextId++;
+	}
+
+	void addParent(int parent, int child){
+		if (wrapper->addRelationTo("parent", member(parent), member(child)) == 1){
+			parentEdges.push_back(make_pair(parent, child));
+		}
+	}
+
+	void addPartner(int member_1, int member_2){
+		if ((member_1 != member_2)&&(wrapper->addRelationTo("partner", member(member_1), member(member_2)) == 1)){
+			partnerEdges.push_back(make_pair(member_1, member_2));
+		}
+	}
+
+	void deleteEdge(const char *relation, vector< pair<int, int> > &edges){
+		if (edges.empty()){
+			return;
+		}
+		size_t i = rand() % edges.size();
+		ASSERT_EQ(1, wrapper->delRelationTo(relation, member(edges[i].first), member(edges[i].second)));
+		edges.erase(edges.begin() + i);
+	}
+
+	// a member is drawn once, a partner once next to each member
+	typedef pair< pair<dex::gdb::oid_t, bool>, dex::gdb::oid_t > BoxKey;
+	typedef map<BoxKey, LayoutBox> Boxes;
+
+	static Boxes byMember(const vector<LayoutBox> &boxes){
+		Boxes found;
+		for (size_t i = 0; i < boxes.size(); i++){
+			dex::gdb::oid_t hangsFrom = (boxes[i].parentBox == -1) ? dex::gdb::Objects::InvalidOID : boxes[boxes[i].parentBox].member;
+			found[BoxKey(make_pair(boxes[i].member, boxes[i].partner), hangsFrom)] = boxes[i];
+		}
+		return found;
+	}
+
+	// the boxes kept up to date are the ones a fresh layout draws
+	void expectSameAsFullLayout(int root, ChartDirection direction, const char *after){
+		const vector<LayoutBox> &kept = testedObject->getBoxes();
+		FamilyLayout full(*wrapper);
+		full.setThreads(1);
+		ASSERT_EQ(static_cast<int>(kept.size()), full.layout(member(root), direction))<<"Box count after "<<after;
+
+		Boxes expected = byMember(full.getBoxes());
+		Boxes actual = byMember(kept);
+		ASSERT_EQ(expected.size(), actual.size())<<"A box is drawn twice after "<<after;
+		for (Boxes::iterator it = expected.begin(); it != expected.end(); ++it){
+			Boxes::iterator found = actual.find(it->first);
+			ASSERT_TRUE(found != actual.end())<<"Member "<<it->first.first.first<<" not drawn the same after "<<after;
+			EXPECT_NEAR(it->second.x, found->second.x, 1e-6)<<"Member "<<it->first.first.first<<" after "<<after;
+			EXPECT_EQ(it->second.generation, found->second.generation)<<"Member "<<it->first.first.first<<" after "<<after;
+		}
+	}
+
+	bool wasMoved(int id){
+		const vector<dex::gdb::oid_t> &moved = testedObject->getMoved();
+		return find(moved.begin(), moved.end(), wrapper->oidOf(id)) != moved.end();
+	}
+
+	// random edits around the chart, checked against a full layout each
+	void randomEdits(int root, ChartDirection direction, int steps){
+		for (int step = 0; step < steps; step++){
+			int kind = rand() % 6;
+			int some = rand() % (nextId - 1) + 1;
+			if (kind == 0){
+				int id = addMember();
+				if (direction == descendantChart){
+					addParent(some, id);
+				}else{
+					addParent(id, some);
+				}
+				expectSameAsFullLayout(root, direction, "a new member");
+			}else if (kind == 1){
+				addParent(some, rand() % (nextId - 1) + 1);
+				expectSameAsFullLayout(root, direction, "a new parent edge");
+			}else if (kind == 2){
+				addPartner(some, rand() % (nextId - 1) + 1);
+				expectSameAsFullLayout(root, direction, "a new partner edge");
+			}else if (kind == 3){
+				deleteEdge("partner", partnerEdges);
+				expectSameAsFullLayout(root, direction, "a deleted partner edge");
+			}else{
+				deleteEdge("parent", parentEdges);
+				expectSameAsFullLayout(root, direction, "a deleted parent edge");
+			}
+		}
+	}
+};
+
+const char * FamilyLayoutTest::IMAGE = "familyLayoutTest.dex";
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(FamilyLayoutTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(FamilyLayoutTest, DescendantChart){
+	// six members and one partner box
+	ASSERT_EQ(7, testedObject->layout(member(1), descendantChart));
+	expectSameAsFullLayout(1, descendantChart, "the first layout");
+}
+
+TEST_F(FamilyLayoutTest, GrowAndShrinkMatchFullLayout){
+	ASSERT_EQ(7, testedObject->layout(member(1), descendantChart));
+	int child = addMember();
+	addParent(6, child);
+	EXPECT_TRUE(wasMoved(child));
+	expectSameAsFullLayout(1, descendantChart, "a new grandchild");
+
+	ASSERT_EQ(1, wrapper->delRelationTo("parent", member(2), member(5)));
+	expectSameAsFullLayout(1, descendantChart, "a deleted child");
+	EXPECT_EQ(7u, testedObject->getBoxes().size());
+}
+
+TEST_F(FamilyLayoutTest, ResizeFollowsPartners){
+	ASSERT_EQ(7, testedObject->layout(member(1), descendantChart));
+	addPartner(3, 7);
+	expectSameAsFullLayout(1, descendantChart, "a second partner");
+	EXPECT_EQ(8u, testedObject->getBoxes().size());
+	ASSERT_EQ(1, wrapper->delRelationTo("partner", member(3), member(7)));
+	expectSameAsFullLayout(1, descendantChart, "the second partner removed");
+	EXPECT_EQ(7u, testedObject->getBoxes().size());
+}
+
+TEST_F(FamilyLayoutTest, CoupleLinkedTwiceStaysACouple){
+	ASSERT_EQ(7, testedObject->layout(member(1), descendantChart));
+	// the same way round again, then the other way round
+	ASSERT_EQ(1, wrapper->addRelationTo("partner", member(2), member(7)));
+	ASSERT_EQ(1, wrapper->addRelationTo("partner", member(7), member(2)));
+	ASSERT_EQ(1, wrapper->delRelationTo("partner", member(2), member(7)));
+	EXPECT_EQ(7u, testedObject->getBoxes().size());
+	expectSameAsFullLayout(1, descendantChart, "one of three partner edges removed");
+	ASSERT_EQ(1, wrapper->delRelationTo("partner", member(7), member(2)));
+	EXPECT_EQ(7u, testedObject->getBoxes().size());
+	expectSameAsFullLayout(1, descendantChart, "two of three partner edges removed");
+	ASSERT_EQ(1, wrapper->delRelationTo("partner", member(2), member(7)));
+	EXPECT_EQ(6u, testedObject->getBoxes().size());
+	expectSameAsFullLayout(1, descendantChart, "every partner edge removed");
+}
+
+TEST_F(FamilyLayoutTest, PartnerIdNamesAPartner){
+	ASSERT_EQ(7, testedObject->layout(member(1), descendantChart));
+	// 8 names 4, the partner edge between them comes and goes
+	MemberClass named = member(nextId++);
+	named.setPartnerId(4);
+	ASSERT_EQ(1, wrapper->addMember(named));
+	EXPECT_EQ(8u, testedObject->getBoxes().size());
+	expectSameAsFullLayout(1, descendantChart, "a member naming a partner");
+	ASSERT_EQ(1, wrapper->addRelationTo("partner", member(8), member(4)));
+	ASSERT_EQ(1, wrapper->delRelationTo("partner", member(8), member(4)));
+	EXPECT_EQ(8u, testedObject->getBoxes().size());
+	expectSameAsFullLayout(1, descendantChart, "the partner edge removed");
+
+	// 9 names 10 before 10 is there
+	named = member(nextId++);
+	named.setPartnerId(10);
+	ASSERT_EQ(1, wrapper->addMember(named));
+	addParent(6, 9);
+	EXPECT_EQ(9u, testedObject->getBoxes().size());
+	addMember();
+	EXPECT_EQ(10u, testedObject->getBoxes().size());
+	expectSameAsFullLayout(1, descendantChart, "the named partner added");
+}
+
+TEST_F(FamilyLayoutTest, SecondLineIsLaidOutAgain){
+	ASSERT_EQ(7, testedObject->layout(member(1), descendantChart));
+	// 6 is reached through 4 now as well, the nearer line keeps it
+	addParent(4, 6);
+	expectSameAsFullLayout(1, descendantChart, "pedigree collapse");
+	ASSERT_EQ(1, wrapper->delMember(member(3)));
+	expectSameAsFullLayout(1, descendantChart, "a deleted member");
+}
+
+TEST_F(FamilyLayoutTest, RandomEditsMatchFullLayout){
+	srand(31);
+	ASSERT_EQ(7, testedObject->layout(member(1), descendantChart));
+	randomEdits(1, descendantChart, 200);
+}
+
+TEST_F(FamilyLayoutTest, RandomEditsMatchFullPedigree){
+	srand(32);
+	ASSERT_EQ(3, testedObject->layout(member(5), ancestorChart));
+	randomEdits(5, ancestorChart, 200);
+}
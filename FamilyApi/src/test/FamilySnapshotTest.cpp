@@ -0,0 +1,253 @@
+#include "DexImageTest.h"
+#include "FamilySnapshot.h"
+#include <pthread.h>
+
+
+class FamilySnapshotTest: public DexImageTest {
+protected:
+	static const char * IMAGE;
+
+	SnapshotPublisher* testedObject;
+
+	FamilySnapshotTest()
+	: DexImageTest(IMAGE){
+		testedObject = NULL;
+	}
+
+	// 1 + 2 -> 3 -> 4
+	virtual void SetUp() {
+		ASSERT_NO_FATAL_FAILURE(DexImageTest::SetUp());
+		for (unsigned int id = 1; id <= 4; id++){
+			ASSERT_EQ(1, wrapper->addMember(member(id, (id == 2) ? "Ewa" : "Jan")));
+		}
+		ASSERT_EQ(1, wrapper->addRelationTo("parent", member(1), member(3)));
+		ASSERT_EQ(1, wrapper->addRelationTo("parent", member(2), member(3)));
+		ASSERT_EQ(1, wrapper->addRelationTo("parent", member(3), member(4)));
+		testedObject = new SnapshotPublisher(*wrapper);
+	}
+
+	virtual void TearDown() {
+		delete testedObject;
+		DexImageTest::TearDown();
+	}
+
+	MemberClass member(unsigned int id, string name = "Jan"){
+		MemberClass data;
+		data.setId(id);
+		data.setName(name);
+		data.setSurname("Nowak");
+		return data;
+	}
+};
+
+const char * FamilySnapshotTest::IMAGE = "familySnapshotTest.dex";
+
+// What the reader threads share with the test; only touched with __sync.
+struct SnapshotReaders{
+	SnapshotPublisher *publisher;
+	int done;
+	int reads;
+	int changed;
+	int missing;
+};
+
+static MemberClass snapshotMember(unsigned int id){
+	MemberClass data;
+	data.setId(id);
+	return data;
+}
+
+// Takes the latest snapshot, with no lock, and reads it over and over;
+// whatever the writer does meanwhile, the answers have to stay those of
+// the first read.
+static void * readSnapshots(void *arg){
+	SnapshotReaders *shared = static_cast<SnapshotReaders *>(arg);
+	while (!__sync_add_and_fetch(&shared->done, 0)){
+		FamilySnapshot snapshot;
+		if (shared->publisher->read(snapshot) != 1){
+			__sync_add_and_fetch(&shared->missing, 1);
+			continue;
+		}
+		int size = snapshot.size();
+		int named = snapshot.findByName(snapshotMember(0), NULL);
+		int children = snapshot.findChildren(snapshotMember(3), NULL);
+		int ancestor = snapshot.isAncestor(snapshotMember(1), snapshotMember(4));
+		int changed = 0;
+		for (int i = 0; i < 50; i++){
+			if ((snapshot.size() != size)||
+				(snapshot.findByName(snapshotMember(0), NULL) != named)||
+				(snapshot.findChildren(snapshotMember(3), NULL) != children)||
+				(snapshot.isAncestor(snapshotMember(1), snapshotMember(4)) != ancestor)){
+				changed++;
+			}
+		}
+		snapshot.release();
+		__sync_add_and_fetch(&shared->reads, 1);
+		__sync_add_and_fetch(&shared->changed, changed);
+	}
+	return NULL;
+}
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(FamilySnapshotTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(FamilySnapshotTest, ReadsTheState){
+	FamilySnapshot snapshot;
+	EXPECT_FALSE(snapshot.isValid());
+	ASSERT_EQ(1, testedObject->acquire(snapshot));
+	EXPECT_EQ(4, snapshot.size());
+	EXPECT_NE(dex::gdb::Objects::InvalidOID, snapshot.findMember(member(3)));
+	EXPECT_EQ(dex::gdb::Objects::InvalidOID, snapshot.findMember(member(9)));
+	EXPECT_EQ(3, snapshot.findByName(member(0), NULL));
+	vector<unsigned int> ids;
+	EXPECT_EQ(2, snapshot.findParents(member(3), &ids));
+	EXPECT_EQ(1, snapshot.findChildren(member(3), &ids));
+	EXPECT_EQ(4u, ids[0]);
+	EXPECT_EQ(1, snapshot.isAncestor(member(2), member(4)));
+	EXPECT_EQ(0, snapshot.isAncestor(member(4), member(2)));
+	EXPECT_EQ(-1, snapshot.isAncestor(member(9), member(2)));
+}
+
+TEST_F(FamilySnapshotTest, LaterWritesDoNotShow){
+	FamilySnapshot before;
+	ASSERT_EQ(1, testedObject->acquire(before));
+	ASSERT_EQ(1, wrapper->addMember(member(5)));
+	ASSERT_EQ(1, wrapper->addRelationTo("parent", member(4), member(5)));
+	ASSERT_EQ(1, wrapper->delRelationTo("parent", member(1), member(3)));
+	ASSERT_EQ(1, wrapper->delMember(member(2)));
+
+	EXPECT_EQ(4, before.size());
+	EXPECT_EQ(3, before.findByName(member(0), NULL));
+	EXPECT_EQ(2, before.findParents(member(3), NULL));
+	EXPECT_EQ(0, before.findChildren(member(4), NULL));
+	EXPECT_EQ(1, before.isAncestor(member(2), member(4)));
+
+	FamilySnapshot after;
+	ASSERT_EQ(1, testedObject->acquire(after));
+	EXPECT_GT(after.getEpoch(), before.getEpoch());
+	EXPECT_EQ(4, after.size());
+	EXPECT_EQ(4, after.findByName(member(0), NULL));
+	EXPECT_EQ(0, after.findParents(member(3), NULL));
+	EXPECT_EQ(1, after.findChildren(member(4), NULL));
+	EXPECT_EQ(-1, after.isAncestor(member(2), member(4)));
+	EXPECT_EQ(dex::gdb::Objects::InvalidOID, after.findMember(member(2)));
+}
+
+TEST_F(FamilySnapshotTest, UnchangedStateIsShared){
+	FamilySnapshot first;
+	FamilySnapshot second;
+	ASSERT_EQ(1, testedObject->acquire(first));
+	ASSERT_EQ(1, testedObject->acquire(second));
+	EXPECT_EQ(first.getEpoch(), second.getEpoch());
+	FamilySnapshot copy = first;
+	first.release();
+	EXPECT_FALSE(first.isValid());
+	EXPECT_EQ(4, copy.size());
+}
+
+TEST_F(FamilySnapshotTest, ResetKeepsHandedOutSnapshots){
+	FamilySnapshot before;
+	ASSERT_EQ(1, testedObject->acquire(before));
+	wrapper->resetIndexes();
+	EXPECT_EQ(4, before.size());
+	FamilySnapshot after;
+	ASSERT_EQ(1, testedObject->acquire(after));
+	EXPECT_EQ(4, after.size());
+	EXPECT_GT(after.getEpoch(), before.getEpoch());
+}
+
+TEST_F(FamilySnapshotTest, GrowsPastOneChunk){
+	FamilySnapshot before;
+	ASSERT_EQ(1, testedObject->acquire(before));
+	for (int id = 100; id < 100 + 3 * SnapshotPublisher::RecordsPerChunk; id++){
+		ASSERT_EQ(1, wrapper->addMember(member(static_cast<unsigned int>(id))));
+	}
+	FamilySnapshot after;
+	ASSERT_EQ(1, testedObject->acquire(after));
+	EXPECT_EQ(4 + 3 * SnapshotPublisher::RecordsPerChunk, after.size());
+	EXPECT_EQ(3 + 3 * SnapshotPublisher::RecordsPerChunk, after.findByName(member(0), NULL));
+	EXPECT_NE(dex::gdb::Objects::InvalidOID, after.findMember(member(100 + SnapshotPublisher::RecordsPerChunk)));
+	EXPECT_EQ(4, before.size());
+}
+
+TEST_F(FamilySnapshotTest, NothingToReadBeforeTheFirstAcquire){
+	FamilySnapshot snapshot;
+	EXPECT_EQ(0, testedObject->read(snapshot));
+	EXPECT_FALSE(snapshot.isValid());
+	FamilySnapshot first;
+	ASSERT_EQ(1, testedObject->acquire(first));
+	EXPECT_EQ(1, testedObject->read(snapshot));
+	EXPECT_EQ(first.getEpoch(), snapshot.getEpoch());
+}
+
+TEST_F(FamilySnapshotTest, WritesArePublishedWithoutAcquire){
+	FamilySnapshot before;
+	ASSERT_EQ(1, testedObject->acquire(before));
+	ASSERT_EQ(1, wrapper->addMember(member(5)));
+	ASSERT_EQ(1, wrapper->addRelationTo("parent", member(4), member(5)));
+	FamilySnapshot after;
+	ASSERT_EQ(1, testedObject->read(after));
+	EXPECT_EQ(testedObject->getEpoch(), after.getEpoch());
+	EXPECT_EQ(5, after.size());
+	EXPECT_EQ(1, after.isAncestor(member(1), member(5)));
+	EXPECT_EQ(4, before.size());
+}
+
+TEST_F(FamilySnapshotTest, ThreadsReadWhileTheWrapperWrites){
+	int live = SnapshotPublisher::getLive();
+	FamilySnapshot first;
+	ASSERT_EQ(1, testedObject->acquire(first));
+	first.release();
+	SnapshotReaders shared;
+	shared.publisher = testedObject;
+	shared.done = 0;
+	shared.reads = 0;
+	shared.changed = 0;
+	shared.missing = 0;
+
+	pthread_t readers[4];
+	int started = 0;
+	while ((started < 4)&&(pthread_create(&readers[started], NULL, readSnapshots, &shared) == 0)){
+		started++;
+	}
+	// children of 3 come and go, 1 -> 3 is cut and tied again now and then
+	int written = 1;
+	for (int id = 100; (id < 100 + 2 * SnapshotPublisher::RecordsPerChunk)&&(written == 1); id++){
+		unsigned int added = static_cast<unsigned int>(id);
+		written = wrapper->addMember(member(added, (id % 3 == 0) ? "Ewa" : "Jan"));
+		if (written == 1){
+			written = wrapper->addRelationTo("parent", member(3), member(added));
+		}
+		if ((written == 1)&&(id % 4 == 3)){
+			written = wrapper->delMember(member(added - 2));
+		}
+		if ((written == 1)&&(id % 50 == 0)){
+			written = wrapper->delRelationTo("parent", member(1), member(3));
+			if (written == 1){
+				written = wrapper->addRelationTo("parent", member(1), member(3));
+			}
+		}
+	}
+	__sync_add_and_fetch(&shared.done, 1);
+	for (int i = 0; i < started; i++){
+		pthread_join(readers[i], NULL);
+	}
+
+	EXPECT_EQ(4, started);
+	EXPECT_EQ(1, written);
+	EXPECT_EQ(0, shared.changed);
+	EXPECT_EQ(0, shared.missing);
+	EXPECT_GT(shared.reads, 0);
+	FamilySnapshot last;
+	ASSERT_EQ(1, testedObject->read(last));
+	EXPECT_EQ(testedObject->getEpoch(), last.getEpoch());
+	last.release();
+	delete testedObject;
+	testedObject = NULL;
+	EXPECT_EQ(live, SnapshotPublisher::getLive());
+}
@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+#include "HeavyHitters.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+
+class HeavyHittersTest: public testing::Test {
+protected:
+	static const int CAPACITY = 100;
+	static const int KEYS = 5000;
+	static const int STREAM = 200000;
+
+	HeavyHitters* testedObject;
+	map<string, long long> exact;
+
+	HeavyHittersTest(){
+		testedObject = NULL;
+	}
+
+	// Zipf-like stream over KEYS names, the way surnames are spread
+	virtual void SetUp() {
+		testedObject = new HeavyHitters(CAPACITY);
+		srand(45);
+		vector<double> cumulative(KEYS);
+		double sum = 0.0;
+		for (int i = 0; i < KEYS; i++){
+			sum += 1.0 / pow(i + 1.0, 1.1);
+			cumulative[i] = sum;
+		}
+		for (int i = 0; i < STREAM; i++){
+			double draw = sum * rand() / (RAND_MAX + 1.0);
+			int rank = static_cast<int>(lower_bound(cumulative.begin(), cumulative.end(), draw) - cumulative.begin());
+			char key[16];
+			sprintf(key, "name%d", rank);
+			testedObject->add(key);
+			exact[key]++;
+		}
+	}
+
+	virtual void TearDown() {
+		delete testedObject;
+	}
+};
+
+const int HeavyHittersTest::CAPACITY;
+const int HeavyHittersTest::KEYS;
+const int HeavyHittersTest::STREAM;
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(HeavyHittersTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+	EXPECT_EQ(STREAM, testedObject->getTotal());
+}
+
+TEST_F(HeavyHittersTest, CountsStayWithinTheBound){
+	long long bound = STREAM / CAPACITY;
+	vector<HeavyHitter> hitters;
+	ASSERT_EQ(CAPACITY, testedObject->top(CAPACITY, hitters));
+	for (size_t i = 0; i < hitters.size(); i++){
+		long long truth = exact[hitters[i].key];
+		EXPECT_GE(hitters[i].count, truth)<<hitters[i].key;
+		EXPECT_LE(hitters[i].count - hitters[i].error, truth)<<hitters[i].key;
+		EXPECT_LE(hitters[i].error, bound)<<hitters[i].key;
+	}
+	// every key more frequent than the bound is in the table
+	for (map<string, long long>::iterator key = exact.begin(); key != exact.end(); key++){
+		long long count, error;
+		if (key->second > bound){
+			EXPECT_EQ(1, testedObject->estimate(key->first, count, error))<<key->first;
+		}
+	}
+}
+
+TEST_F(HeavyHittersTest, TopTenMatchesExactCounts){
+	vector< pair<long long, string> > ranked;
+	for (map<string, long long>::iterator key = exact.begin(); key != exact.end(); key++){
+		ranked.push_back(make_pair(-key->second, key->first));
+	}
+	sort(ranked.begin(), ranked.end());
+	vector<HeavyHitter> hitters;
+	ASSERT_EQ(10, testedObject->top(10, hitters));
+	for (int i = 0; i < 10; i++){
+		EXPECT_EQ(ranked[i].second, hitters[i].key)<<"Rank "<<i;
+		EXPECT_LE(hitters[i].count - (-ranked[i].first), STREAM / CAPACITY);
+		if (i > 0){
+			EXPECT_GE(hitters[i - 1].count, hitters[i].count);
+		}
+	}
+}
@@ -0,0 +1,102 @@
+#include "gtest/gtest.h"
+#include "ImportCheckpoint.h"
+#include "dex/gdb/Objects.h"
+#include <cstdio>
+
+
+class ImportCheckpointTest: public testing::Test {
+protected:
+	static const char * PATH;
+
+	ImportCheckpoint* testedObject;
+
+	ImportCheckpointTest(){
+		testedObject = NULL;
+	}
+
+	virtual void SetUp() {
+		testedObject = new ImportCheckpoint(PATH);
+		testedObject->clear();
+	}
+
+	virtual void TearDown() {
+		testedObject->clear();
+		delete testedObject;
+	}
+};
+
+const char * ImportCheckpointTest::PATH = "importCheckpointTest.ckpt";
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(ImportCheckpointTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(ImportCheckpointTest, NothingSavedLoadsNothing){
+	EXPECT_EQ(0, testedObject->load());
+	EXPECT_EQ(importMembers, testedObject->getPhase());
+	EXPECT_EQ(0, testedObject->getBatch());
+}
+
+TEST_F(ImportCheckpointTest, LoadsTheLatestSave){
+	testedObject->advance(importMembers, 100, 4);
+	testedObject->mapId(1, 1001);
+	testedObject->setCounts(4, 0);
+	ASSERT_EQ(1, testedObject->save());
+	testedObject->advance(importRelations, 0, 0);
+	testedObject->mapId(2, 1002);
+	testedObject->setCounts(7, 1);
+	ASSERT_EQ(1, testedObject->save());
+	// ids mapped after the last save are not part of it
+	testedObject->mapId(3, 1003);
+
+	ImportCheckpoint loaded(PATH);
+	ASSERT_EQ(1, loaded.load());
+	EXPECT_EQ(importRelations, loaded.getPhase());
+	EXPECT_EQ(2, loaded.getBatch());
+	EXPECT_EQ(7, loaded.getImported());
+	EXPECT_EQ(1, loaded.getRejected());
+	EXPECT_EQ(1001, loaded.findId(1));
+	EXPECT_EQ(1002, loaded.findId(2));
+	EXPECT_EQ(dex::gdb::Objects::InvalidOID, loaded.findId(3));
+}
+
+TEST_F(ImportCheckpointTest, DamagedSlotFallsBack){
+	testedObject->advance(importMembers, 100, 4);
+	ASSERT_EQ(1, testedObject->save());
+	testedObject->advance(importMembers, 200, 8);
+	ASSERT_EQ(1, testedObject->save());
+	// batch 2 went to slot .0
+	FILE *slot = fopen((string(PATH) + ".0").c_str(), "r+b");
+	ASSERT_TRUE(slot != NULL);
+	fseek(slot, 8, SEEK_SET);
+	fputc('9', slot);
+	fclose(slot);
+
+	ImportCheckpoint loaded(PATH);
+	ASSERT_EQ(1, loaded.load());
+	EXPECT_EQ(1, loaded.getBatch());
+	EXPECT_EQ(100, loaded.getOffset());
+	EXPECT_EQ(4, loaded.getRow());
+}
+
+TEST_F(ImportCheckpointTest, DiscardForgetsUnsavedIds){
+	testedObject->advance(importMembers, 100, 4);
+	testedObject->mapId(1, 1001);
+	ASSERT_EQ(1, testedObject->save());
+	testedObject->mapId(2, 1002);
+	ASSERT_EQ(1, testedObject->discard());
+	EXPECT_EQ(1001, testedObject->findId(1));
+	EXPECT_EQ(dex::gdb::Objects::InvalidOID, testedObject->findId(2));
+	testedObject->mapId(3, 1003);
+	testedObject->advance(importMembers, 200, 8);
+	ASSERT_EQ(1, testedObject->save());
+
+	ImportCheckpoint loaded(PATH);
+	ASSERT_EQ(1, loaded.load());
+	EXPECT_EQ(1003, loaded.findId(3));
+	EXPECT_EQ(dex::gdb::Objects::InvalidOID, loaded.findId(2));
+}
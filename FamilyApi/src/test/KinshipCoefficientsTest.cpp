@@ -0,0 +1,149 @@
+#include "DexImageTest.h"
+#include "KinshipCoefficients.h"
+#include <cstdlib>
+
+
+class KinshipCoefficientsTest: public DexImageTest {
+protected:
+	static const char * IMAGE;
+	static const int MEMBERS = 200;
+
+	DexDBWrapper* testedObject;
+
+	KinshipCoefficientsTest()
+	: DexImageTest(IMAGE){
+		testedObject = NULL;
+	}
+
+	virtual void SetUp() {
+		ASSERT_NO_FATAL_FAILURE(DexImageTest::SetUp());
+		testedObject = wrapper;
+		for (int id = 1; id <= MEMBERS; id++){
+			ASSERT_EQ(1, testedObject->addMember(member(id)));
+		}
+	}
+
+	void addParents(int child, int father, int mother){
+		ASSERT_EQ(1, testedObject->addRelationTo("parent", member(father), member(child)));
+		ASSERT_EQ(1, testedObject->addRelationTo("parent", member(mother), member(child)));
+	}
+
+	double kinship(int id_1, int id_2){
+		double coefficient = -1.0;
+		EXPECT_EQ(1, testedObject->findKinship(member(id_1), member(id_2), coefficient));
+		return coefficient;
+	}
+
+	double inbreeding(int id){
+		double coefficient = -1.0;
+		EXPECT_EQ(1, testedObject->findInbreeding(member(id), coefficient));
+		return coefficient;
+	}
+};
+
+const char * KinshipCoefficientsTest::IMAGE = "kinshipCoefficientsTest.dex";
+const int KinshipCoefficientsTest::MEMBERS;
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(KinshipCoefficientsTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(KinshipCoefficientsTest, FoundersAreUnrelated){
+	EXPECT_DOUBLE_EQ(0.0, kinship(1, 2));
+	EXPECT_DOUBLE_EQ(0.5, kinship(1, 1));
+	EXPECT_DOUBLE_EQ(0.0, inbreeding(1));
+}
+
+TEST_F(KinshipCoefficientsTest, ParentsAndSiblings){
+	addParents(3, 1, 2);
+	addParents(4, 1, 2);
+	EXPECT_DOUBLE_EQ(0.25, kinship(1, 3));
+	EXPECT_DOUBLE_EQ(0.25, kinship(3, 4));
+	EXPECT_DOUBLE_EQ(0.0, inbreeding(3));
+}
+
+TEST_F(KinshipCoefficientsTest, ChildOfSiblingsIsInbred){
+	addParents(3, 1, 2);
+	addParents(4, 1, 2);
+	addParents(5, 3, 4);
+	EXPECT_DOUBLE_EQ(0.25, inbreeding(5));
+	EXPECT_DOUBLE_EQ(0.625, kinship(5, 5));
+	EXPECT_DOUBLE_EQ(0.375, kinship(5, 3));
+}
+
+TEST_F(KinshipCoefficientsTest, ChildOfCousinsIsInbred){
+	addParents(3, 1, 2);
+	addParents(4, 1, 2);
+	addParents(7, 3, 5);
+	addParents(8, 4, 6);
+	addParents(9, 7, 8);
+	EXPECT_DOUBLE_EQ(0.0625, inbreeding(9));
+	EXPECT_DOUBLE_EQ(0.0, inbreeding(7));
+}
+
+TEST_F(KinshipCoefficientsTest, NewParentClearsMemo){
+	addParents(3, 1, 2);
+	EXPECT_DOUBLE_EQ(0.0, kinship(3, 4));
+	ASSERT_EQ(1, testedObject->addRelationTo("parent", member(1), member(4)));
+	EXPECT_DOUBLE_EQ(0.125, kinship(3, 4));
+	ASSERT_EQ(1, testedObject->delRelationTo("parent", member(1), member(4)));
+	EXPECT_DOUBLE_EQ(0.0, kinship(3, 4));
+}
+
+TEST_F(KinshipCoefficientsTest, MatrixMatchesTabularMethod){
+	// random pedigree where parents always have lower ids, so the tabular
+	// method can fill the reference row by row in id order
+	srand(33);
+	vector<int> father(MEMBERS + 1, 0), mother(MEMBERS + 1, 0);
+	for (int id = 11; id <= MEMBERS; id++){
+		if (rand() % 5 == 0){
+			continue;
+		}
+		father[id] = rand() % (id - 1) + 1;
+		ASSERT_EQ(1, testedObject->addRelationTo("parent", member(father[id]), member(id)));
+		if (rand() % 4 != 0){
+			do{
+				mother[id] = rand() % (id - 1) + 1;
+			}while (mother[id] == father[id]);
+			ASSERT_EQ(1, testedObject->addRelationTo("parent", member(mother[id]), member(id)));
+		}
+	}
+	vector< vector<double> > reference(MEMBERS + 1, vector<double>(MEMBERS + 1, 0.0));
+	for (int i = 1; i <= MEMBERS; i++){
+		for (int j = 1; j < i; j++){
+			double value = 0.0;
+			if (father[i]){
+				value += reference[father[i]][j] / 2.0;
+			}
+			if (mother[i]){
+				value += reference[mother[i]][j] / 2.0;
+			}
+			reference[i][j] = reference[j][i] = value;
+		}
+		reference[i][i] = (1.0 + ((father[i] && mother[i]) ? reference[father[i]][mother[i]] : 0.0)) / 2.0;
+	}
+
+	DexSchema &schema = testedObject->getSchema();
+	vector<dex::gdb::oid_t> oids;
+	for (int id = 1; id <= MEMBERS; id++){
+		oids.push_back(schema.findMember(testedObject->getGraph(), id));
+	}
+	KinshipCoefficients &coefficients = testedObject->getKinship();
+	for (int threads = 1; threads <= 4; threads += 3){
+		coefficients.setThreads(threads);
+		vector<double> matrix;
+		ASSERT_EQ(1, coefficients.kinshipMatrix(oids, matrix));
+		for (int i = 0; i < MEMBERS; i++){
+			for (int j = 0; j < MEMBERS; j++){
+				ASSERT_NEAR(reference[i + 1][j + 1], matrix[i * MEMBERS + j], 1e-12)<<"Members "<<i + 1<<" and "<<j + 1<<", "<<threads<<" threads";
+			}
+		}
+	}
+	for (int id = 1; id <= MEMBERS; id += 13){
+		EXPECT_NEAR(reference[id][id] * 2.0 - 1.0, inbreeding(id), 1e-12)<<"Member "<<id;
+	}
+}
@@ -0,0 +1,98 @@
+#include "DexImageTest.h"
+#include "MemberCursor.h"
+#include <algorithm>
+
+
+class MemberCursorTest: public DexImageTest {
+protected:
+	static const char * IMAGE;
+	static const int CHILDREN = 1000;
+
+	MemberCursor* testedObject;
+
+	MemberCursorTest()
+	: DexImageTest(IMAGE){
+		testedObject = NULL;
+	}
+
+	virtual void SetUp() {
+		testedObject = new MemberCursor();
+		ASSERT_NO_FATAL_FAILURE(DexImageTest::SetUp());
+		ASSERT_EQ(1, wrapper->addMember(member(1, "parent")));
+		for (int id = 2; id <= CHILDREN + 1; id++){
+			ASSERT_EQ(1, wrapper->addMember(member(id, (id % 2 == 0) ? "even" : "odd")));
+			ASSERT_EQ(1, wrapper->addRelationTo("parent", member(1, "parent"), member(id, "")));
+		}
+	}
+
+	virtual void TearDown() {
+		delete testedObject;
+		DexImageTest::TearDown();
+	}
+
+	MemberClass member(int id, string name){
+		MemberClass data;
+		data.setId(id);
+		data.setName(name);
+		data.setSurname("surname");
+		return data;
+	}
+};
+
+const char * MemberCursorTest::IMAGE = "memberCursorTest.dex";
+const int MemberCursorTest::CHILDREN;
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(MemberCursorTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+	EXPECT_FALSE(testedObject->isOpen());
+	vector<dex::gdb::oid_t> page;
+	EXPECT_EQ(-1, testedObject->next(10, page));
+}
+
+TEST_F(MemberCursorTest, PagesCoverTheResultOnce){
+	ASSERT_EQ(CHILDREN, wrapper->openChildren(member(1, ""), *testedObject));
+	vector<dex::gdb::oid_t> all;
+	vector<dex::gdb::oid_t> page;
+	while (testedObject->next(300, page) > 0){
+		EXPECT_TRUE(page.size() <= 300u);
+		all.insert(all.end(), page.begin(), page.end());
+	}
+	ASSERT_EQ(static_cast<size_t>(CHILDREN), all.size());
+	sort(all.begin(), all.end());
+	EXPECT_TRUE(adjacent_find(all.begin(), all.end()) == all.end());
+}
+
+TEST_F(MemberCursorTest, SeekByOffsetAndKey){
+	ASSERT_EQ(CHILDREN, wrapper->openChildren(member(1, ""), *testedObject));
+	vector<dex::gdb::oid_t> first;
+	ASSERT_EQ(CHILDREN, testedObject->next(CHILDREN, first));
+
+	vector<dex::gdb::oid_t> page;
+	ASSERT_EQ(1, testedObject->seek(950));
+	ASSERT_EQ(50, testedObject->next(100, page));
+	EXPECT_TRUE(equal(page.begin(), page.end(), first.begin() + 950));
+	EXPECT_EQ(0, testedObject->seek(CHILDREN));
+
+	// keyset: resume after the last member of the previous page
+	ASSERT_EQ(1, testedObject->seekAfter(first[499]));
+	ASSERT_EQ(10, testedObject->next(10, page));
+	EXPECT_TRUE(equal(page.begin(), page.end(), first.begin() + 500));
+	EXPECT_EQ(first[509], testedObject->getLast());
+	EXPECT_EQ(0, testedObject->seekAfter(wrapper->getSchema().findMember(wrapper->getGraph(), 1)));
+}
+
+TEST_F(MemberCursorTest, MembersAreReadPerPage){
+	ASSERT_EQ(CHILDREN / 2, wrapper->openByName(member(0, "odd"), *testedObject));
+	vector<MemberClass> page;
+	ASSERT_EQ(20, testedObject->next(20, page));
+	for (size_t i = 0; i < page.size(); i++){
+		EXPECT_EQ(1u, page[i].getId() % 2);
+		EXPECT_EQ("odd", page[i].getName());
+	}
+	EXPECT_EQ(-1, wrapper->openChildren(member(CHILDREN + 2, ""), *testedObject));
+	EXPECT_FALSE(testedObject->isOpen());
+}
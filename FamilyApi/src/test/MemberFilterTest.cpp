@@ -0,0 +1,81 @@
+#include "DexImageTest.h"
+#include "MemberFilter.h"
+
+
+class MemberFilterTest: public DexImageTest {
+protected:
+	static const char * IMAGE;
+
+	MemberFilter* testedObject;
+
+	MemberFilterTest()
+	: DexImageTest(IMAGE){
+		testedObject = NULL;
+	}
+
+	virtual void SetUp() {
+		ASSERT_NO_FATAL_FAILURE(DexImageTest::SetUp());
+		for (unsigned int id = 1; id <= 100; id++){
+			ASSERT_EQ(1, wrapper->addMember(member(id * 7)));
+		}
+		testedObject = &wrapper->getMemberIds();
+	}
+};
+
+const char * MemberFilterTest::IMAGE = "memberFilterTest.dex";
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(MemberFilterTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(MemberFilterTest, StoredIdsAreNeverMissed){
+	for (unsigned int id = 1; id <= 100; id++){
+		EXPECT_EQ(1, testedObject->mayContain(id * 7));
+		EXPECT_EQ(1, wrapper->findMember(member(id * 7)));
+	}
+	EXPECT_EQ(100, testedObject->size());
+}
+
+TEST_F(MemberFilterTest, MissingIdsAreMostlyRejected){
+	int passed = 0;
+	for (unsigned int id = 100000; id < 110000; id++){
+		passed += testedObject->mayContain(id);
+		EXPECT_EQ(0, wrapper->findMember(member(id)));
+	}
+	EXPECT_LT(passed, 10);
+}
+
+TEST_F(MemberFilterTest, FollowsAddAndDelete){
+	EXPECT_EQ(1, testedObject->mayContain(7));
+	EXPECT_EQ(0, wrapper->findMember(member(5)));
+	ASSERT_EQ(1, wrapper->addMember(member(5)));
+	EXPECT_EQ(1, testedObject->mayContain(5));
+	EXPECT_EQ(1, wrapper->findMember(member(5)));
+	EXPECT_EQ(-1, wrapper->addMember(member(5)));
+	ASSERT_EQ(1, wrapper->delMember(member(7)));
+	EXPECT_EQ(0, wrapper->findMember(member(7)));
+	EXPECT_EQ(100, testedObject->size());
+}
+
+TEST_F(MemberFilterTest, GrowsPastItsFirstSize){
+	EXPECT_EQ(1, testedObject->mayContain(7));
+	for (unsigned int id = 1000; id < 4000; id++){
+		ASSERT_EQ(1, wrapper->addMember(member(id)));
+	}
+	for (unsigned int id = 1000; id < 4000; id++){
+		EXPECT_EQ(1, wrapper->findMember(member(id)));
+	}
+	EXPECT_EQ(3100, testedObject->size());
+}
+
+TEST_F(MemberFilterTest, ResetRebuilds){
+	EXPECT_EQ(1, testedObject->mayContain(7));
+	wrapper->resetIndexes();
+	EXPECT_FALSE(testedObject->isBuilt());
+	EXPECT_EQ(1, testedObject->mayContain(700));
+	EXPECT_TRUE(testedObject->isBuilt());
+}
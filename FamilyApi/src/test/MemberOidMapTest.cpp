@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+#include "MemberOidMap.h"
+#include "dex/gdb/Objects.h"
+#include <cstdlib>
+#include <map>
+
+
+class MemberOidMapTest: public testing::Test {
+protected:
+	MemberOidMap* testedObject;
+
+	MemberOidMapTest(){
+		testedObject = NULL;
+	}
+
+	virtual void SetUp() {
+		testedObject = new MemberOidMap();
+	}
+
+	virtual void TearDown() {
+		delete testedObject;
+	}
+};
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(MemberOidMapTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(MemberOidMapTest, FindsWhatWasPut){
+	EXPECT_EQ(dex::gdb::Objects::InvalidOID, testedObject->find(1));
+	testedObject->put(1, 1001);
+	testedObject->put(2, 1002);
+	testedObject->put(0, 1000);
+	EXPECT_EQ(1001, testedObject->find(1));
+	EXPECT_EQ(1002, testedObject->find(2));
+	EXPECT_EQ(1000, testedObject->find(0));
+	EXPECT_EQ(dex::gdb::Objects::InvalidOID, testedObject->find(3));
+	testedObject->put(1, 2001);
+	EXPECT_EQ(2001, testedObject->find(1));
+	EXPECT_EQ(3, testedObject->size());
+}
+
+TEST_F(MemberOidMapTest, InvalidOidIsNotStored){
+	testedObject->put(1, dex::gdb::Objects::InvalidOID);
+	EXPECT_EQ(0, testedObject->size());
+}
+
+TEST_F(MemberOidMapTest, EraseKeepsTheRestReachable){
+	for (unsigned int id = 0; id < 5000; id++){
+		testedObject->put(id, 10000 + id);
+	}
+	for (unsigned int id = 0; id < 5000; id += 2){
+		testedObject->erase(id);
+	}
+	testedObject->erase(99999);
+	EXPECT_EQ(2500, testedObject->size());
+	for (unsigned int id = 0; id < 5000; id++){
+		EXPECT_EQ((id % 2 == 0) ? dex::gdb::Objects::InvalidOID : static_cast<dex::gdb::oid_t>(10000 + id), testedObject->find(id));
+	}
+}
+
+TEST_F(MemberOidMapTest, MatchesStdMap){
+	map<unsigned int, dex::gdb::oid_t> exact;
+	srand(49);
+	for (int i = 0; i < 200000; i++){
+		unsigned int id = static_cast<unsigned int>(rand() % 20000);
+		int operation = rand() % 10;
+		if (operation < 5){
+			dex::gdb::oid_t oid = 1 + rand();
+			testedObject->put(id, oid);
+			exact[id] = oid;
+		}else if (operation < 7){
+			testedObject->erase(id);
+			exact.erase(id);
+		}else{
+			map<unsigned int, dex::gdb::oid_t>::iterator found = exact.find(id);
+			ASSERT_EQ((found == exact.end()) ? dex::gdb::Objects::InvalidOID : found->second, testedObject->find(id));
+		}
+	}
+	EXPECT_EQ(static_cast<int>(exact.size()), testedObject->size());
+}
+
+TEST_F(MemberOidMapTest, ClearEmpties){
+	testedObject->put(7, 77);
+	testedObject->clear();
+	EXPECT_EQ(0, testedObject->size());
+	EXPECT_EQ(dex::gdb::Objects::InvalidOID, testedObject->find(7));
+	testedObject->put(7, 78);
+	EXPECT_EQ(78, testedObject->find(7));
+}
@@ -0,0 +1,121 @@
+#include "DexImageTest.h"
+#include "MemberQuery.h"
+#include <cstdio>
+#include <cstdlib>
+
+
+class MemberQueryTest: public DexImageTest {
+protected:
+	static const char * IMAGE;
+	static const int MEMBERS = 2000;
+
+	MemberQuery* testedObject;
+	vector<MemberClass> members;
+
+	MemberQueryTest()
+	: DexImageTest(IMAGE){
+		testedObject = NULL;
+	}
+
+	// 40 surnames, births 1700-1899, both sexes, one in ten without a birth
+	virtual void SetUp() {
+		ASSERT_NO_FATAL_FAILURE(DexImageTest::SetUp());
+		srand(43);
+		for (int id = 1; id <= MEMBERS; id++){
+			MemberClass data;
+			data.setId(id);
+			data.setName("name");
+			char surname[16];
+			sprintf(surname, "Surname%d", rand() % 40);
+			data.setSurname(surname);
+			data.setSex((rand() % 2 == 0) ? male : female);
+			if (rand() % 10 != 0){
+				DateClass birth;
+				tm date = {};
+				date.tm_year = 1700 + rand() % 200;
+				date.tm_mday = 1;
+				string cause;
+				ASSERT_EQ(1, birth.setDate(date, cause));
+				data.setBirthDate(birth);
+			}
+			ASSERT_EQ(1, wrapper->addMember(data));
+			members.push_back(data);
+		}
+		testedObject = new MemberQuery(*wrapper);
+	}
+
+	virtual void TearDown() {
+		delete testedObject;
+		DexImageTest::TearDown();
+	}
+
+	int expected(string surname, int firstYear, int lastYear, Sex sex){
+		int count = 0;
+		for (size_t i = 0; i < members.size(); i++){
+			int year = members[i].getBirthDate().getYear();
+			if (((surname.empty())||(members[i].getSurname() == surname))
+				&&((firstYear == 0)||((year >= firstYear)&&(year <= lastYear)))
+				&&((sex == nn)||(members[i].getSex() == sex))){
+				count++;
+			}
+		}
+		return count;
+	}
+};
+
+const char * MemberQueryTest::IMAGE = "memberQueryTest.dex";
+const int MemberQueryTest::MEMBERS;
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(MemberQueryTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+	EXPECT_EQ("no conditions\n", testedObject->explain());
+	EXPECT_EQ(-1, testedObject->count());
+}
+
+TEST_F(MemberQueryTest, SameResultAsAScan){
+	ASSERT_EQ(1, testedObject->whereSex(male));
+	ASSERT_EQ(1, testedObject->whereBornBetween(1800, 1850));
+	ASSERT_EQ(1, testedObject->whereSurname("Surname7"));
+	EXPECT_EQ(expected("Surname7", 1800, 1850, male), testedObject->count());
+
+	testedObject->clear();
+	ASSERT_EQ(1, testedObject->whereBornBetween(1750, 1760));
+	ASSERT_EQ(1, testedObject->whereSex(female));
+	MemberCursor cursor;
+	EXPECT_EQ(expected("", 1750, 1760, female), testedObject->open(cursor));
+	vector<MemberClass> page;
+	ASSERT_TRUE(testedObject->open(cursor) > 0);
+	ASSERT_TRUE(cursor.next(10, page) > 0);
+	EXPECT_EQ(female, page[0].getSex());
+	EXPECT_EQ(-1, testedObject->whereBornBetween(1900, 1800));
+}
+
+TEST_F(MemberQueryTest, MostSelectiveFirst){
+	ASSERT_EQ(1, testedObject->whereSex(male));
+	ASSERT_EQ(1, testedObject->whereBornBetween(1700, 1899));
+	ASSERT_EQ(1, testedObject->whereSurname("Surname3"));
+	string plan = testedObject->explain();
+	// surname (about 50 rows) is selected, the rest checked on what is left
+	EXPECT_EQ(0u, plan.find("select    surname = Surname3"))<<plan;
+	EXPECT_NE(string::npos, plan.find("check     sex = male"))<<plan;
+	EXPECT_NE(string::npos, plan.find("check     birth 1700..1899"))<<plan;
+	EXPECT_EQ(string::npos, plan.find("actual"))<<plan;
+
+	EXPECT_EQ(expected("Surname3", 1700, 1899, male), testedObject->count());
+	EXPECT_NE(string::npos, testedObject->explain().find("actual"));
+}
+
+TEST_F(MemberQueryTest, IntersectsWhenBothSidesAreLarge){
+	// about 900 births against 1000 women: checking the births would cost
+	// more than selecting the women from the index
+	ASSERT_EQ(1, testedObject->whereSex(female));
+	ASSERT_EQ(1, testedObject->whereBornBetween(1700, 1799));
+	string plan = testedObject->explain();
+	EXPECT_EQ(0u, plan.find("select    birth 1700..1799"))<<plan;
+	EXPECT_NE(string::npos, plan.find("intersect sex = female"))<<plan;
+	EXPECT_EQ(expected("", 1700, 1799, female), testedObject->count());
+}
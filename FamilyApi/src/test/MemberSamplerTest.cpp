@@ -0,0 +1,115 @@
+#include "DexImageTest.h"
+#include "MemberSampler.h"
+
+
+class MemberSamplerTest: public DexImageTest {
+protected:
+	static const char * IMAGE;
+
+	MemberSampler* testedObject;
+
+	MemberSamplerTest()
+	: DexImageTest(IMAGE){
+		testedObject = NULL;
+	}
+
+	// 1 -> 2 -> 3 -> 4 -> 5 -> 6, 7 to 12 unrelated, all of the same name
+	virtual void SetUp() {
+		ASSERT_NO_FATAL_FAILURE(DexImageTest::SetUp());
+		for (int id = 1; id <= 12; id++){
+			ASSERT_EQ(1, wrapper->addMember(member(id)));
+		}
+		for (int id = 1; id < 6; id++){
+			ASSERT_EQ(1, wrapper->addRelationTo("parent", member(id), member(id + 1)));
+		}
+		testedObject = new MemberSampler(*wrapper);
+	}
+
+	virtual void TearDown() {
+		delete testedObject;
+		DexImageTest::TearDown();
+	}
+};
+
+const char * MemberSamplerTest::IMAGE = "memberSamplerTest.dex";
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(MemberSamplerTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(MemberSamplerTest, ByNameCountsExactly){
+	SampleEstimate total;
+	vector<MemberClass> found;
+	EXPECT_EQ(3, testedObject->sampleByName(member(1), 3, total, found));
+	EXPECT_TRUE(total.exact);
+	EXPECT_EQ(12.0, total.estimate);
+	EXPECT_EQ(3u, found.size());
+	EXPECT_EQ("surname", found[0].getSurname());
+}
+
+TEST_F(MemberSamplerTest, FullSampleIsExact){
+	SampleEstimate total;
+	vector<MemberClass> found;
+	EXPECT_EQ(5, testedObject->sampleDescendants(member(1), 100, 10, total, found));
+	EXPECT_TRUE(total.exact);
+	EXPECT_EQ(5.0, total.estimate);
+	EXPECT_EQ(2, testedObject->sampleAncestors(member(3), 100, 10, total, found));
+	EXPECT_TRUE(total.exact);
+	EXPECT_EQ(2.0, total.low);
+	EXPECT_EQ(2.0, total.high);
+}
+
+TEST_F(MemberSamplerTest, PartialSampleBoundsTheTotal){
+	// the line is longer than the walk may go, so it is only sampled
+	testedObject->setWalkLimit(2);
+	SampleEstimate total;
+	vector<MemberClass> found;
+	ASSERT_NE(-1, testedObject->sampleDescendants(member(1), 6, 10, total, found));
+	EXPECT_FALSE(total.exact);
+	EXPECT_LE(total.low, total.estimate);
+	EXPECT_LE(total.estimate, total.high);
+	EXPECT_LE(static_cast<double>(found.size()), total.low);
+	EXPECT_LE(total.high, 11.0 - (6.0 - found.size()));
+	for (size_t i = 0; i < found.size(); i++){
+		EXPECT_GT(found[i].getId(), 1u);
+		EXPECT_LE(found[i].getId(), 6u);
+	}
+}
+
+TEST_F(MemberSamplerTest, SmallLineIsWalked){
+	// two members drawn out of eleven rarely hit the line
+	SampleEstimate total;
+	vector<MemberClass> found;
+	EXPECT_EQ(5, testedObject->sampleDescendants(member(1), 2, 10, total, found));
+	EXPECT_TRUE(total.exact);
+	EXPECT_EQ(5.0, total.estimate);
+	EXPECT_EQ(3, testedObject->sampleDescendants(member(1), 2, 3, total, found));
+	EXPECT_EQ(5.0, total.estimate);
+	for (size_t i = 0; i < found.size(); i++){
+		EXPECT_GT(found[i].getId(), 1u);
+		EXPECT_LE(found[i].getId(), 6u);
+	}
+	EXPECT_EQ(3, testedObject->sampleAncestors(member(4), 1, 10, total, found));
+	EXPECT_TRUE(total.exact);
+	EXPECT_EQ(0, testedObject->sampleAncestors(member(7), 1, 10, total, found));
+	EXPECT_EQ(0.0, total.high);
+}
+
+TEST_F(MemberSamplerTest, ExamplesAreLimited){
+	SampleEstimate total;
+	vector<MemberClass> found;
+	EXPECT_EQ(2, testedObject->sampleDescendants(member(1), 100, 2, total, found));
+	EXPECT_EQ(5.0, total.estimate);
+}
+
+TEST_F(MemberSamplerTest, UnknownMemberFails){
+	SampleEstimate total;
+	vector<MemberClass> found;
+	EXPECT_EQ(-1, testedObject->sampleDescendants(member(99), 10, 10, total, found));
+	EXPECT_EQ(-1, testedObject->sampleAncestors(member(1), 0, 10, total, found));
+	EXPECT_TRUE(found.empty());
+}
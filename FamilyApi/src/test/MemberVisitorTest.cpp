@@ -0,0 +1,106 @@
+#include "DexImageTest.h"
+#include "MemberVisitor.h"
+
+
+// counts the members it sees and stops after limit of them
+struct CountingFunctor{
+	int seen;
+	int limit;
+	unsigned int idSum;
+	int smiths;
+
+	CountingFunctor(int limit){
+		seen = 0;
+		this->limit = limit;
+		idSum = 0;
+		smiths = 0;
+	}
+
+	bool operator()(MemberView &member){
+		seen++;
+		idSum += member.getId();
+		if (member.getSurname() == L"Smith"){
+			smiths++;
+		}
+		return (limit == 0)||(seen < limit);
+	}
+};
+
+class MemberVisitorTest: public DexImageTest {
+protected:
+	static const char * IMAGE;
+
+	DexDBWrapper* testedObject;
+
+	MemberVisitorTest()
+	: DexImageTest(IMAGE){
+		testedObject = NULL;
+	}
+
+	// 1 -> 2 -> 4, 1 -> 3 -> 4, 4 -> 5; 6 alone
+	virtual void SetUp() {
+		ASSERT_NO_FATAL_FAILURE(DexImageTest::SetUp());
+		testedObject = wrapper;
+		for (int id = 1; id <= 6; id++){
+			ASSERT_EQ(1, testedObject->addMember(member(id, (id % 2 == 0) ? "Smith" : "Jones")));
+		}
+		ASSERT_EQ(1, testedObject->addRelationTo("parent", member(1, ""), member(2, "")));
+		ASSERT_EQ(1, testedObject->addRelationTo("parent", member(1, ""), member(3, "")));
+		ASSERT_EQ(1, testedObject->addRelationTo("parent", member(2, ""), member(4, "")));
+		ASSERT_EQ(1, testedObject->addRelationTo("parent", member(3, ""), member(4, "")));
+		ASSERT_EQ(1, testedObject->addRelationTo("parent", member(4, ""), member(5, "")));
+	}
+
+	MemberClass member(int id, string surname){
+		MemberClass data;
+		data.setId(id);
+		data.setName("name");
+		data.setSurname(surname);
+		return data;
+	}
+};
+
+const char * MemberVisitorTest::IMAGE = "memberVisitorTest.dex";
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(MemberVisitorTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(MemberVisitorTest, EveryMemberOnce){
+	CountingFunctor counter(0);
+	EXPECT_EQ(6, testedObject->forEachMember(counter));
+	EXPECT_EQ(6, counter.seen);
+	EXPECT_EQ(21u, counter.idSum);
+	EXPECT_EQ(3, counter.smiths);
+}
+
+TEST_F(MemberVisitorTest, DescendantsAndAncestors){
+	CountingFunctor down(0);
+	EXPECT_EQ(4, testedObject->forEachDescendant(member(1, ""), down));
+	EXPECT_EQ(14u, down.idSum);
+	CountingFunctor up(0);
+	EXPECT_EQ(4, testedObject->forEachAncestor(member(5, ""), up));
+	EXPECT_EQ(10u, up.idSum);
+	CountingFunctor none(0);
+	EXPECT_EQ(0, testedObject->forEachDescendant(member(6, ""), none));
+	EXPECT_EQ(-1, testedObject->forEachAncestor(member(7, ""), none));
+}
+
+TEST_F(MemberVisitorTest, FunctorStopsTheWalk){
+	CountingFunctor counter(2);
+	EXPECT_EQ(2, testedObject->forEachDescendant(member(1, ""), counter));
+	EXPECT_EQ(2, counter.seen);
+	CountingFunctor children(0);
+	EXPECT_EQ(2, testedObject->forEachChild(member(1, ""), children));
+}
+
+TEST_F(MemberVisitorTest, ByName){
+	CountingFunctor smiths(0);
+	EXPECT_EQ(3, testedObject->forEachByName(member(0, "Smith"), smiths));
+	EXPECT_EQ(3, smiths.smiths);
+	EXPECT_EQ(12u, smiths.idSum);
+}
@@ -0,0 +1,88 @@
+#include "DexImageTest.h"
+#include "NameSketches.h"
+
+
+class NameSketchesTest: public DexImageTest {
+protected:
+	static const char * IMAGE;
+
+	NameSketches* testedObject;
+
+	NameSketchesTest()
+	: DexImageTest(IMAGE){
+		testedObject = NULL;
+	}
+
+	// Jan and Anna by turns; three Nowak, two Lis, one Kot
+	virtual void SetUp() {
+		ASSERT_NO_FATAL_FAILURE(DexImageTest::SetUp());
+		static const char *surnames[] = {"Nowak", "Nowak", "Nowak", "Lis", "Lis", "Kot"};
+		for (unsigned int id = 1; id <= 6; id++){
+			ASSERT_EQ(1, wrapper->addMember(member(id, (id % 2 == 0) ? "Anna" : "Jan", surnames[id - 1])));
+		}
+		testedObject = new NameSketches(*wrapper, 10);
+	}
+
+	virtual void TearDown() {
+		delete testedObject;
+		DexImageTest::TearDown();
+	}
+
+	MemberClass member(unsigned int id, string name, string surname){
+		MemberClass data;
+		data.setId(id);
+		data.setName(name);
+		data.setSurname(surname);
+		return data;
+	}
+};
+
+const char * NameSketchesTest::IMAGE = "nameSketchesTest.dex";
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(NameSketchesTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(NameSketchesTest, ReadsTheMembers){
+	vector<HeavyHitter> hitters;
+	ASSERT_EQ(2, testedObject->topSurnames(2, hitters));
+	EXPECT_EQ("Nowak", hitters[0].key);
+	EXPECT_EQ(3, hitters[0].count);
+	EXPECT_EQ("Lis", hitters[1].key);
+	EXPECT_EQ(6, testedObject->getNames().getTotal());
+}
+
+TEST_F(NameSketchesTest, CountsAddedMembers){
+	vector<HeavyHitter> hitters;
+	ASSERT_EQ(2, testedObject->topSurnames(2, hitters));
+	ASSERT_EQ(1, wrapper->addMember(member(7, "Anna", "Kot")));
+	ASSERT_EQ(2, testedObject->topNames(2, hitters));
+	EXPECT_EQ("Anna", hitters[0].key);
+	EXPECT_EQ(4, hitters[0].count);
+	EXPECT_EQ(7, testedObject->getSurnames().getTotal());
+}
+
+TEST_F(NameSketchesTest, DeletedMembersAreNotCounted){
+	vector<HeavyHitter> hitters;
+	ASSERT_EQ(2, testedObject->topSurnames(2, hitters));
+	ASSERT_EQ(1, wrapper->delMember(member(1, "Jan", "Nowak")));
+	ASSERT_EQ(1, wrapper->delMember(member(2, "Anna", "Nowak")));
+	ASSERT_EQ(2, testedObject->topSurnames(2, hitters));
+	EXPECT_EQ("Lis", hitters[0].key);
+	EXPECT_EQ(2, hitters[0].count);
+	EXPECT_EQ(4, testedObject->getSurnames().getTotal());
+	ASSERT_EQ(2, testedObject->topNames(2, hitters));
+	EXPECT_EQ(2, hitters[0].count);
+}
+
+TEST_F(NameSketchesTest, ResetReadsTheMembersAgain){
+	vector<HeavyHitter> hitters;
+	ASSERT_EQ(2, testedObject->topSurnames(2, hitters));
+	wrapper->resetIndexes();
+	ASSERT_EQ(2, testedObject->topSurnames(2, hitters));
+	EXPECT_EQ(6, testedObject->getSurnames().getTotal());
+}
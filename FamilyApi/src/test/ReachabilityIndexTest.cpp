@@ -0,0 +1,169 @@
+#include "DexImageTest.h"
+#include "ReachabilityIndex.h"
+#include <cstdlib>
+#include <algorithm>
+
+
+class ReachabilityIndexTest: public DexImageTest {
+protected:
+	static const char * IMAGE;
+	static const int MEMBERS = 60;
+
+	ReachabilityIndex* testedObject;
+	// parent -> children by id, what the image should hold
+	vector< vector<int> > children;
+	vector<char> alive;
+	int nextId;
+
+	ReachabilityIndexTest()
+	: DexImageTest(IMAGE){
+		testedObject = NULL;
+	}
+
+	virtual void SetUp() {
+		ASSERT_NO_FATAL_FAILURE(DexImageTest::SetUp());
+		testedObject = &wrapper->getAncestry();
+		children.assign(1, vector<int>());
+		alive.assign(1, 0);
+		nextId = 1;
+		for (int i = 0; i < MEMBERS; i++){
+			addMember();
+		}
+	}
+
+	int randomAlive(){
+		int id;
+		do{
+			id = rand() % (nextId - 1) + 1;
+		}while (!alive[id]);
+		return id;
+	}
+
+	void addMember(){
+		ASSERT_EQ(1, wrapper->addMember(member(nextId)));
+		children.push_back(vector<int>());
+		alive.push_back(1);
+		nextId++;
+	}
+
+	void deleteMember(int id){
+		ASSERT_EQ(1, wrapper->delMember(member(id)));
+		alive[id] = 0;
+		children[id].clear();
+		for (size_t parent = 0; parent < children.size(); parent++){
+			children[parent].erase(std::remove(children[parent].begin(), children[parent].end(), id), children[parent].end());
+		}
+	}
+
+	void addEdge(int parent, int child){
+		if ((parent == child)||(find(children[parent].begin(), children[parent].end(), child) != children[parent].end())){
+			return;
+		}
+		if (wrapper->addRelationTo("parent", member(parent), member(child)) == 1){
+			children[parent].push_back(child);
+		}
+	}
+
+	void deleteEdge(int parent){
+		if (children[parent].empty()){
+			return;
+		}
+		int child = children[parent][rand() % children[parent].size()];
+		ASSERT_EQ(1, wrapper->delRelationTo("parent", member(parent), member(child)));
+		children[parent].erase(find(children[parent].begin(), children[parent].end(), child));
+	}
+
+	// descendants of every member by a DFS over the expected edges
+	vector< vector<char> > descendants(){
+		vector< vector<char> > below(children.size(), vector<char>(children.size(), 0));
+		for (size_t from = 1; from < children.size(); from++){
+			if (!alive[from]){
+				continue;
+			}
+			vector<int> stack(children[from].begin(), children[from].end());
+			while (!stack.empty()){
+				int id = stack.back();
+				stack.pop_back();
+				if (!below[from][id]){
+					below[from][id] = 1;
+					stack.insert(stack.end(), children[id].begin(), children[id].end());
+				}
+			}
+		}
+		return below;
+	}
+
+	// the kept index, and one built from scratch, agree with the DFS
+	void expectSameAsDfs(const char *after){
+		vector< vector<char> > below = descendants();
+		ReachabilityIndex fresh(wrapper->getParentDag());
+		ASSERT_EQ(1, fresh.build());
+		vector<dex::gdb::oid_t> oids(children.size(), dex::gdb::Objects::InvalidOID);
+		for (size_t id = 1; id < children.size(); id++){
+			oids[id] = alive[id] ? wrapper->oidOf(id) : dex::gdb::Objects::InvalidOID;
+		}
+		for (size_t a = 1; a < children.size(); a++){
+			if (!alive[a]){
+				continue;
+			}
+			for (size_t b = 1; b < children.size(); b++){
+				if (!alive[b]){
+					continue;
+				}
+				int expected = below[a][b] ? 1 : 0;
+				ASSERT_EQ(expected, testedObject->isAncestor(oids[a], oids[b]))<<a<<" above "<<b<<" after "<<after;
+				ASSERT_EQ(expected, fresh.isAncestor(oids[a], oids[b]))<<a<<" above "<<b<<" after a fresh build";
+			}
+		}
+	}
+};
+
+const char * ReachabilityIndexTest::IMAGE = "reachabilityIndexTest.dex";
+const int ReachabilityIndexTest::MEMBERS;
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(ReachabilityIndexTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(ReachabilityIndexTest, LineageIsReachable){
+	for (int id = 1; id < 10; id++){
+		addEdge(id, id + 1);
+	}
+	expectSameAsDfs("a chain");
+	// a second parent outside the spanning tree, then its removal
+	addEdge(20, 5);
+	addEdge(21, 20);
+	expectSameAsDfs("a second parent");
+	deleteEdge(20);
+	expectSameAsDfs("the second parent removed");
+}
+
+TEST_F(ReachabilityIndexTest, RandomEditsMatchDfs){
+	srand(28);
+	// build the index once so the edits below take the incremental paths
+	for (int i = 0; i < 80; i++){
+		addEdge(randomAlive(), randomAlive());
+	}
+	expectSameAsDfs("the first edges");
+	for (int step = 0; step < 300; step++){
+		int kind = rand() % 10;
+		if (kind < 5){
+			addEdge(randomAlive(), randomAlive());
+			expectSameAsDfs("relationAdded");
+		}else if (kind < 8){
+			deleteEdge(randomAlive());
+			expectSameAsDfs("relationDeleted");
+		}else if (kind == 8){
+			deleteMember(randomAlive());
+			expectSameAsDfs("memberDeleted");
+		}else{
+			addMember();
+			addEdge(randomAlive(), nextId - 1);
+			expectSameAsDfs("memberAdded");
+		}
+	}
+}
@@ -0,0 +1,143 @@
+#include "DexImageTest.h"
+#include "RelationshipPaths.h"
+
+
+class RelationshipPathsTest: public DexImageTest {
+protected:
+	static const char * IMAGE;
+	static const int MEMBERS = 20;
+
+	// keeps what it gets, stops after limit paths when limit is set
+	class Collector : public RelationshipPathSink {
+	public:
+		vector<RelationshipPath> paths;
+		size_t limit;
+
+		Collector(){
+			limit = 0;
+		}
+
+		bool pathFound(const RelationshipPath &path){
+			paths.push_back(path);
+			return (limit == 0)||(paths.size() < limit);
+		}
+	};
+
+	RelationshipPaths* testedObject;
+	Collector collector;
+
+	RelationshipPathsTest()
+	: DexImageTest(IMAGE){
+		testedObject = NULL;
+	}
+
+	virtual void SetUp() {
+		ASSERT_NO_FATAL_FAILURE(DexImageTest::SetUp());
+		for (int id = 1; id <= MEMBERS; id++){
+			ASSERT_EQ(1, wrapper->addMember(member(id)));
+		}
+		testedObject = new RelationshipPaths(*wrapper);
+	}
+
+	virtual void TearDown() {
+		delete testedObject;
+		DexImageTest::TearDown();
+	}
+
+	void addParents(int child, int father, int mother){
+		ASSERT_EQ(1, wrapper->addRelationTo("parent", member(father), member(child)));
+		if (mother){
+			ASSERT_EQ(1, wrapper->addRelationTo("parent", member(mother), member(child)));
+		}
+	}
+
+	dex::gdb::oid_t oid(int id){
+		return wrapper->getSchema().findMember(wrapper->getGraph(), id);
+	}
+};
+
+const char * RelationshipPathsTest::IMAGE = "relationshipPathsTest.dex";
+const int RelationshipPathsTest::MEMBERS;
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(RelationshipPathsTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(RelationshipPathsTest, StrangersHaveNoPath){
+	EXPECT_EQ(0, testedObject->enumerate(member(1), member(2), collector));
+	EXPECT_TRUE(testedObject->isComplete());
+}
+
+TEST_F(RelationshipPathsTest, ParentIsOwnApex){
+	addParents(3, 1, 2);
+	ASSERT_EQ(1, testedObject->enumerate(member(3), member(1), collector));
+	const RelationshipPath &path = collector.paths[0];
+	EXPECT_EQ(1, path.up);
+	EXPECT_EQ(0, path.down);
+	ASSERT_EQ((unsigned int)2, path.members.size());
+	EXPECT_EQ(oid(3), path.members[0]);
+	EXPECT_EQ(oid(1), path.apexes[0]);
+}
+
+TEST_F(RelationshipPathsTest, FullSiblingsOncePerCouple){
+	addParents(3, 1, 2);
+	addParents(4, 1, 2);
+	addParents(5, 1, 6);
+	ASSERT_EQ(1, testedObject->enumerate(member(3), member(4), collector));
+	EXPECT_EQ((unsigned int)2, collector.paths[0].apexes.size());
+	EXPECT_EQ((unsigned int)3, collector.paths[0].members.size());
+
+	collector.paths.clear();
+	ASSERT_EQ(1, testedObject->enumerate(member(3), member(5), collector));
+	ASSERT_EQ((unsigned int)1, collector.paths[0].apexes.size());
+	EXPECT_EQ(oid(1), collector.paths[0].apexes[0]);
+}
+
+TEST_F(RelationshipPathsTest, DoubleCousinsTwoWays){
+	// 3,4 and 5,6 are sibling pairs, 3 marries 5 and 4 marries 6
+	addParents(3, 1, 2);
+	addParents(4, 1, 2);
+	addParents(5, 7, 8);
+	addParents(6, 7, 8);
+	addParents(9, 3, 5);
+	addParents(10, 4, 6);
+	ASSERT_EQ(2, testedObject->enumerate(member(9), member(10), collector));
+	for (size_t i = 0; i < collector.paths.size(); i++){
+		EXPECT_EQ(2, collector.paths[i].up);
+		EXPECT_EQ(2, collector.paths[i].down);
+	}
+	// the grandparents are not reached through the parents again
+	collector.paths.clear();
+	ASSERT_EQ(1, testedObject->enumerate(member(9), member(1), collector));
+	EXPECT_EQ(2, collector.paths[0].up);
+}
+
+TEST_F(RelationshipPathsTest, LengthLimitAndCap){
+	addParents(3, 1, 2);
+	addParents(4, 1, 2);
+	addParents(5, 3, 0);
+	addParents(6, 4, 0);
+	testedObject->setMaxLength(3);
+	EXPECT_EQ(0, testedObject->enumerate(member(5), member(6), collector));
+	testedObject->setMaxLength(4);
+	EXPECT_EQ(1, testedObject->enumerate(member(5), member(6), collector));
+
+	addParents(7, 5, 6);
+	collector.paths.clear();
+	testedObject->setMaxLength(12);
+	EXPECT_EQ(2, testedObject->enumerate(member(7), member(1), collector));
+	EXPECT_TRUE(testedObject->isComplete());
+	testedObject->setMaxResults(1);
+	EXPECT_EQ(1, testedObject->enumerate(member(7), member(1), collector));
+	EXPECT_FALSE(testedObject->isComplete());
+
+	testedObject->setMaxResults(0);
+	collector.paths.clear();
+	collector.limit = 1;
+	EXPECT_EQ(1, testedObject->enumerate(member(7), member(1), collector));
+	EXPECT_FALSE(testedObject->isComplete());
+}
@@ -0,0 +1,99 @@
+#include "DexImageTest.h"
+#include "SurnameIndex.h"
+
+
+class SurnameIndexTest: public DexImageTest {
+protected:
+	static const char * IMAGE;
+
+	SurnameIndex* testedObject;
+
+	SurnameIndexTest()
+	: DexImageTest(IMAGE){
+		testedObject = NULL;
+	}
+
+	// Kaminski x1, Kowalski x3, Kowalczyk x2, Lis x1, Nowak x2, Zielinski x1
+	virtual void SetUp() {
+		ASSERT_NO_FATAL_FAILURE(DexImageTest::SetUp());
+		static const char *surnames[] = {"Nowak", "Kowalski", "Lis", "Kowalski", "Zielinski",
+		                                 "Kowalczyk", "Kaminski", "Nowak", "Kowalski", "Kowalczyk"};
+		for (int id = 1; id <= 10; id++){
+			ASSERT_EQ(1, wrapper->addMember(member(id, surnames[id - 1])));
+		}
+		testedObject = new SurnameIndex(*wrapper);
+	}
+
+	virtual void TearDown() {
+		delete testedObject;
+		DexImageTest::TearDown();
+	}
+
+	MemberClass member(int id, string surname){
+		MemberClass data;
+		data.setId(id);
+		data.setName("name");
+		data.setSurname(surname);
+		return data;
+	}
+};
+
+const char * SurnameIndexTest::IMAGE = "surnameIndexTest.dex";
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(SurnameIndexTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+	EXPECT_EQ(6, testedObject->size());
+}
+
+TEST_F(SurnameIndexTest, SeekPrefixAndPageForward){
+	vector<SurnameCount> page;
+	ASSERT_EQ(1, testedObject->seek("K"));
+	ASSERT_EQ(2, testedObject->next(2, page));
+	EXPECT_EQ("Kaminski", page[0].surname);
+	EXPECT_EQ(1, page[0].members);
+	EXPECT_EQ("Kowalczyk", page[1].surname);
+	EXPECT_EQ(2, page[1].members);
+	ASSERT_EQ(2, testedObject->next(2, page));
+	EXPECT_EQ("Kowalski", page[0].surname);
+	EXPECT_EQ(3, page[0].members);
+	EXPECT_EQ("Lis", page[1].surname);
+	ASSERT_EQ(2, testedObject->next(5, page));
+	EXPECT_EQ("Zielinski", page[1].surname);
+	EXPECT_EQ(0, testedObject->next(5, page));
+	EXPECT_EQ(0, testedObject->seek("Ma"));
+	ASSERT_EQ(1, testedObject->next(1, page));
+	EXPECT_EQ("Nowak", page[0].surname);
+}
+
+TEST_F(SurnameIndexTest, PageBackward){
+	vector<SurnameCount> page;
+	ASSERT_EQ(1, testedObject->seek("Lis"));
+	ASSERT_EQ(2, testedObject->next(2, page));
+	EXPECT_EQ("Lis", page[0].surname);
+	ASSERT_EQ(2, testedObject->previous(2, page));
+	EXPECT_EQ("Kowalczyk", page[0].surname);
+	EXPECT_EQ("Kowalski", page[1].surname);
+	ASSERT_EQ(1, testedObject->previous(2, page));
+	EXPECT_EQ("Kaminski", page[0].surname);
+	EXPECT_EQ(0, testedObject->previous(2, page));
+}
+
+TEST_F(SurnameIndexTest, FollowsTheWrapper){
+	vector<SurnameCount> page;
+	ASSERT_EQ(6, testedObject->size());
+	ASSERT_EQ(1, wrapper->addMember(member(11, "Kot")));
+	ASSERT_EQ(1, wrapper->addMember(member(12, "Lis")));
+	ASSERT_EQ(1, wrapper->delMember(member(7, "")));
+	ASSERT_EQ(1, testedObject->seek("K"));
+	ASSERT_EQ(3, testedObject->next(3, page));
+	EXPECT_EQ("Kot", page[0].surname);
+	EXPECT_EQ("Kowalczyk", page[1].surname);
+	EXPECT_EQ("Kowalski", page[2].surname);
+	ASSERT_EQ(1, testedObject->next(1, page));
+	EXPECT_EQ("Lis", page[0].surname);
+	EXPECT_EQ(2, page[0].members);
+}
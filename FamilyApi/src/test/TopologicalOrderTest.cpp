@@ -0,0 +1,158 @@
+#include "DexImageTest.h"
+#include "TopologicalOrder.h"
+#include <cstdlib>
+
+
+class TopologicalOrderTest: public DexImageTest {
+protected:
+	static const char * IMAGE;
+	static const int MEMBERS = 200;
+
+	DexDBWrapper* testedObject;
+	// parent -> children as accepted so far, by id
+	vector< vector<int> > children;
+
+	TopologicalOrderTest()
+	: DexImageTest(IMAGE){
+		testedObject = NULL;
+	}
+
+	virtual void SetUp() {
+		ASSERT_NO_FATAL_FAILURE(DexImageTest::SetUp());
+		testedObject = wrapper;
+		for (int id = 1; id <= MEMBERS; id++){
+			ASSERT_EQ(1, testedObject->addMember(member(id)));
+		}
+		children.assign(MEMBERS + 1, vector<int>());
+	}
+
+	int positionOf(int id){
+		dex::gdb::oid_t oid = testedObject->getSchema().findMember(testedObject->getGraph(), id);
+		return testedObject->getOrder().positionOf(testedObject->getParentDag().indexOf(oid));
+	}
+
+	// plain DFS over the accepted edges
+	bool reaches(int from, int to){
+		vector<char> seen(MEMBERS + 1, 0);
+		vector<int> stack(1, from);
+		seen[from] = 1;
+		while (!stack.empty()){
+			int id = stack.back();
+			stack.pop_back();
+			if (id == to){
+				return true;
+			}
+			for (size_t i = 0; i < children[id].size(); i++){
+				if (!seen[children[id][i]]){
+					seen[children[id][i]] = 1;
+					stack.push_back(children[id][i]);
+				}
+			}
+		}
+		return false;
+	}
+
+	// accepted exactly when it closes no cycle, true if it was accepted
+	bool addParent(int parent, int child){
+		bool acyclic = (parent != child)&&(!reaches(child, parent));
+		EXPECT_EQ(acyclic ? 1 : -1, testedObject->addRelationTo("parent", member(parent), member(child)))
+			<<"Edge "<<parent<<" -> "<<child;
+		if (acyclic){
+			children[parent].push_back(child);
+		}
+		return acyclic;
+	}
+
+	// every member has its own position and every parent comes first
+	void expectOrdered(){
+		vector<char> taken(MEMBERS, 0);
+		vector<int> positions(MEMBERS + 1, -1);
+		for (int id = 1; id <= MEMBERS; id++){
+			positions[id] = positionOf(id);
+			ASSERT_TRUE((positions[id] >= 0)&&(positions[id] < MEMBERS))<<"Member "<<id<<" has no position";
+			ASSERT_EQ(0, taken[positions[id]])<<"Position "<<positions[id]<<" taken twice";
+			taken[positions[id]] = 1;
+		}
+		for (int id = 1; id <= MEMBERS; id++){
+			for (size_t i = 0; i < children[id].size(); i++){
+				ASSERT_TRUE(positions[id] < positions[children[id][i]])<<"Edge "<<id<<" -> "<<children[id][i];
+			}
+		}
+	}
+};
+
+const char * TopologicalOrderTest::IMAGE = "topologicalOrderTest.dex";
+const int TopologicalOrderTest::MEMBERS;
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(TopologicalOrderTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(TopologicalOrderTest, ChainAddedBackwardsIsReordered){
+	// members are numbered in id order, so every edge goes against it
+	for (int id = 10; id > 1; id--){
+		ASSERT_TRUE(addParent(id, id - 1));
+	}
+	expectOrdered();
+	for (int id = 10; id > 1; id--){
+		EXPECT_LT(positionOf(id), positionOf(id - 1));
+	}
+}
+
+TEST_F(TopologicalOrderTest, CycleIsRejected){
+	for (int id = 10; id > 1; id--){
+		ASSERT_TRUE(addParent(id, id - 1));
+	}
+	vector<int> before;
+	for (int id = 1; id <= MEMBERS; id++){
+		before.push_back(positionOf(id));
+	}
+	EXPECT_FALSE(addParent(1, 10));
+	EXPECT_FALSE(addParent(5, 8));
+	EXPECT_FALSE(addParent(3, 3));
+	EXPECT_EQ(0, testedObject->findChildren(member(1)));
+	// a rejected edge leaves the order as it was
+	for (int id = 1; id <= MEMBERS; id++){
+		EXPECT_EQ(before[id - 1], positionOf(id))<<"Member "<<id<<" moved";
+	}
+	expectOrdered();
+}
+
+TEST_F(TopologicalOrderTest, RandomInsertionsKeepTheOrder){
+	srand(29);
+	int reordered = 0, rejected = 0;
+	for (int i = 1; i <= 3000; i++){
+		int parent = rand() % MEMBERS + 1;
+		int child = rand() % MEMBERS + 1;
+		bool against = positionOf(parent) > positionOf(child);
+		if (!addParent(parent, child)){
+			rejected++;
+		}else if (against){
+			reordered++;
+		}
+		if (i % 250 == 0){
+			expectOrdered();
+		}
+	}
+	// both the reordering path and the cycle check were taken
+	EXPECT_GT(reordered, 0);
+	EXPECT_GT(rejected, 0);
+}
+
+TEST_F(TopologicalOrderTest, RebuildAgreesWithTheGraph){
+	srand(290);
+	for (int i = 0; i < 1000; i++){
+		addParent(rand() % MEMBERS + 1, rand() % MEMBERS + 1);
+	}
+	// the same edges read back from the image
+	testedObject->resetIndexes();
+	expectOrdered();
+	for (int i = 0; i < 500; i++){
+		addParent(rand() % MEMBERS + 1, rand() % MEMBERS + 1);
+	}
+	expectOrdered();
+}
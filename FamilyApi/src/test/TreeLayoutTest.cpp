@@ -0,0 +1,107 @@
+#include "gtest/gtest.h"
+#include "TreeLayout.h"
+#include <cmath>
+#include <cstdlib>
+
+
+class TreeLayoutTest: public testing::Test {
+protected:
+	TreeLayout* testedObject;
+	vector<int> parent;
+	vector<double> width;
+
+	TreeLayoutTest(){
+		testedObject = NULL;
+	}
+
+	virtual void SetUp() {
+		testedObject = new TreeLayout();
+		testedObject->setThreads(1);
+	}
+
+	virtual void TearDown() {
+		delete testedObject;
+	}
+
+	// random tree in breadth first order, up to maxChildren children each
+	void randomTree(int nodes, int maxChildren){
+		parent.assign(1, -1);
+		width.assign(1, 1.0);
+		for (int node = 0; (node < static_cast<int>(parent.size()))&&(static_cast<int>(parent.size()) < nodes); node++){
+			int children = rand() % (maxChildren + 1);
+			if (node + 1 == static_cast<int>(parent.size())){
+				children = max(children, 1);
+			}
+			for (int i = 0; (i < children)&&(static_cast<int>(parent.size()) < nodes); i++){
+				parent.push_back(node);
+				width.push_back(1.0 + rand() % 3);
+			}
+		}
+	}
+
+	// neighbours on one level keep the gap, parents sit over their children
+	void expectTidy(TreeLayout &layout, double gap){
+		int nodes = static_cast<int>(parent.size());
+		for (int node = 1; node < nodes; node++){
+			if (layout.getDepth(node) == layout.getDepth(node - 1)){
+				EXPECT_LE((width[node] + width[node - 1]) / 2.0 + gap - 1e-9, layout.getX(node) - layout.getX(node - 1))<<"Overlap at node "<<node;
+			}
+		}
+		vector<int> first(nodes, -1), last(nodes, -1);
+		for (int node = 1; node < nodes; node++){
+			if (first[parent[node]] == -1){
+				first[parent[node]] = node;
+			}
+			last[parent[node]] = node;
+		}
+		for (int node = 0; node < nodes; node++){
+			if (first[node] != -1){
+				EXPECT_NEAR((layout.getX(first[node]) + layout.getX(last[node])) / 2.0, layout.getX(node), 1e-9)<<"Node "<<node<<" not centred";
+			}
+		}
+	}
+};
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(TreeLayoutTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(TreeLayoutTest, ThreeChildren){
+	int tree[] = {-1, 0, 0, 0};
+	parent.assign(tree, tree + 4);
+	width.assign(4, 1.0);
+	testedObject->layout(parent, width);
+
+	EXPECT_DOUBLE_EQ(0.0, testedObject->getX(1));
+	EXPECT_DOUBLE_EQ(2.0, testedObject->getX(2));
+	EXPECT_DOUBLE_EQ(4.0, testedObject->getX(3));
+	EXPECT_DOUBLE_EQ(2.0, testedObject->getX(0));
+	EXPECT_EQ(1, testedObject->getDepth(3));
+}
+
+TEST_F(TreeLayoutTest, SmallTreesAreTidy){
+	srand(31);
+	for (int round = 0; round < 200; round++){
+		randomTree(2 + rand() % 300, 1 + rand() % 5);
+		testedObject->layout(parent, width);
+		expectTidy(*testedObject, 1.0);
+	}
+}
+
+TEST_F(TreeLayoutTest, ThreadsGiveTheSameLayout){
+	srand(32);
+	randomTree(200000, 4);
+	testedObject->layout(parent, width);
+
+	TreeLayout parallel;
+	parallel.setThreads(4);
+	parallel.layout(parent, width);
+	for (int node = 0; node < static_cast<int>(parent.size()); node++){
+		ASSERT_DOUBLE_EQ(testedObject->getX(node), parallel.getX(node))<<"Node "<<node;
+	}
+	expectTidy(parallel, 1.0);
+}
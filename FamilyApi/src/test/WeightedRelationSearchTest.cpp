@@ -0,0 +1,149 @@
+#include "DexImageTest.h"
+#include "WeightedRelationSearch.h"
+#include "dex/algorithms/SinglePairShortestPathDijkstra.h"
+#include "dex/gdb/Objects.h"
+#include "dex/gdb/ObjectsIterator.h"
+#include "dex/gdb/Value.h"
+#include "Utf8Codec.h"
+#include <cstdlib>
+
+
+class WeightedRelationSearchTest: public DexImageTest {
+protected:
+	static const char * IMAGE;
+	static const int MEMBERS = 150;
+
+	WeightedRelationSearch* testedObject;
+
+	WeightedRelationSearchTest()
+	: DexImageTest(IMAGE){
+		testedObject = NULL;
+	}
+
+	virtual void SetUp() {
+		ASSERT_NO_FATAL_FAILURE(DexImageTest::SetUp());
+		ASSERT_EQ(1, wrapper->addRelation("adoption"));
+		for (int id = 1; id <= MEMBERS; id++){
+			ASSERT_EQ(1, wrapper->addMember(member(id)));
+		}
+		testedObject = new WeightedRelationSearch(*wrapper);
+		ASSERT_EQ(1, testedObject->setCost("parent", dex::gdb::Any, 1));
+		ASSERT_EQ(1, testedObject->setCost("partner", dex::gdb::Any, 2));
+		ASSERT_EQ(1, testedObject->setCost("adoption", dex::gdb::Any, 3));
+	}
+
+	virtual void TearDown() {
+		delete testedObject;
+		DexImageTest::TearDown();
+	}
+
+	dex::gdb::oid_t oid(int id){
+		return wrapper->getSchema().findMember(wrapper->getGraph(), id);
+	}
+
+	// DEX's Dijkstra reads the cost of every edge from an attribute
+	dex::gdb::attr_t costAttribute(const char *relation, double cost){
+		dex::gdb::Graph *graph = wrapper->getGraph();
+		dex::gdb::type_t type = wrapper->getSchema().findRelation(graph, Utf8Codec::decode(relation));
+		dex::gdb::attr_t attr = graph->NewAttribute(type, L"cost", dex::gdb::Double, dex::gdb::Basic);
+		dex::gdb::Value value;
+		value.SetDouble(cost);
+		dex::gdb::Objects *edges = graph->Select(type);
+		dex::gdb::ObjectsIterator *it = edges->Iterator();
+		while (it->HasNext()){
+			graph->SetAttribute(it->Next(), attr, value);
+		}
+		delete it;
+		delete edges;
+		return attr;
+	}
+};
+
+const char * WeightedRelationSearchTest::IMAGE = "weightedRelationSearchTest.dex";
+const int WeightedRelationSearchTest::MEMBERS;
+
+//=========================================================================================================================
+//     TEST CASES START      ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||
+//=========================================================================================================================
+
+TEST_F(WeightedRelationSearchTest, isNotNull){
+	EXPECT_TRUE(testedObject != NULL)<< "Not initiated";
+}
+
+TEST_F(WeightedRelationSearchTest, CheaperLongerPathWins){
+	// 1 - 2 by adoption (3). Once 4 and 2 are partners, 2 - 4 - 3 (2 + 1)
+	// beats 2 - 1 - 3 (3 + 1); without the adoption 1 - 3 - 4 - 2 costs 1 + 1 + 2
+	ASSERT_EQ(1, wrapper->addRelationTo("adoption", member(1), member(2)));
+	ASSERT_EQ(1, wrapper->addRelationTo("parent", member(1), member(3)));
+	ASSERT_EQ(1, wrapper->addRelationTo("parent", member(3), member(4)));
+	int cost = -1;
+	vector<dex::gdb::oid_t> path;
+	ASSERT_EQ(1, testedObject->findPath(member(1), member(2), cost, path));
+	EXPECT_EQ(3, cost);
+	EXPECT_EQ(2u, path.size());
+
+	// the notification reaches the arcs without a rebuild
+	ASSERT_EQ(1, wrapper->addRelationTo("partner", member(4), member(2)));
+	ASSERT_EQ(1, testedObject->findPath(member(2), member(3), cost, path));
+	EXPECT_EQ(3, cost);
+	ASSERT_EQ(3u, path.size());
+	EXPECT_EQ(oid(2), path[0]);
+	EXPECT_EQ(oid(4), path[1]);
+	EXPECT_EQ(oid(3), path[2]);
+
+	ASSERT_EQ(1, wrapper->delRelationTo("adoption", member(1), member(2)));
+	ASSERT_EQ(1, testedObject->findPath(member(1), member(2), cost, path));
+	EXPECT_EQ(4, cost);
+	EXPECT_EQ(0, testedObject->findPath(member(1), member(5), cost, path));
+}
+
+TEST_F(WeightedRelationSearchTest, FindWithinLimit){
+	ASSERT_EQ(1, wrapper->addRelationTo("parent", member(1), member(2)));
+	ASSERT_EQ(1, wrapper->addRelationTo("partner", member(2), member(3)));
+	ASSERT_EQ(1, wrapper->addRelationTo("adoption", member(3), member(4)));
+	vector< pair<dex::gdb::oid_t, int> > reached;
+	ASSERT_EQ(2, testedObject->findWithin(member(1), 3, reached));
+	EXPECT_EQ(oid(2), reached[0].first);
+	EXPECT_EQ(1, reached[0].second);
+	EXPECT_EQ(oid(3), reached[1].first);
+	EXPECT_EQ(3, reached[1].second);
+	EXPECT_EQ(3, testedObject->findWithin(member(1), 6, reached));
+	EXPECT_EQ(-1, testedObject->findWithin(member(MEMBERS + 1), 6, reached));
+}
+
+TEST_F(WeightedRelationSearchTest, SameCostAsDexDijkstra){
+	srand(38);
+	static const char *relations[] = {"parent", "partner", "adoption"};
+	for (int i = 0; i < 300; i++){
+		int first = rand() % MEMBERS + 1;
+		int second = rand() % MEMBERS + 1;
+		if (first < second){
+			wrapper->addRelationTo(relations[rand() % 3], member(first), member(second));
+		}
+	}
+	vector<dex::gdb::type_t> types;
+	vector<dex::gdb::attr_t> attrs;
+	for (int r = 0; r < 3; r++){
+		types.push_back(wrapper->getSchema().findRelation(wrapper->getGraph(), Utf8Codec::decode(relations[r])));
+		attrs.push_back(costAttribute(relations[r], r + 1));
+	}
+	for (int query = 0; query < 200; query++){
+		int from = rand() % MEMBERS + 1;
+		int to = rand() % MEMBERS + 1;
+		dex::algorithms::SinglePairShortestPathDijkstra dijkstra(*wrapper->getSession(), oid(from), oid(to));
+		for (int r = 0; r < 3; r++){
+			dijkstra.AddWeightedEdgeType(types[r], dex::gdb::Any, attrs[r]);
+		}
+		dijkstra.Run();
+
+		int cost = -1;
+		vector<dex::gdb::oid_t> path;
+		int found = testedObject->findPath(member(from), member(to), cost, path);
+		ASSERT_EQ(dijkstra.Exists() ? 1 : 0, found)<<"Query "<<query;
+		if (found == 1){
+			EXPECT_DOUBLE_EQ(dijkstra.GetCost(), cost)<<"Query "<<query;
+			EXPECT_EQ(oid(from), path.front());
+			EXPECT_EQ(oid(to), path.back());
+		}
+	}
+}